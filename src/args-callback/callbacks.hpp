@@ -29,6 +29,7 @@ License
 #include <cmath>
 #include <fstream>
 #include <iomanip>
+#include <limits>
 #include <memory>
 
 #include "../core-computation.hpp"
@@ -272,7 +273,8 @@ namespace hub::callback {
     \*---------------------------------------------------------------------------*/
     /**
      * Default error writer for RunArgs. This class serves as a callable callback object
-     * to output data to a file stream.
+     * to output data to a file stream. The reference energy is the initial energy recorded by the particle system,
+     * or the energy at the first call for systems without cached diagnostics. Copies of one writer share it.
      */
     class EnergyErrWriter {
        public:
@@ -296,6 +298,7 @@ namespace hub::callback {
 
        private:
         std::shared_ptr<std::ofstream> fstream_;
+        std::shared_ptr<double> E0_;
     };
 
     /*---------------------------------------------------------------------------*\
@@ -430,7 +433,8 @@ namespace hub::callback {
     /*---------------------------------------------------------------------------*\
        Class DefaultWriter Definition
     \*---------------------------------------------------------------------------*/
-    DefaultWriter::DefaultWriter(std::string const& file_name) : fstream_{std::make_shared<std::ofstream>(file_name)} {
+    inline DefaultWriter::DefaultWriter(std::string const& file_name)
+        : fstream_{std::make_shared<std::ofstream>(file_name)} {
         if (!fstream_->is_open()) {
             spacehub_abort("Fail to open the file " + file_name);
         } else {
@@ -460,8 +464,9 @@ namespace hub::callback {
     /*---------------------------------------------------------------------------*\
        Class EnergyErrWriter Definition
     \*---------------------------------------------------------------------------*/
-    EnergyErrWriter::EnergyErrWriter(std::string const& file_name)
-        : fstream_{std::make_shared<std::ofstream>(file_name)} {
+    inline EnergyErrWriter::EnergyErrWriter(std::string const& file_name)
+        : fstream_{std::make_shared<std::ofstream>(file_name)},
+          E0_{std::make_shared<double>(std::numeric_limits<double>::quiet_NaN())} {
         if (!fstream_->is_open()) {
             spacehub_abort("Fail to open the file " + file_name);
         } else {
@@ -471,8 +476,15 @@ namespace hub::callback {
 
     template <typename ParticleSys>
     void EnergyErrWriter::operator()(ParticleSys& ptc, typename ParticleSys::Scalar step_size) {
-        static typename ParticleSys::Scalar E0 = calc::calc_total_energy(ptc);
-        *fstream_ << ptc.time() << ',' << calc::calc_energy_error(ptc, E0) << '\n';
+        if constexpr (calc::HAS_METHOD(ParticleSys, diagnostics)) {
+            auto const& diag = ptc.diagnostics();
+            *fstream_ << ptc.time() << ',' << calc::calc_energy_error(ptc, diag.initial_energy()) << '\n';
+        } else {
+            if (std::isnan(*E0_)) {
+                *E0_ = static_cast<double>(calc::calc_total_energy(ptc));
+            }
+            *fstream_ << ptc.time() << ',' << calc::calc_energy_error(ptc, *E0_) << '\n';
+        }
     }
 
     template <typename T>
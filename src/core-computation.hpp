@@ -486,6 +486,10 @@ namespace hub::calc {
 
     CREATE_STATIC_MEMBER_CHECK(regu_type);
 
+    CREATE_METHOD_CHECK(diagnostics);
+
+    CREATE_METHOD_CHECK(step_scale);
+
     template <CONCEPT_PARTICLES_DATA Particle>
     auto calc_potential_energy(Particle const &particle1, Particle const &particle2) -> typename Particle::Scalar {
         typename Particle::Scalar potential_eng = -consts::G * particle1.mass * particle2.mass;
@@ -530,19 +534,27 @@ namespace hub::calc {
 
     template <CONCEPT_PARTICLES_DATA Particles>
     inline auto calc_total_energy(Particles const &particles) -> typename Particles::Scalar {
-        return calc_potential_energy(particles) + calc_kinetic_energy(particles);
+        if constexpr (HAS_METHOD(Particles, diagnostics)) {
+            return particles.diagnostics().total_energy();
+        } else {
+            return calc_potential_energy(particles) + calc_kinetic_energy(particles);
+        }
     }
 
     template <CONCEPT_PARTICLES_DATA Particles>
     inline auto calc_total_angular_momentum(Particles const &particles) -> typename Particles::Vector {
-        size_t size = particles.number();
-        typename Particles::Vector L_tot{0, 0, 0};
+        if constexpr (HAS_METHOD(Particles, diagnostics)) {
+            return particles.diagnostics().angular_momentum();
+        } else {
+            size_t size = particles.number();
+            typename Particles::Vector L_tot{0, 0, 0};
 
-        for (size_t i = 0; i < size; ++i) {
-            L_tot += particles.mass(i) * cross(particles.pos(i), particles.vel(i));
-        }
+            for (size_t i = 0; i < size; ++i) {
+                L_tot += particles.mass(i) * cross(particles.pos(i), particles.vel(i));
+            }
 
-        return L_tot;
+            return L_tot;
+        }
     }
 
     template <CONCEPT_PARTICLES_DATA Particles, typename Idx>
@@ -609,7 +621,7 @@ namespace hub::calc {
      */
     template <CONCEPT_PARTICLES_DATA Particles>
     auto calc_step_scale(Particles const &particles) {
-        if constexpr (HAS_STATIC_MEMBER(Particles, regu_type)) {
+        if constexpr (HAS_STATIC_MEMBER(Particles, regu_type) || HAS_METHOD(Particles, step_scale)) {
             return particles.step_scale();
         } else {
             return 1.0;
@@ -619,8 +631,15 @@ namespace hub::calc {
     template <CONCEPT_PARTICLES_DATA Particles>
     auto calc_energy_error(Particles const &particles, typename Particles::Scalar E0) -> typename Particles::Scalar {
         using Scalar = typename Particles::Scalar;
-        Scalar U = -calc_potential_energy(particles);
-        Scalar T = calc_kinetic_energy(particles);
+        Scalar U, T;
+        if constexpr (HAS_METHOD(Particles, diagnostics)) {
+            auto const &diag = particles.diagnostics();
+            U = -diag.potential_energy();
+            T = diag.kinetic_energy();
+        } else {
+            U = -calc_potential_energy(particles);
+            T = calc_kinetic_energy(particles);
+        }
         if constexpr (HAS_METHOD(Particles, bindE) && HAS_STATIC_MEMBER(Particles, regu_type)) {
             return LOG(fabs((T + particles.bindE()) / U));
         } else {
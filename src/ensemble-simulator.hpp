@@ -0,0 +1,229 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file ensemble-simulator.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "core-computation.hpp"
+#include "dev-tools.hpp"
+#include "particles/point-particles.hpp"
+
+namespace hub {
+
+    /**
+     * @brief One independent system integrated by the EnsembleSimulator.
+     *
+     * @tparam Particle Particle type with mass, pos and vel members.
+     */
+    template <typename Particle>
+    struct EnsembleJob {
+        using Scalar = typename Particle::Scalar;
+
+        /** @brief Free tag of the caller, e.g. the index of the initial condition.*/
+        size_t id{0};
+
+        /** @brief Initial time, the final time after the job is finished.*/
+        Scalar time{0};
+
+        /** @brief The time to integrate to.*/
+        Scalar end_time{0};
+
+        /** @brief Initial particles, the final ones after the job is finished.*/
+        std::vector<Particle> particles;
+    };
+
+    /*---------------------------------------------------------------------------*\
+        Class EnsembleSimulator Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Integrate a stream of small independent systems in the SIMD lanes of a system::EnsembleSystem.
+     *
+     * Every lane takes a job from the source, integrates it to its end time in lockstep with the other lanes and hands
+     * it to the sink, then immediately takes the next job, so the lanes stay busy until the source runs dry. Run one
+     * EnsembleSimulator per thread on a shared source to combine SIMD and thread parallelism.
+     *
+     * @code{.cpp}
+     *  EnsembleSimulator<system::EnsembleSystem<Types<double>, 3, 4>, ode::EnsembleBulirschStoer<...>> sim;
+     *  sim.run([&](auto &job) { ...; return has_more; }, [&](auto &job) { ... });
+     * @endcode
+     *
+     * @tparam Ensemble Type of the ensemble system.
+     * @tparam Iterator Ensemble iterator, ode::EnsembleBulirschStoer or ode::EnsembleConstIterator.
+     * @tparam Job Job type with the interfaces of EnsembleJob.
+     */
+    template <typename Ensemble, typename Iterator,
+              typename Job = EnsembleJob<particles::PointParticle<Vec3<typename Ensemble::Real>>>>
+    class EnsembleSimulator {
+       public:
+        using Real = typename Ensemble::Real;
+
+        using Scalar = typename Ensemble::Scalar;
+
+        static constexpr size_t lanes{Ensemble::lanes};
+
+        /**
+         * @brief Integrate jobs until the source is exhausted.
+         *
+         * @tparam Source Callable as `bool(Job &)`. Fills the next job, returns false if there is none left.
+         * @tparam Sink Callable as `void(Job &)`. Receives every finished job. Jobs with end_time <= time are handed
+         * over as they are, without being integrated.
+         * @param[in] next_job The work queue.
+         * @param[in] finished The receiver of the results.
+         */
+        template <typename Source, typename Sink>
+        void run(Source &&next_job, Sink &&finished);
+
+        void set_atol(Real atol);
+
+        void set_rtol(Real rtol);
+
+        /**
+         * @brief The initial step of every job, in units of the minimal free fall time of its particles.
+         */
+        void set_initial_step(Real fraction) { step_fraction_ = fraction; };
+
+        /**
+         * @brief Number of lockstep iterations.
+         */
+        SPACEHUB_READ_ACCESSOR(size_t, iteration_count, iteration_count_);
+
+        /**
+         * @brief Number of lane steps that advanced a job. The lane utilization is lane_step_count / (lanes *
+         * iteration_count).
+         */
+        SPACEHUB_READ_ACCESSOR(size_t, lane_step_count, lane_step_count_);
+
+       private:
+        template <typename Source, typename Sink>
+        bool refill(size_t lane, Source &next_job, Sink &finished);
+
+        Real initial_step(decltype(Job::particles) const &particles) const;
+
+        Ensemble ensemble_;
+
+        Iterator iterator_;
+
+        std::array<Job, lanes> jobs_;
+
+        std::array<bool, lanes> busy_{};
+
+        Scalar step_;
+
+        Real step_fraction_{0.1};
+
+        size_t iteration_count_{0};
+
+        size_t lane_step_count_{0};
+
+        CREATE_METHOD_CHECK(set_atol);
+
+        CREATE_METHOD_CHECK(set_rtol);
+    };
+
+    /*---------------------------------------------------------------------------*\
+        Class EnsembleSimulator Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename Ensemble, typename Iterator, typename Job>
+    void EnsembleSimulator<Ensemble, Iterator, Job>::set_atol(Real atol) {
+        if constexpr (HAS_METHOD(Iterator, set_atol, Real)) {
+            iterator_.set_atol(atol);
+        }
+    }
+
+    template <typename Ensemble, typename Iterator, typename Job>
+    void EnsembleSimulator<Ensemble, Iterator, Job>::set_rtol(Real rtol) {
+        if constexpr (HAS_METHOD(Iterator, set_rtol, Real)) {
+            iterator_.set_rtol(rtol);
+        }
+    }
+
+    template <typename Ensemble, typename Iterator, typename Job>
+    auto EnsembleSimulator<Ensemble, Iterator, Job>::initial_step(decltype(Job::particles) const &particles) const
+        -> Real {
+        Real min_fall_free = math::max_value<Real>::value;
+        for (size_t i = 0; i < particles.size(); ++i) {
+            for (size_t j = i + 1; j < particles.size(); ++j) {
+                Real r = distance(particles[i].pos, particles[j].pos);
+                min_fall_free = math::min(min_fall_free, POW(r, 1.5) / sqrt(particles[i].mass + particles[j].mass));
+            }
+        }
+        return step_fraction_ * min_fall_free * consts::pi * 0.5 / sqrt(2 * consts::G);
+    }
+
+    template <typename Ensemble, typename Iterator, typename Job>
+    template <typename Source, typename Sink>
+    bool EnsembleSimulator<Ensemble, Iterator, Job>::refill(size_t lane, Source &next_job, Sink &finished) {
+        // jobs that are already at their end time would never take an accepted step, pass them through untouched
+        while ((busy_[lane] = next_job(jobs_[lane])) && jobs_[lane].end_time <= jobs_[lane].time) {
+            finished(jobs_[lane]);
+        }
+        if (busy_[lane]) {
+            ensemble_.load(lane, jobs_[lane].time, jobs_[lane].particles);
+            step_[lane] = initial_step(jobs_[lane].particles);
+        } else {
+            ensemble_.clear(lane);
+            step_[lane] = 0;
+        }
+        return busy_[lane];
+    }
+
+    template <typename Ensemble, typename Iterator, typename Job>
+    template <typename Source, typename Sink>
+    void EnsembleSimulator<Ensemble, Iterator, Job>::run(Source &&next_job, Sink &&finished) {
+        size_t active = 0;
+        for (size_t l = 0; l < lanes; ++l) {
+            active += refill(l, next_job, finished);
+        }
+
+        Scalar h;
+        std::array<bool, lanes> last_step;
+        while (active > 0) {
+            for (size_t l = 0; l < lanes; ++l) {
+                Real rest = jobs_[l].end_time - ensemble_.time(l);
+                last_step[l] = busy_[l] && step_[l] >= rest;
+                h[l] = busy_[l] ? math::min(step_[l], rest) : 0;
+            }
+            Scalar const t0 = ensemble_.time();
+            Scalar next = iterator_.iterate(ensemble_, h);
+            iteration_count_++;
+
+            for (size_t l = 0; l < lanes; ++l) {
+                if (!busy_[l]) continue;
+
+                bool accepted = ensemble_.time(l) != t0[l];
+                lane_step_count_ += accepted;
+                if (accepted && (last_step[l] || ensemble_.time(l) >= jobs_[l].end_time)) {
+                    jobs_[l].time = jobs_[l].end_time;
+                    ensemble_.store(l, jobs_[l].particles);
+                    finished(jobs_[l]);
+                    active -= !refill(l, next_job, finished);
+                } else {
+                    step_[l] = next[l];
+                }
+            }
+        }
+    }
+}  // namespace hub
@@ -263,6 +263,11 @@ namespace hub::integrator {
 
         void check_particle_size(size_t var_num);
 
+        /**
+         * @brief Clear the predicted coefficients, keeping the allocated arrays.
+         */
+        void reset();
+
         template <typename ParticleSys>
         void integrate(ParticleSys &particles, Scalar step_size);
 
@@ -344,6 +349,14 @@ namespace hub::integrator {
         }
     }
 
+    template <typename TypeSystem>
+    void GaussRadau<TypeSystem>::reset() {
+        calc::set_arrays_zero(dydh0_, dydh_, dg_array_, tmp_array_, tmp_state_);
+        for (size_t i = 0; i < final_point; ++i) {
+            calc::set_arrays_zero(b_[i], old_b_[i], g_[i]);
+        }
+    }
+
     template <typename TypeSystem>
     template <typename ParticleSys>
     void GaussRadau<TypeSystem>::integrate(ParticleSys &particles, Scalar step_size) {
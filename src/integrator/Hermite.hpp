@@ -0,0 +1,311 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file Hermite.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "../core-computation.hpp"
+#include "../dev-tools.hpp"
+
+namespace hub::integrator {
+
+    /*---------------------------------------------------------------------------*\
+         Class Hermite Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Hermite predictor-corrector integrators with individual particle times.
+     *
+     * Every particle keeps its position, velocity and force derivatives at its own time. predict() extrapolates all
+     * particles to a common time with the Taylor series, correct() evaluates the forces of the active particles there
+     * and applies the Hermite corrector to them. One force evaluation per step, however high the order:
+     *
+     * - Order 2: kick-drift-kick leapfrog written as predictor-corrector, acceleration only.
+     * - Order 4: acceleration and jerk (Makino & Aarseth 1992).
+     * - Order 6: acceleration, jerk and snap (Nitadori & Makino 2008).
+     *
+     * After every correction the magnitudes of the derivatives of the interpolating polynomial at the new time are
+     * kept for the step criterion (see ode::AarsethController). Order 2 gets its jerk from the last two accelerations.
+     * Extra forces enter the acceleration only, their higher derivatives are neglected.
+     *
+     * @tparam TypeSystem Type class of SpaceHub.
+     * @tparam Order Order of the scheme, 2, 4 or 6.
+     */
+    template <typename TypeSystem, size_t Order>
+    class Hermite {
+       public:
+        // Type members
+        SPACEHUB_USING_TYPE_SYSTEM_OF(TypeSystem);
+
+        static_assert(Order == 2 || Order == 4 || Order == 6, "Hermite integrators are of order 2, 4 or 6!");
+
+        /**
+         * @brief Magnitudes of the time derivatives of the acceleration, from the acceleration itself up to order-1.
+         */
+        using Derivatives = std::array<Scalar, Order>;
+
+        // static public members
+        static constexpr size_t order{Order};
+
+        // Public methods
+        /**
+         * @brief Advance all particles by one shared step.
+         *
+         * @param[in,out] particles Particle system.
+         * @param[in] step_size Step size.
+         */
+        template <CONCEPT_PARTICLE_SYSTEM ParticleSys>
+        void integrate(ParticleSys &particles, Scalar step_size);
+
+        /**
+         * @brief Whether the particle system is still in the state left by the last synchronized correction.
+         */
+        template <CONCEPT_PARTICLE_SYSTEM ParticleSys>
+        bool is_synchronized(ParticleSys const &particles) const;
+
+        /**
+         * @brief Take the current state of the particle system and evaluate its force derivatives.
+         */
+        template <CONCEPT_PARTICLE_SYSTEM ParticleSys>
+        void start(ParticleSys &particles);
+
+        /**
+         * @brief Extrapolate all particles to the given time.
+         */
+        template <CONCEPT_PARTICLE_SYSTEM ParticleSys>
+        void predict(ParticleSys &particles, Scalar time);
+
+        /**
+         * @brief Evaluate the forces of the active particles at the predicted state and correct them.
+         */
+        template <CONCEPT_PARTICLE_SYSTEM ParticleSys>
+        void correct(ParticleSys &particles, IdxArray const &active);
+
+        /**
+         * @brief Derivatives of each particle at its last correction.
+         */
+        SPACEHUB_READ_ACCESSOR(std::vector<Derivatives>, derivatives, derivs_);
+
+       private:
+        // Private members
+        VectorArray pos_;
+
+        VectorArray vel_;
+
+        VectorArray acc_;
+
+        VectorArray jerk_;
+
+        VectorArray snap_;
+
+        VectorArray crackle_;
+
+        VectorArray new_acc_;
+
+        VectorArray new_jerk_;
+
+        VectorArray new_snap_;
+
+        VectorArray pred_acc_;
+
+        ScalarArray time_;
+
+        IdxArray all_;
+
+        std::vector<Derivatives> derivs_;
+
+        Scalar sync_time_{0};
+    };
+
+    template <typename TypeSystem>
+    using Hermite2 = Hermite<TypeSystem, 2>;
+
+    template <typename TypeSystem>
+    using Hermite4 = Hermite<TypeSystem, 4>;
+
+    template <typename TypeSystem>
+    using Hermite6 = Hermite<TypeSystem, 6>;
+
+    /*---------------------------------------------------------------------------*\
+         Class Hermite Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename TypeSystem, size_t Order>
+    template <CONCEPT_PARTICLE_SYSTEM ParticleSys>
+    void Hermite<TypeSystem, Order>::integrate(ParticleSys &particles, Scalar step_size) {
+        if (!is_synchronized(particles)) {
+            start(particles);
+        }
+        predict(particles, particles.time() + step_size);
+        correct(particles, all_);
+    }
+
+    template <typename TypeSystem, size_t Order>
+    template <CONCEPT_PARTICLE_SYSTEM ParticleSys>
+    bool Hermite<TypeSystem, Order>::is_synchronized(ParticleSys const &particles) const {
+        size_t num = particles.number();
+        if (num != pos_.size() || particles.time() != sync_time_) {
+            return false;
+        }
+        auto same = [](Vector const &a, Vector const &b) { return a.x == b.x && a.y == b.y && a.z == b.z; };
+        for (size_t i = 0; i < num; ++i) {
+            if (time_[i] != sync_time_ || !same(particles.pos(i), pos_[i]) || !same(particles.vel(i), vel_[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename TypeSystem, size_t Order>
+    template <CONCEPT_PARTICLE_SYSTEM ParticleSys>
+    void Hermite<TypeSystem, Order>::start(ParticleSys &particles) {
+        size_t num = particles.number();
+        pos_ = particles.pos();
+        vel_ = particles.vel();
+        for (auto *array : {&acc_, &jerk_, &snap_, &crackle_, &new_acc_, &new_jerk_, &new_snap_, &pred_acc_}) {
+            array->resize(num);
+            calc::array_set_zero(*array);
+        }
+        time_.resize(num);
+        std::fill(time_.begin(), time_.end(), particles.time());
+        all_.resize(num);
+        for (size_t i = 0; i < num; ++i) {
+            all_[i] = i;
+        }
+        derivs_.resize(num);
+        sync_time_ = particles.time();
+
+        particles.evaluate_acc_and_jerk(all_, acc_, jerk_);
+        if constexpr (Order == 6) {
+            pred_acc_ = acc_;
+            particles.evaluate_acc_jerk_and_snap(pred_acc_, all_, acc_, jerk_, snap_);
+        }
+        for (size_t i = 0; i < num; ++i) {
+            derivs_[i].fill(0);
+            derivs_[i][0] = norm(acc_[i]);
+            derivs_[i][1] = norm(jerk_[i]);
+        }
+    }
+
+    template <typename TypeSystem, size_t Order>
+    template <CONCEPT_PARTICLE_SYSTEM ParticleSys>
+    void Hermite<TypeSystem, Order>::predict(ParticleSys &particles, Scalar time) {
+        size_t num = particles.number();
+        auto &p = particles.pos();
+        auto &v = particles.vel();
+        for (size_t i = 0; i < num; ++i) {
+            Scalar dt = time - time_[i];
+            if constexpr (Order == 2) {
+                p[i] = pos_[i] + dt * (vel_[i] + (0.5 * dt) * acc_[i]);
+                v[i] = vel_[i] + dt * acc_[i];
+            } else if constexpr (Order == 4) {
+                p[i] = pos_[i] + dt * (vel_[i] + (0.5 * dt) * (acc_[i] + (dt / 3) * jerk_[i]));
+                v[i] = vel_[i] + dt * (acc_[i] + (0.5 * dt) * jerk_[i]);
+            } else {
+                p[i] = pos_[i] +
+                       dt * (vel_[i] +
+                             (0.5 * dt) * (acc_[i] + (dt / 3) * (jerk_[i] + (0.25 * dt) * (snap_[i] +
+                                                                                         (0.2 * dt) * crackle_[i]))));
+                v[i] = vel_[i] + dt * (acc_[i] + (0.5 * dt) * (jerk_[i] + (dt / 3) * (snap_[i] + (0.25 * dt) *
+                                                                                                   crackle_[i])));
+                pred_acc_[i] = acc_[i] + dt * (jerk_[i] + (0.5 * dt) * (snap_[i] + (dt / 3) * crackle_[i]));
+            }
+        }
+        particles.time() = time;
+        particles.invalidate_diagnostics();
+    }
+
+    template <typename TypeSystem, size_t Order>
+    template <CONCEPT_PARTICLE_SYSTEM ParticleSys>
+    void Hermite<TypeSystem, Order>::correct(ParticleSys &particles, IdxArray const &active) {
+        Scalar time = particles.time();
+        if constexpr (Order == 2) {
+            particles.evaluate_acc(active, new_acc_);
+        } else if constexpr (Order == 4) {
+            particles.evaluate_acc_and_jerk(active, new_acc_, new_jerk_);
+        } else {
+            particles.evaluate_acc_jerk_and_snap(pred_acc_, active, new_acc_, new_jerk_, new_snap_);
+        }
+
+        for (size_t i : active) {
+            Scalar dt = time - time_[i];
+            Vector const &a0 = acc_[i];
+            Vector const &a1 = new_acc_[i];
+            Vector v1;
+            Vector x1;
+            auto &d = derivs_[i];
+            if constexpr (Order == 2) {
+                v1 = vel_[i] + (0.5 * dt) * (a0 + a1);
+                x1 = pos_[i] + dt * (vel_[i] + (0.5 * dt) * a0);
+                jerk_[i] = (a1 - a0) / dt;
+                d = {norm(a1), norm(jerk_[i])};
+            } else if constexpr (Order == 4) {
+                Vector const &j0 = jerk_[i];
+                Vector const &j1 = new_jerk_[i];
+                v1 = vel_[i] + (0.5 * dt) * (a0 + a1) + (dt * dt / 12) * (j0 - j1);
+                x1 = pos_[i] + (0.5 * dt) * (vel_[i] + v1) + (dt * dt / 12) * (a0 - a1);
+
+                // cubic through (a, j) at both ends, expanded about the mid point
+                Scalar h = 0.5 * dt;
+                Vector snap = (j1 - j0) / dt;
+                Vector crackle = (3 / (h * h * h)) * (0.5 * h * (j1 + j0) - 0.5 * (a1 - a0));
+                d = {norm(a1), norm(j1), norm(snap + h * crackle), norm(crackle)};
+                jerk_[i] = j1;
+            } else {
+                Vector const &j0 = jerk_[i];
+                Vector const &j1 = new_jerk_[i];
+                Vector const &s0 = snap_[i];
+                Vector const &s1 = new_snap_[i];
+                Scalar dt2 = dt * dt;
+                v1 = vel_[i] + (0.5 * dt) * (a0 + a1) - (dt2 / 10) * (j1 - j0) + (dt2 * dt / 120) * (s1 + s0);
+                x1 = pos_[i] + (0.5 * dt) * (vel_[i] + v1) - (dt2 / 10) * (a1 - a0) + (dt2 * dt / 120) * (j1 + j0);
+
+                // quintic through (a, j, s) at both ends, expanded about the mid point
+                Scalar h = 0.5 * dt;
+                Scalar h2 = h * h;
+                Vector A1 = 0.5 * (a1 - a0);
+                Vector J0 = 0.5 * (j1 + j0);
+                Vector J1 = 0.5 * (j1 - j0);
+                Vector S0 = 0.5 * (s1 + s0);
+                Vector S1 = 0.5 * (s1 - s0);
+                Vector c4 = (3 / (h2 * h)) * (h * S0 - J1);
+                Vector c5 = (15 / (h2 * h2 * h)) * (h2 * S1 - 3 * h * J0 + 3 * A1);
+                Vector c3 = (S1 - (h2 * h / 6) * c5) / h;
+                crackle_[i] = c3 + h * c4 + (0.5 * h2) * c5;
+                d = {norm(a1), norm(j1), norm(s1), norm(crackle_[i]), norm(c4 + h * c5), norm(c5)};
+                jerk_[i] = j1;
+                snap_[i] = s1;
+            }
+            acc_[i] = a1;
+            pos_[i] = particles.pos(i) = x1;
+            vel_[i] = particles.vel(i) = v1;
+            time_[i] = time;
+        }
+
+        particles.invalidate_diagnostics();
+        if (active.size() == particles.number()) {
+            sync_time_ = time;
+        }
+    }
+}  // namespace hub::integrator
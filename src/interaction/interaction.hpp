@@ -28,6 +28,24 @@ License
 #include "../spacehub-concepts.hpp"
 namespace hub::force {
 
+    namespace detail {
+        CREATE_STATIC_MEMBER_CHECK(scale_free);
+
+        /**
+         * @brief Is the force flagged as scale free? Forces without the 'scale_free' flag are taken as not.
+         *
+         * @tparam Force Type of the force.
+         */
+        template <typename Force>
+        constexpr bool is_scale_free() {
+            if constexpr (HAS_STATIC_MEMBER(Force, scale_free)) {
+                return Force::scale_free;
+            } else {
+                return false;
+            }
+        }
+    }  // namespace detail
+
     /*---------------------------------------------------------------------------*\
         Class Interactions Declaration
     \*---------------------------------------------------------------------------*/
@@ -52,6 +70,13 @@ namespace hub::force {
          */
         static constexpr bool ext_vel_indep{(... || !ExtraForce::vel_dependent)};
 
+        /**
+         * @brief Are the outcomes invariant under the rescaling of mass, length and time, i.e. pure Newtonian gravity?
+         *
+         */
+        static constexpr bool scale_free{detail::is_scale_free<InternalForce>() &&
+                                         (... && detail::is_scale_free<ExtraForce>())};
+
         /**
          * Evaluate the total acceleration of the current state of a given particle system.
          *
@@ -63,6 +88,59 @@ namespace hub::force {
         template <CONCEPT_PARTICLES_DATA Particles>
         static void eval_acc(Particles const &particles, typename Particles::VectorArray &acceleration);
 
+        /**
+         * Evaluate the total acceleration of the active particles of a given particle system. Entries of the inactive
+         * particles are left untouched. Forces without a partial evaluation path are evaluated in full.
+         *
+         * @tparam Particles Type of the particle system.
+         * @tparam IdxArray Type of the index array.
+         *
+         * @param[in] particles The particle system need to be evaluated.
+         * @param[in] active Indices of the active particles.
+         * @param[out] acceleration The output of the evaluated acceleration.
+         */
+        template <CONCEPT_PARTICLES_DATA Particles, typename IdxArray>
+        static void eval_acc(Particles const &particles, IdxArray const &active,
+                             typename Particles::VectorArray &acceleration);
+
+        /**
+         * Evaluate the total acceleration and the jerk of the internal force of the active particles of a given
+         * particle system. Extra forces contribute to the acceleration only, their jerk is neglected.
+         *
+         * @tparam Particles Type of the particle system.
+         * @tparam IdxArray Type of the index array.
+         *
+         * @param[in] particles The particle system need to be evaluated.
+         * @param[in] active Indices of the active particles.
+         * @param[out] acceleration The output of the evaluated acceleration.
+         * @param[out] jerk The output of the evaluated jerk.
+         */
+        template <CONCEPT_PARTICLES_DATA Particles, typename IdxArray>
+        static void eval_acc_and_jerk(Particles const &particles, IdxArray const &active,
+                                      typename Particles::VectorArray &acceleration,
+                                      typename Particles::VectorArray &jerk);
+
+        /**
+         * Evaluate the total acceleration, and the jerk and snap of the internal force of the active particles of a
+         * given particle system. Extra forces contribute to the acceleration only.
+         *
+         * @tparam Particles Type of the particle system.
+         * @tparam IdxArray Type of the index array.
+         *
+         * @param[in] particles The particle system need to be evaluated.
+         * @param[in] pred_acc Accelerations of all particles at the current state.
+         * @param[in] active Indices of the active particles.
+         * @param[out] acceleration The output of the evaluated acceleration.
+         * @param[out] jerk The output of the evaluated jerk.
+         * @param[out] snap The output of the evaluated snap.
+         */
+        template <CONCEPT_PARTICLES_DATA Particles, typename IdxArray>
+        static void eval_acc_jerk_and_snap(Particles const &particles,
+                                           typename Particles::VectorArray const &pred_acc, IdxArray const &active,
+                                           typename Particles::VectorArray &acceleration,
+                                           typename Particles::VectorArray &jerk,
+                                           typename Particles::VectorArray &snap);
+
         /**
          * Evaluate the external acceleration of the current state of a given particle system.
          *
@@ -106,6 +184,29 @@ namespace hub::force {
          */
         template <CONCEPT_PARTICLES_DATA Particles>
         static void eval_newtonian_acc(Particles const &particles, typename Particles::VectorArray &acceleration);
+
+        /**
+         * Evaluate the internal newtonian acceleration and the potential energy of the current state of a given
+         * particle system. Both come out of one pair traversal if the internal force supports it.
+         *
+         * @tparam Particles Type of the particle system.
+         *
+         * @param[in] particles The particle system need to be evaluated.
+         * @param[out] acceleration The output of the evaluated acceleration.
+         * @param[out] potential The output of the evaluated potential energy.
+         */
+        template <CONCEPT_PARTICLES_DATA Particles>
+        static void eval_newtonian_acc(Particles const &particles, typename Particles::VectorArray &acceleration,
+                                       typename Particles::Scalar &potential);
+
+       private:
+        template <CONCEPT_FORCE Force, CONCEPT_PARTICLES_DATA Particles, typename IdxArray>
+        static void add_active_acc_to(Particles const &particles, IdxArray const &active,
+                                      typename Particles::VectorArray &acceleration);
+
+        CREATE_METHOD_CHECK(add_acc_and_potential_to);
+
+        CREATE_METHOD_CHECK(add_acc_to);
     };
 
     /**
@@ -118,6 +219,8 @@ namespace hub::force {
     template <typename Interactions, typename VectorArray>
     class InteractionData {
        public:
+        using Scalar = typename VectorArray::value_type::value_type;
+
         // Constructors
         SPACEHUB_MAKE_CONSTRUCTORS(InteractionData, default, default, default, default, default);
 
@@ -129,6 +232,13 @@ namespace hub::force {
         explicit InteractionData(size_t size);
 
         // Public methods
+        /**
+         * @brief Resize to the given number of particles and zero all accelerations, reusing the allocated memory.
+         *
+         * @param[in] size Number of Particles.
+         */
+        void resize(size_t size);
+
         /**
          * @brief 3D vector array to store the total acceleration.
          *
@@ -161,6 +271,12 @@ namespace hub::force {
          */
         SPACEHUB_ARRAY_ACCESSOR(VectorArray, ext_vel_dep_acc, ext_vel_dep_acc_);
 
+        /**
+         * @brief Newtonian potential energy evaluated together with the Newtonian acceleration.
+         *
+         */
+        SPACEHUB_STD_ACCESSOR(Scalar, newtonian_potential, newtonian_potential_);
+
        private:
         VectorArray acc_{0};
 
@@ -171,6 +287,8 @@ namespace hub::force {
         std::conditional_t<Interactions::ext_vel_indep, VectorArray, Empty> ext_vel_indep_acc_;
 
         std::conditional_t<Interactions::ext_vel_dep, VectorArray, Empty> ext_vel_dep_acc_;
+
+        Scalar newtonian_potential_{0};
     };
     template <typename Arg, typename... Args>
     struct InvokeVelDepForce {
@@ -210,6 +328,72 @@ namespace hub::force {
         (ExtraForce::add_acc_to(particles, acceleration), ...);
     }
 
+    template <CONCEPT_FORCE InternalForce, CONCEPT_FORCE... ExtraForce>
+    template <CONCEPT_PARTICLES_DATA Particles, typename IdxArray>
+    void Interactions<InternalForce, ExtraForce...>::eval_acc(const Particles &particles, const IdxArray &active,
+                                                              typename Particles::VectorArray &acceleration) {
+        if (active.size() == particles.number()) {
+            eval_acc(particles, acceleration);
+            return;
+        }
+        for (size_t i : active) {
+            acceleration[i] = typename Particles::Vector{0};
+        }
+        add_active_acc_to<InternalForce>(particles, active, acceleration);
+        (add_active_acc_to<ExtraForce>(particles, active, acceleration), ...);
+    }
+
+    template <CONCEPT_FORCE InternalForce, CONCEPT_FORCE... ExtraForce>
+    template <CONCEPT_PARTICLES_DATA Particles, typename IdxArray>
+    void Interactions<InternalForce, ExtraForce...>::eval_acc_and_jerk(const Particles &particles,
+                                                                       const IdxArray &active,
+                                                                       typename Particles::VectorArray &acceleration,
+                                                                       typename Particles::VectorArray &jerk) {
+        if (active.size() == particles.number()) {
+            calc::array_set_zero(acceleration);
+            calc::array_set_zero(jerk);
+            InternalForce::add_acc_and_jerk_to(particles, acceleration, jerk);
+            (ExtraForce::add_acc_to(particles, acceleration), ...);
+        } else {
+            for (size_t i : active) {
+                acceleration[i] = jerk[i] = typename Particles::Vector{0};
+            }
+            InternalForce::add_acc_and_jerk_to(particles, active, acceleration, jerk);
+            (add_active_acc_to<ExtraForce>(particles, active, acceleration), ...);
+        }
+    }
+
+    template <CONCEPT_FORCE InternalForce, CONCEPT_FORCE... ExtraForce>
+    template <CONCEPT_PARTICLES_DATA Particles, typename IdxArray>
+    void Interactions<InternalForce, ExtraForce...>::eval_acc_jerk_and_snap(
+        const Particles &particles, typename Particles::VectorArray const &pred_acc, const IdxArray &active,
+        typename Particles::VectorArray &acceleration, typename Particles::VectorArray &jerk,
+        typename Particles::VectorArray &snap) {
+        for (size_t i : active) {
+            acceleration[i] = jerk[i] = snap[i] = typename Particles::Vector{0};
+        }
+        InternalForce::add_acc_jerk_and_snap_to(particles, pred_acc, active, acceleration, jerk, snap);
+        (add_active_acc_to<ExtraForce>(particles, active, acceleration), ...);
+    }
+
+    template <CONCEPT_FORCE InternalForce, CONCEPT_FORCE... ExtraForce>
+    template <CONCEPT_FORCE Force, CONCEPT_PARTICLES_DATA Particles, typename IdxArray>
+    void Interactions<InternalForce, ExtraForce...>::add_active_acc_to(const Particles &particles,
+                                                                       const IdxArray &active,
+                                                                       typename Particles::VectorArray &acceleration) {
+        if constexpr (HAS_METHOD(Force, add_acc_to, Particles const &, IdxArray const &,
+                                 typename Particles::VectorArray &)) {
+            Force::add_acc_to(particles, active, acceleration);
+        } else {
+            typename Particles::VectorArray full(particles.number());
+            calc::array_set_zero(full);
+            Force::add_acc_to(particles, full);
+            for (size_t i : active) {
+                acceleration[i] += full[i];
+            }
+        }
+    }
+
     template <CONCEPT_FORCE InternalForce, CONCEPT_FORCE... ExtraForce>
     template <CONCEPT_PARTICLES_DATA Particles>
     void Interactions<InternalForce, ExtraForce...>::eval_extra_acc(const Particles &particles,
@@ -253,6 +437,21 @@ namespace hub::force {
         InternalForce::add_acc_to(particles, acceleration);
     }
 
+    template <CONCEPT_FORCE InternalForce, CONCEPT_FORCE... ExtraForce>
+    template <CONCEPT_PARTICLES_DATA Particles>
+    void Interactions<InternalForce, ExtraForce...>::eval_newtonian_acc(const Particles &particles,
+                                                                        typename Particles::VectorArray &acceleration,
+                                                                        typename Particles::Scalar &potential) {
+        calc::array_set_zero(acceleration);
+        if constexpr (HAS_METHOD(InternalForce, add_acc_and_potential_to, Particles const &,
+                                 typename Particles::VectorArray &)) {
+            potential = InternalForce::add_acc_and_potential_to(particles, acceleration);
+        } else {
+            InternalForce::add_acc_to(particles, acceleration);
+            potential = calc::calc_potential_energy(particles);
+        }
+    }
+
     /*---------------------------------------------------------------------------*\
             Class InteractionData Implementation
     \*---------------------------------------------------------------------------*/
@@ -266,4 +465,22 @@ namespace hub::force {
             ext_vel_dep_acc_.resize(size);
         }
     }
+
+    template <typename Interactions, typename VectorArray>
+    void InteractionData<Interactions, VectorArray>::resize(size_t size) {
+        auto reset = [size](VectorArray &array) {
+            array.resize(size);
+            std::fill(array.begin(), array.end(), typename VectorArray::value_type{});
+        };
+        reset(acc_);
+        reset(newtonian_acc_);
+        reset(tot_vel_indep_acc_);
+        if constexpr (Interactions::ext_vel_indep) {
+            reset(ext_vel_indep_acc_);
+        }
+        if constexpr (Interactions::ext_vel_dep) {
+            reset(ext_vel_dep_acc_);
+        }
+        newtonian_potential_ = 0;
+    }
 }  // namespace hub::force
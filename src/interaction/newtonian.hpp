@@ -46,6 +46,12 @@ namespace hub::force {
          */
         constexpr static bool vel_dependent{false};
 
+        /**
+         * @brief Is this force invariant under the rescaling of mass, length and time in N-body units?
+         *
+         */
+        constexpr static bool scale_free{true};
+
         // Type members
         /**
          * @brief Add newtonian acceleration to existing 3D vector array.
@@ -59,7 +65,94 @@ namespace hub::force {
         template <typename Particles>
         static void add_acc_to(Particles const &particles, typename Particles::VectorArray &acceleration);
 
+        /**
+         * @brief Add newtonian acceleration to existing 3D vector array and return the potential energy evaluated in
+         * the same pair traversal.
+         *
+         * @note The potential is the by-product the regularized systems need for their time transformation, and its
+         * gradient is m_i times the Newtonian acceleration, so neither needs another pair loop.
+         *
+         * @tparam Particles Particle system type satisfy concept particle system.
+         * @param[in] particles Particle system that is used to evaluated the acceleration.
+         * @param[in,out] acceleration 3D vector array to be updated.
+         * @return The potential energy of the system.
+         */
+        template <typename Particles>
+        static auto add_acc_and_potential_to(Particles const &particles, typename Particles::VectorArray &acceleration)
+            -> typename Particles::Scalar;
+
+        /**
+         * @brief Add newtonian acceleration of the active particles to existing 3D vector array.
+         *
+         * @note Only the entries of the active particles are updated, each with the attraction of all particles in
+         * Cartesian coordinates. The cost is (active x all) instead of (all x all) / 2, which is what block time steps
+         * need.
+         *
+         * @tparam Particles Particle system type satisfy concept particle system.
+         * @tparam IdxArray Index array type.
+         * @param[in] particles Particle system that is used to evaluated the acceleration.
+         * @param[in] active Indices of the active particles.
+         * @param[in,out] acceleration 3D vector array to be updated.
+         */
+        template <typename Particles, typename IdxArray>
+        static void add_acc_to(Particles const &particles, IdxArray const &active,
+                               typename Particles::VectorArray &acceleration);
+
+        /**
+         * @brief Add newtonian acceleration and its time derivative (jerk) to existing 3D vector arrays in one pair
+         * traversal.
+         *
+         * @tparam Particles Particle system type satisfy concept particle system.
+         * @param[in] particles Particle system that is used to evaluated the acceleration.
+         * @param[in,out] acceleration 3D vector array to be updated.
+         * @param[in,out] jerk 3D vector array to be updated.
+         */
+        template <typename Particles>
+        static void add_acc_and_jerk_to(Particles const &particles, typename Particles::VectorArray &acceleration,
+                                        typename Particles::VectorArray &jerk);
+
+        /**
+         * @brief Add newtonian acceleration and jerk of the active particles to existing 3D vector arrays.
+         *
+         * @tparam Particles Particle system type satisfy concept particle system.
+         * @tparam IdxArray Index array type.
+         * @param[in] particles Particle system that is used to evaluated the acceleration.
+         * @param[in] active Indices of the active particles.
+         * @param[in,out] acceleration 3D vector array to be updated.
+         * @param[in,out] jerk 3D vector array to be updated.
+         */
+        template <typename Particles, typename IdxArray>
+        static void add_acc_and_jerk_to(Particles const &particles, IdxArray const &active,
+                                        typename Particles::VectorArray &acceleration,
+                                        typename Particles::VectorArray &jerk);
+
+        /**
+         * @brief Add newtonian acceleration, jerk and snap (second time derivative) of the active particles to
+         * existing 3D vector arrays.
+         *
+         * @note The snap depends on the accelerations of all particles, which have to be given (predicted) as input.
+         *
+         * @tparam Particles Particle system type satisfy concept particle system.
+         * @tparam IdxArray Index array type.
+         * @param[in] particles Particle system that is used to evaluated the acceleration.
+         * @param[in] pred_acc Accelerations of all particles at the current state.
+         * @param[in] active Indices of the active particles.
+         * @param[in,out] acceleration 3D vector array to be updated.
+         * @param[in,out] jerk 3D vector array to be updated.
+         * @param[in,out] snap 3D vector array to be updated.
+         */
+        template <typename Particles, typename IdxArray>
+        static void add_acc_jerk_and_snap_to(Particles const &particles,
+                                             typename Particles::VectorArray const &pred_acc, IdxArray const &active,
+                                             typename Particles::VectorArray &acceleration,
+                                             typename Particles::VectorArray &jerk,
+                                             typename Particles::VectorArray &snap);
+
        private:
+        template <bool EvalPotential, typename Particles>
+        static auto add_to(Particles const &particles, typename Particles::VectorArray &acceleration) ->
+            typename Particles::Scalar;
+
         CREATE_METHOD_CHECK(chain_pos);
 
         CREATE_METHOD_CHECK(index);
@@ -70,14 +163,145 @@ namespace hub::force {
     \*---------------------------------------------------------------------------*/
     template <typename Particles>
     void NewtonianGrav::add_acc_to(const Particles &particles, typename Particles::VectorArray &acceleration) {
+        add_to<false>(particles, acceleration);
+    }
+
+    template <typename Particles>
+    auto NewtonianGrav::add_acc_and_potential_to(const Particles &particles,
+                                                 typename Particles::VectorArray &acceleration) ->
+        typename Particles::Scalar {
+        return add_to<true>(particles, acceleration) * consts::G;
+    }
+
+    template <typename Particles, typename IdxArray>
+    void NewtonianGrav::add_acc_to(const Particles &particles, const IdxArray &active,
+                                   typename Particles::VectorArray &acceleration) {
         using Vector = typename Particles::Vector;
         size_t num = particles.number();
         auto const &p = particles.pos();
         auto const &m = particles.mass();
 
+        for (size_t i : active) {
+            Vector acc{0, 0, 0};
+            for (size_t j = 0; j < num; ++j) {
+                if (j != i) {
+                    Vector dr = p[j] - p[i];
+                    auto r = norm(dr);
+                    acc += dr * (m[j] / (r * r * r));
+                }
+            }
+            acceleration[i] += acc;
+        }
+    }
+
+    template <typename Particles>
+    void NewtonianGrav::add_acc_and_jerk_to(const Particles &particles, typename Particles::VectorArray &acceleration,
+                                            typename Particles::VectorArray &jerk) {
+        using Vector = typename Particles::Vector;
+        size_t num = particles.number();
+        auto const &p = particles.pos();
+        auto const &v = particles.vel();
+        auto const &m = particles.mass();
+
+        for (size_t i = 0; i < num; ++i) {
+            for (size_t j = i + 1; j < num; ++j) {
+                Vector dr = p[j] - p[i];
+                Vector dv = v[j] - v[i];
+                auto r2 = norm2(dr);
+                auto rr3 = 1.0 / (r2 * sqrt(r2));
+                Vector acc = dr * rr3;
+                Vector jk = (dv - dr * (3 * dot(dr, dv) / r2)) * rr3;
+                acceleration[i] += acc * m[j];
+                acceleration[j] -= acc * m[i];
+                jerk[i] += jk * m[j];
+                jerk[j] -= jk * m[i];
+            }
+        }
+    }
+
+    template <typename Particles, typename IdxArray>
+    void NewtonianGrav::add_acc_and_jerk_to(const Particles &particles, const IdxArray &active,
+                                            typename Particles::VectorArray &acceleration,
+                                            typename Particles::VectorArray &jerk) {
+        using Vector = typename Particles::Vector;
+        size_t num = particles.number();
+        auto const &p = particles.pos();
+        auto const &v = particles.vel();
+        auto const &m = particles.mass();
+
+        for (size_t i : active) {
+            Vector acc{0, 0, 0};
+            Vector jk{0, 0, 0};
+            for (size_t j = 0; j < num; ++j) {
+                if (j != i) {
+                    Vector dr = p[j] - p[i];
+                    Vector dv = v[j] - v[i];
+                    auto r2 = norm2(dr);
+                    auto mrr3 = m[j] / (r2 * sqrt(r2));
+                    acc += dr * mrr3;
+                    jk += (dv - dr * (3 * dot(dr, dv) / r2)) * mrr3;
+                }
+            }
+            acceleration[i] += acc;
+            jerk[i] += jk;
+        }
+    }
+
+    template <typename Particles, typename IdxArray>
+    void NewtonianGrav::add_acc_jerk_and_snap_to(const Particles &particles,
+                                                 typename Particles::VectorArray const &pred_acc,
+                                                 const IdxArray &active,
+                                                 typename Particles::VectorArray &acceleration,
+                                                 typename Particles::VectorArray &jerk,
+                                                 typename Particles::VectorArray &snap) {
+        using Vector = typename Particles::Vector;
+        size_t num = particles.number();
+        auto const &p = particles.pos();
+        auto const &v = particles.vel();
+        auto const &m = particles.mass();
+
+        for (size_t i : active) {
+            Vector acc{0, 0, 0};
+            Vector jk{0, 0, 0};
+            Vector sn{0, 0, 0};
+            for (size_t j = 0; j < num; ++j) {
+                if (j != i) {
+                    Vector dr = p[j] - p[i];
+                    Vector dv = v[j] - v[i];
+                    Vector da = pred_acc[j] - pred_acc[i];
+                    auto r2 = norm2(dr);
+                    auto mrr3 = m[j] / (r2 * sqrt(r2));
+                    auto alpha = dot(dr, dv) / r2;
+                    auto beta = (norm2(dv) + dot(dr, da)) / r2 + alpha * alpha;
+                    Vector a_ij = dr * mrr3;
+                    Vector j_ij = dv * mrr3 - a_ij * (3 * alpha);
+                    acc += a_ij;
+                    jk += j_ij;
+                    sn += da * mrr3 - j_ij * (6 * alpha) - a_ij * (3 * beta);
+                }
+            }
+            acceleration[i] += acc;
+            jerk[i] += jk;
+            snap[i] += sn;
+        }
+    }
+
+    template <bool EvalPotential, typename Particles>
+    auto NewtonianGrav::add_to(const Particles &particles, typename Particles::VectorArray &acceleration) ->
+        typename Particles::Scalar {
+        using Vector = typename Particles::Vector;
+        using Scalar = typename Particles::Scalar;
+        size_t num = particles.number();
+        auto const &p = particles.pos();
+        auto const &m = particles.mass();
+        Scalar potential{0};
+
         auto force = [&](Vector const &dr, size_t i, size_t j) {
             auto r = norm(dr);
             auto rr3 = 1.0 / (r * r * r);
+            if constexpr (EvalPotential) {
+                potential -= m[i] * m[j] / r;
+            }
             /*
             acceleration[i] += dr * rr3 * m[j];
             acceleration[j] -= dr * rr3 * m[i];*/
@@ -115,5 +339,6 @@ namespace hub::force {
                 }
             }
         }
+        return potential;
     }
 }  // namespace hub::force
@@ -43,6 +43,12 @@ namespace hub::force {
          */
         constexpr static bool vel_dependent{true};
 
+        /**
+         * @brief Is this force invariant under the rescaling of mass, length and time in N-body units?
+         *
+         */
+        constexpr static bool scale_free{false};
+
         // Type members
         /**
          * @brief Add acceleration from first order post-newtonian term to existing 3D vector array.
@@ -56,7 +62,27 @@ namespace hub::force {
         template <typename Particles>
         static void add_acc_to(Particles const &particles, typename Particles::VectorArray &acceleration);
 
+        /**
+         * @brief Add acceleration from first order post-newtonian term of the active particles to existing 3D vector
+         * array.
+         *
+         * @note Only the entries of the active particles are updated, in Cartesian coordinates.
+         *
+         * @tparam Particles Particle system type satisfy concept particle system.
+         * @tparam IdxArray Index array type.
+         * @param[in] particles Particle system that is used to evaluated the acceleration.
+         * @param[in] active Indices of the active particles.
+         * @param[in,out] acceleration 3D vector array to be updated.
+         */
+        template <typename Particles, typename IdxArray>
+        static void add_acc_to(Particles const &particles, IdxArray const &active,
+                               typename Particles::VectorArray &acceleration);
+
        private:
+        template <bool Mutual, typename Particles, typename IdxArray>
+        static void add_to(Particles const &particles, IdxArray const &active,
+                           typename Particles::VectorArray &acceleration);
+
         CREATE_METHOD_CHECK(chain_pos);
 
         CREATE_METHOD_CHECK(chain_vel);
@@ -72,6 +98,12 @@ namespace hub::force {
          */
         constexpr static bool vel_dependent{true};
 
+        /**
+         * @brief Is this force invariant under the rescaling of mass, length and time in N-body units?
+         *
+         */
+        constexpr static bool scale_free{false};
+
         // Type members
         /**
          * @brief Add acceleration from second order post-newtonian term to existing 3D vector array.
@@ -85,7 +117,27 @@ namespace hub::force {
         template <typename Particles>
         static void add_acc_to(Particles const &particles, typename Particles::VectorArray &acceleration);
 
+        /**
+         * @brief Add acceleration from second order post-newtonian term of the active particles to existing 3D vector
+         * array.
+         *
+         * @note Only the entries of the active particles are updated, in Cartesian coordinates.
+         *
+         * @tparam Particles Particle system type satisfy concept particle system.
+         * @tparam IdxArray Index array type.
+         * @param[in] particles Particle system that is used to evaluated the acceleration.
+         * @param[in] active Indices of the active particles.
+         * @param[in,out] acceleration 3D vector array to be updated.
+         */
+        template <typename Particles, typename IdxArray>
+        static void add_acc_to(Particles const &particles, IdxArray const &active,
+                               typename Particles::VectorArray &acceleration);
+
        private:
+        template <bool Mutual, typename Particles, typename IdxArray>
+        static void add_to(Particles const &particles, IdxArray const &active,
+                           typename Particles::VectorArray &acceleration);
+
         CREATE_METHOD_CHECK(chain_pos);
 
         CREATE_METHOD_CHECK(chain_vel);
@@ -101,6 +153,12 @@ namespace hub::force {
          */
         constexpr static bool vel_dependent{true};
 
+        /**
+         * @brief Is this force invariant under the rescaling of mass, length and time in N-body units?
+         *
+         */
+        constexpr static bool scale_free{false};
+
         // Type members
         /**
          * @brief Add acceleration from two point five order post-newtonian term to existing 3D vector array.
@@ -114,7 +172,27 @@ namespace hub::force {
         template <typename Particles>
         static void add_acc_to(Particles const &particles, typename Particles::VectorArray &acceleration);
 
+        /**
+         * @brief Add acceleration from two point five order post-newtonian term of the active particles to existing 3D
+         * vector array.
+         *
+         * @note Only the entries of the active particles are updated, in Cartesian coordinates.
+         *
+         * @tparam Particles Particle system type satisfy concept particle system.
+         * @tparam IdxArray Index array type.
+         * @param[in] particles Particle system that is used to evaluated the acceleration.
+         * @param[in] active Indices of the active particles.
+         * @param[in,out] acceleration 3D vector array to be updated.
+         */
+        template <typename Particles, typename IdxArray>
+        static void add_acc_to(Particles const &particles, IdxArray const &active,
+                               typename Particles::VectorArray &acceleration);
+
        private:
+        template <bool Mutual, typename Particles, typename IdxArray>
+        static void add_to(Particles const &particles, IdxArray const &active,
+                           typename Particles::VectorArray &acceleration);
+
         CREATE_METHOD_CHECK(chain_pos);
 
         CREATE_METHOD_CHECK(chain_vel);
@@ -133,6 +211,18 @@ namespace hub::force {
     \*---------------------------------------------------------------------------*/
     template <typename Particles>
     void PN1::add_acc_to(const Particles &particles, typename Particles::VectorArray &acceleration) {
+        add_to<true>(particles, Empty{}, acceleration);
+    }
+
+    template <typename Particles, typename IdxArray>
+    void PN1::add_acc_to(const Particles &particles, const IdxArray &active,
+                         typename Particles::VectorArray &acceleration) {
+        add_to<false>(particles, active, acceleration);
+    }
+
+    template <bool Mutual, typename Particles, typename IdxArray>
+    void PN1::add_to(const Particles &particles, const IdxArray &active,
+                     typename Particles::VectorArray &acceleration) {
         size_t num = particles.number();
         auto const &p = particles.pos();
         auto const &v = particles.vel();
@@ -164,11 +254,21 @@ namespace hub::force {
             auto coef = consts::G / r2 * INV_C2;
 
             acceleration[i] += (coef * m[j]) * (Ai * n - Bi * dv);
-            acceleration[j] -= (coef * m[i]) * (Aj * n - Bj * dv);
+            if constexpr (Mutual) {
+                acceleration[j] -= (coef * m[i]) * (Aj * n - Bj * dv);
+            }
         };
 
-        if constexpr (HAS_METHOD(Particles, chain_pos) && HAS_METHOD(Particles, index) &&
-                      HAS_METHOD(Particles, chain_vel)) {
+        if constexpr (!Mutual) {
+            for (size_t i : active) {
+                for (size_t j = 0; j < num; ++j) {
+                    if (j != i) {
+                        force(p[j] - p[i], v[j] - v[i], i, j);
+                    }
+                }
+            }
+        } else if constexpr (HAS_METHOD(Particles, chain_pos) && HAS_METHOD(Particles, index) &&
+                             HAS_METHOD(Particles, chain_vel)) {
             auto const &ch_p = particles.chain_pos();
             auto const &ch_v = particles.chain_vel();
             auto const &idx = particles.index();
@@ -202,6 +302,18 @@ namespace hub::force {
     \*---------------------------------------------------------------------------*/
     template <typename Particles>
     void PN2::add_acc_to(const Particles &particles, typename Particles::VectorArray &acceleration) {
+        add_to<true>(particles, Empty{}, acceleration);
+    }
+
+    template <typename Particles, typename IdxArray>
+    void PN2::add_acc_to(const Particles &particles, const IdxArray &active,
+                         typename Particles::VectorArray &acceleration) {
+        add_to<false>(particles, active, acceleration);
+    }
+
+    template <bool Mutual, typename Particles, typename IdxArray>
+    void PN2::add_to(const Particles &particles, const IdxArray &active,
+                     typename Particles::VectorArray &acceleration) {
         size_t num = particles.number();
         auto const &p = particles.pos();
         auto const &v = particles.vel();
@@ -251,11 +363,21 @@ namespace hub::force {
             auto coef = consts::G / r2 * INV_C4;
 
             acceleration[i] += (coef * m[j]) * (Ai * n - Bi * dv);
-            acceleration[j] -= (coef * m[i]) * (Aj * n - Bj * dv);
+            if constexpr (Mutual) {
+                acceleration[j] -= (coef * m[i]) * (Aj * n - Bj * dv);
+            }
         };
 
-        if constexpr (HAS_METHOD(Particles, chain_pos) && HAS_METHOD(Particles, index) &&
-                      HAS_METHOD(Particles, chain_vel)) {
+        if constexpr (!Mutual) {
+            for (size_t i : active) {
+                for (size_t j = 0; j < num; ++j) {
+                    if (j != i) {
+                        force(p[j] - p[i], v[j] - v[i], i, j);
+                    }
+                }
+            }
+        } else if constexpr (HAS_METHOD(Particles, chain_pos) && HAS_METHOD(Particles, index) &&
+                             HAS_METHOD(Particles, chain_vel)) {
             auto const &ch_p = particles.chain_pos();
             auto const &ch_v = particles.chain_vel();
             auto const &idx = particles.index();
@@ -288,6 +410,18 @@ namespace hub::force {
     \*---------------------------------------------------------------------------*/
     template <typename Particles>
     void PN2p5::add_acc_to(const Particles &particles, typename Particles::VectorArray &acceleration) {
+        add_to<true>(particles, Empty{}, acceleration);
+    }
+
+    template <typename Particles, typename IdxArray>
+    void PN2p5::add_acc_to(const Particles &particles, const IdxArray &active,
+                           typename Particles::VectorArray &acceleration) {
+        add_to<false>(particles, active, acceleration);
+    }
+
+    template <bool Mutual, typename Particles, typename IdxArray>
+    void PN2p5::add_to(const Particles &particles, const IdxArray &active,
+                       typename Particles::VectorArray &acceleration) {
         size_t num = particles.number();
         auto const &p = particles.pos();
         auto const &v = particles.vel();
@@ -316,11 +450,21 @@ namespace hub::force {
             auto coef = 0.8 * consts::G * consts::G * m[i] * m[j] / (r2 * r) * INV_C5;
 
             acceleration[i] += coef * (Ai * n - Bi * dv);
-            acceleration[j] -= coef * (Aj * n - Bj * dv);
+            if constexpr (Mutual) {
+                acceleration[j] -= coef * (Aj * n - Bj * dv);
+            }
         };
 
-        if constexpr (HAS_METHOD(Particles, chain_pos) && HAS_METHOD(Particles, index) &&
-                      HAS_METHOD(Particles, chain_vel)) {
+        if constexpr (!Mutual) {
+            for (size_t i : active) {
+                for (size_t j = 0; j < num; ++j) {
+                    if (j != i) {
+                        force(p[j] - p[i], v[j] - v[i], i, j);
+                    }
+                }
+            }
+        } else if constexpr (HAS_METHOD(Particles, chain_pos) && HAS_METHOD(Particles, index) &&
+                             HAS_METHOD(Particles, chain_vel)) {
             auto const &ch_p = particles.chain_pos();
             auto const &ch_v = particles.chain_vel();
             auto const &idx = particles.index();
@@ -31,11 +31,21 @@ namespace hub::force {
        public:
         constexpr static bool vel_dependent{true};
 
+        constexpr static bool scale_free{false};
+
         // Type members
         template <typename Particles>
         static void add_acc_to(Particles const &particles, typename Particles::VectorArray &acceleration);
 
+        template <typename Particles, typename IdxArray>
+        static void add_acc_to(Particles const &particles, IdxArray const &active,
+                               typename Particles::VectorArray &acceleration);
+
        private:
+        template <bool Mutual, typename Particles, typename IdxArray>
+        static void add_to(Particles const &particles, IdxArray const &active,
+                           typename Particles::VectorArray &acceleration);
+
         CREATE_METHOD_CHECK(chain_pos);
 
         CREATE_METHOD_CHECK(chain_vel);
@@ -45,6 +55,18 @@ namespace hub::force {
 
     template <typename Particles>
     void Tidal::add_acc_to(const Particles &particles, typename Particles::VectorArray &acceleration) {
+        add_to<true>(particles, Empty{}, acceleration);
+    }
+
+    template <typename Particles, typename IdxArray>
+    void Tidal::add_acc_to(const Particles &particles, const IdxArray &active,
+                           typename Particles::VectorArray &acceleration) {
+        add_to<false>(particles, active, acceleration);
+    }
+
+    template <bool Mutual, typename Particles, typename IdxArray>
+    void Tidal::add_to(const Particles &particles, const IdxArray &active,
+                       typename Particles::VectorArray &acceleration) {
         size_t num = particles.number();
         auto const &p = particles.pos();
         auto const &v = particles.vel();
@@ -65,7 +87,9 @@ namespace hub::force {
                     auto rad5 = rad4 * rad[i];
                     auto coef = 3 * consts::G * k[i] * rad5 * m[j] * m[j] * (1 + 3 * tau[i] * dot(dv, dr) / r2) / r8;
                     acceleration[i] += coef / m[i] * dr;
-                    acceleration[j] -= coef / m[j] * dr;
+                    if constexpr (Mutual) {
+                        acceleration[j] -= coef / m[j] * dr;
+                    }
                 }
                 if (k[j] != 0) {
                     auto rad2 = rad[j] * rad[j];
@@ -73,13 +97,23 @@ namespace hub::force {
                     auto rad5 = rad4 * rad[j];
                     auto coef = 3 * consts::G * k[j] * rad5 * m[i] * m[i] * (1 + 3 * tau[j] * dot(dv, dr) / r2) / r8;
                     acceleration[i] += coef / m[i] * dr;
-                    acceleration[j] -= coef / m[j] * dr;
+                    if constexpr (Mutual) {
+                        acceleration[j] -= coef / m[j] * dr;
+                    }
                 }
             }
         };
 
-        if constexpr (HAS_METHOD(Particles, chain_pos) && HAS_METHOD(Particles, index) &&
-                      HAS_METHOD(Particles, chain_vel)) {
+        if constexpr (!Mutual) {
+            for (size_t i : active) {
+                for (size_t j = 0; j < num; ++j) {
+                    if (j != i) {
+                        force(p[j] - p[i], v[j] - v[i], i, j);
+                    }
+                }
+            }
+        } else if constexpr (HAS_METHOD(Particles, chain_pos) && HAS_METHOD(Particles, index) &&
+                             HAS_METHOD(Particles, chain_vel)) {
             auto const &ch_p = particles.chain_pos();
             auto const &ch_v = particles.chain_vel();
             auto const &idx = particles.index();
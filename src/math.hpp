@@ -276,4 +276,41 @@ namespace hub::math {
         }
         return x;
     }
+    /**
+     * @brief Find the root of a monotonically increasing function with Newton iterations safeguarded by bisection.
+     *
+     * @tparam Fun Type of callable object. f(x) returns a pair of (function value, derivative).
+     * @tparam Scalar Floating point like type.
+     * @param f Callable object.
+     * @param low Lower limit of root range, f(low) <= 0.
+     * @param high Upper limit of root range, f(high) >= 0.
+     * @param x Initial guess.
+     * @return Scalar The root.
+     */
+    template <typename Fun, typename Scalar>
+    Scalar root_safe_newton(Fun f, Scalar low, Scalar high, Scalar x) {
+        constexpr size_t max_iter = 128;
+        x = math::in_range(low, x, high);
+        for (size_t i = 0; i < max_iter; ++i) {
+            auto [y, dy] = f(x);
+            if (y == 0) {
+                return x;
+            } else if (y > 0) {
+                high = x;
+            } else {
+                low = x;
+            }
+            Scalar x_new = x - y / dy;
+            if (!(low < x_new && x_new < high)) {
+                x_new = 0.5 * (low + high);
+            }
+            Scalar dx = x_new - x;
+            x = x_new;
+            if (fabs(dx) <= 2 * math::epsilon<Scalar>::value * math::max(static_cast<Scalar>(1), fabs(x)) ||
+                high - low <= 2 * math::epsilon<Scalar>::value * math::max(static_cast<Scalar>(1), fabs(x))) {
+                break;
+            }
+        }
+        return x;
+    }
 }  // namespace hub::math
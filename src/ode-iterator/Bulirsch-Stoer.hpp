@@ -116,6 +116,14 @@ namespace hub::ode {
 
         Scalar reject_rate() { return static_cast<Scalar>(rej_num_) / static_cast<Scalar>(iter_num_); };
 
+        /**
+         * @brief Prepare the iterator for a new integration, keeping the allocated arrays and the constant tables.
+         *
+         * @param[in] warm_start Keep the learned extrapolation rank and step size history to start the new integration
+         * from, instead of restarting with the full rank as a new iterator does.
+         */
+        void reset(bool warm_start = false);
+
        private:
         void check_variable_size();
 
@@ -233,6 +241,20 @@ namespace hub::ode {
         }
     }
 
+    template <typename Integrator, typename ErrEstimator, typename StepController, size_t MaxIter>
+    void BulirschStoer<Integrator, ErrEstimator, StepController, MaxIter>::reset(bool warm_start) {
+        rej_num_ = 0;
+        iter_num_ = 0;
+        step_reject_ = false;
+        if (!warm_start) {
+            ideal_step_size_.fill(0);
+            cost_per_len_.fill(0);
+            last_error_ = 1.0;
+            ideal_rank_ = MaxIter - 1;
+            first_step_ = true;
+        }
+    }
+
     template <typename Integrator, typename ErrEstimator, typename StepController, size_t MaxIter>
     auto BulirschStoer<Integrator, ErrEstimator, StepController, MaxIter>::iterate(EvaluateFun func,
                                                                                    StateScalarArray &data, Scalar &time,
@@ -52,6 +52,13 @@ namespace hub::ode {
         template <typename U>
         Scalar iterate(U& particles, Scalar macro_step_size);
 
+        /**
+         * @brief Prepare the iterator for a new integration, keeping the allocated arrays.
+         *
+         * @param[in] warm_start Keep the predictor of the Gauss-Radau coefficients to start the new integration from.
+         */
+        void reset(bool warm_start = false);
+
        private:
         inline void reset_PC_iteration();
 
@@ -114,6 +121,15 @@ namespace hub::ode {
         spacehub_abort("Exceed the max iteration number");
     }
 
+    template <typename Integrator, typename ErrEstimator, typename StepController>
+    void IAS15<Integrator, ErrEstimator, StepController>::reset(bool warm_start) {
+        if (!warm_start) {
+            integrator_.reset();
+            warmed_up = false;
+        }
+        reset_PC_iteration();
+    }
+
     template <typename Integrator, typename ErrEstimator, typename StepController>
     void IAS15<Integrator, ErrEstimator, StepController>::reset_PC_iteration() {
         last_PC_error_ = math::max_value<Scalar>::value;
@@ -0,0 +1,182 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file block-step.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "../core-computation.hpp"
+#include "../spacehub-concepts.hpp"
+
+namespace hub::ode {
+
+    /*---------------------------------------------------------------------------*\
+          Class BlockStepIterator Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Hierarchical block time steps for Cartesian particle systems.
+     *
+     * Every particle advances with its own step, a power of two fraction H / 2^k of the macro step H, so that particles
+     * on the same level share their block times and all of them meet again at the end of the macro step. At every
+     * block time all particles are predicted to it (O(N)), only the particles whose step ends there are evaluated
+     * (active x all) and corrected by the predictor-corrector Integrator (integrator::Hermite).
+     *
+     * The step of a particle comes from the StepController (AarsethController) after each of its corrections. A
+     * particle may move to a smaller step at any of its block times and to the next larger one when the block time is
+     * aligned with it.
+     *
+     * @tparam Integrator Predictor-corrector integrator with individual particle times.
+     * @tparam StepController Individual step criterion.
+     */
+    template <typename Integrator, typename StepController>
+    class BlockStepIterator {
+       public:
+        SPACEHUB_USING_TYPE_SYSTEM_OF(Integrator);
+
+        /** Deepest level, the smallest step is H / 2^max_level. */
+        static constexpr size_t max_level{40};
+
+        template <CONCEPT_PARTICLE_SYSTEM T>
+        auto iterate(T &particles, typename T::Scalar macro_step_size) -> typename T::Scalar;
+
+        void set_rtol(Scalar rtol);
+
+        /**
+         * @brief Number of single particle force evaluations so far.
+         */
+        SPACEHUB_READ_ACCESSOR(size_t, eval_count, eval_count_);
+
+        /**
+         * @brief Number of block times so far. A shared step would have cost number() force evaluations at each.
+         */
+        SPACEHUB_READ_ACCESSOR(size_t, block_count, block_count_);
+
+       private:
+        using Tick = uint64_t;
+
+        static constexpr Tick end_tick{Tick{1} << max_level};
+
+        static constexpr Tick span(size_t level) { return Tick{1} << (max_level - level); }
+
+        size_t level_of(Scalar macro_step_size, Scalar step) const;
+
+        // Private members
+        Integrator integrator_;
+
+        StepController step_ctrl_;
+
+        ScalarArray step_;
+
+        IdxArray level_;
+
+        IdxArray active_;
+
+        std::vector<Tick> next_tick_;
+
+        size_t eval_count_{0};
+
+        size_t block_count_{0};
+    };
+
+    /*---------------------------------------------------------------------------*\
+          Class BlockStepIterator Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename Integrator, typename StepController>
+    void BlockStepIterator<Integrator, StepController>::set_rtol(Scalar rtol) {
+        step_ctrl_.set_rtol(Integrator::order, rtol);
+    }
+
+    template <typename Integrator, typename StepController>
+    size_t BlockStepIterator<Integrator, StepController>::level_of(Scalar macro_step_size, Scalar step) const {
+        size_t level = 0;
+        for (Scalar h = macro_step_size; level < max_level && h > step; h *= 0.5) {
+            ++level;
+        }
+        return level;
+    }
+
+    template <typename Integrator, typename StepController>
+    template <CONCEPT_PARTICLE_SYSTEM T>
+    auto BlockStepIterator<Integrator, StepController>::iterate(T &particles, typename T::Scalar macro_step_size) ->
+        typename T::Scalar {
+        size_t num = particles.number();
+        auto const &derivs = integrator_.derivatives();
+        if (!integrator_.is_synchronized(particles)) {
+            integrator_.start(particles);
+            eval_count_ += num;
+            step_.resize(num);
+            level_.resize(num);
+            next_tick_.resize(num);
+            for (size_t i = 0; i < num; ++i) {
+                step_[i] = step_ctrl_.start(derivs[i][0], derivs[i][1]);
+            }
+        }
+
+        Scalar const t0 = particles.time();
+        Scalar const tick_size = macro_step_size / static_cast<Scalar>(end_tick);
+
+        for (size_t i = 0; i < num; ++i) {
+            level_[i] = level_of(macro_step_size, step_[i]);
+            next_tick_[i] = span(level_[i]);
+        }
+
+        for (Tick tick = 0; tick < end_tick;) {
+            tick = *std::min_element(next_tick_.begin(), next_tick_.end());
+            integrator_.predict(particles,
+                                tick == end_tick ? t0 + macro_step_size : t0 + tick_size * static_cast<Scalar>(tick));
+
+            active_.clear();
+            for (size_t i = 0; i < num; ++i) {
+                if (next_tick_[i] == tick) {
+                    active_.emplace_back(i);
+                }
+            }
+            integrator_.correct(particles, active_);
+            eval_count_ += active_.size();
+            block_count_++;
+
+            if (tick < end_tick) {
+                for (size_t i : active_) {
+                    step_[i] = step_ctrl_.next(derivs[i]);
+                    size_t level = level_of(macro_step_size, step_[i]);
+                    if (level < level_[i]) {
+                        level = tick % span(level_[i] - 1) == 0 ? level_[i] - 1 : level_[i];
+                    }
+                    level_[i] = level;
+                    next_tick_[i] = tick + span(level);
+                }
+            } else {
+                for (size_t i = 0; i < num; ++i) {
+                    step_[i] = std::min(step_ctrl_.next(derivs[i]),
+                                        2 * tick_size * static_cast<Scalar>(span(level_[i])));
+                }
+            }
+        }
+
+        Scalar max_step = *std::max_element(step_.begin(), step_.end());
+        return std::min(2 * macro_step_size, max_step);
+    }
+}  // namespace hub::ode
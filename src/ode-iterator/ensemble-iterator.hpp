@@ -0,0 +1,261 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file ensemble-iterator.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <array>
+
+#include "../core-computation.hpp"
+#include "../integrator/symplectic/symplectic-integrator.hpp"
+#include "Bulirsch-Stoer.hpp"
+#include "step-controller/PID-controller.hpp"
+
+namespace hub::ode {
+
+    /*---------------------------------------------------------------------------*\
+         Class EnsembleConstIterator Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Fixed step iterator of a system::EnsembleSystem. Every lane advances with its own step size.
+     *
+     * @tparam Integrator Any integrator driven by drift()/kick(), e.g. the symplectic integrators.
+     */
+    template <typename Integrator>
+    class EnsembleConstIterator {
+       public:
+        /**
+         * @brief Advance every lane by its step size.
+         *
+         * @return The step sizes of the next iteration, the same ones.
+         */
+        template <typename Ensemble>
+        auto iterate(Ensemble &ensemble, typename Ensemble::Scalar const &step_size) -> typename Ensemble::Scalar {
+            integrator_.integrate(ensemble, step_size);
+            return step_size;
+        }
+
+       private:
+        Integrator integrator_;
+    };
+
+    /*---------------------------------------------------------------------------*\
+         Class EnsembleBulirschStoer Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Bulirsch-Stoer extrapolation over the lanes of a system::EnsembleSystem.
+     *
+     * All lanes share the DKD leapfrog sub-steps and the extrapolation depth, so the force evaluations stay in
+     * lockstep, but every lane has its own step size and error. The iteration stops at the first column of the
+     * convergence window where all lanes converged, or at the last column of the window. Converged lanes are accepted,
+     * the others are reset to their initial state (masked acceptance) and retry with the smaller step returned for
+     * them. The depth is selected on the work per unit step summed over the lanes.
+     *
+     * @tparam Ensemble Type of the ensemble system.
+     * @tparam MaxIter Number of columns of the extrapolation table.
+     */
+    template <typename Ensemble, size_t MaxIter = 8>
+    class EnsembleBulirschStoer {
+       public:
+        using Real = typename Ensemble::Real;
+
+        using Scalar = typename Ensemble::Scalar;
+
+        using State = typename Ensemble::State;
+
+        using BSConsts = BulirschStoerConsts<Real, MaxIter, false>;
+
+        static constexpr size_t lanes{Ensemble::lanes};
+
+        EnsembleBulirschStoer();
+
+        /**
+         * @brief Advance every lane by its step size, or leave it untouched if its step is rejected.
+         *
+         * @param[in,out] ensemble Ensemble system.
+         * @param[in] step_size Step size of every lane. Lanes with zero steps are idle.
+         * @return The step sizes of the next iteration.
+         */
+        Scalar iterate(Ensemble &ensemble, Scalar const &step_size);
+
+        void set_atol(Real atol) { atol_ = atol; };
+
+        void set_rtol(Real rtol) { rtol_ = rtol; };
+
+        /**
+         * @brief Number of lane steps that have been rejected.
+         */
+        SPACEHUB_READ_ACCESSOR(size_t, reject_count, rej_num_);
+
+       private:
+        void integrate_by_n_steps(Ensemble &ensemble, Scalar const &step_size, size_t steps);
+
+        void extrapolate(size_t k);
+
+        Scalar error() const;
+
+        Real work(size_t k) const;
+
+        BSConsts consts_;
+
+        PIDController<typename Ensemble::TypeSet> step_ctrl_;
+
+        std::array<State, MaxIter> extrap_list_;
+
+        /** @brief Step size ratio suggested by each column, per lane.*/
+        std::array<Scalar, MaxIter> ratio_;
+
+        State input_;
+
+        Real atol_{0};
+
+        Real rtol_{1e-14};
+
+        size_t ideal_rank_{MaxIter - 2};
+
+        size_t rej_num_{0};
+
+        bool first_step_{true};
+    };
+
+    /*---------------------------------------------------------------------------*\
+         Class EnsembleBulirschStoer Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename Ensemble, size_t MaxIter>
+    EnsembleBulirschStoer<Ensemble, MaxIter>::EnsembleBulirschStoer() {
+        step_ctrl_.set_limiter(0.02, 4.0);
+        step_ctrl_.set_safe_guards(0.72, 0.95);
+    }
+
+    template <typename Ensemble, size_t MaxIter>
+    auto EnsembleBulirschStoer<Ensemble, MaxIter>::iterate(Ensemble &ensemble, Scalar const &step_size) -> Scalar {
+        input_ = ensemble.state();
+        Scalar const t0 = ensemble.time();
+        size_t const last = first_step_ ? MaxIter - 1 : math::min(ideal_rank_ + 1, MaxIter - 1);
+        Scalar err;
+        size_t k = 0;
+        for (; k <= last; ++k) {
+            ensemble.state() = input_;
+            ensemble.time() = t0;
+            integrate_by_n_steps(ensemble, step_size, consts_.h(k));
+            extrap_list_[k] = ensemble.state();
+            if (k == 0) continue;
+
+            extrapolate(k);
+            err = error();
+            bool converged = true;
+            for (size_t l = 0; l < lanes; ++l) {
+                ratio_[k][l] = step_ctrl_.next(2 * k + 1, err[l]);
+                converged = converged && err[l] <= 1.0;
+            }
+            if (converged && (first_step_ ? k >= 2 : k + 1 >= ideal_rank_)) {
+                break;
+            }
+        }
+        k = math::min(k, last);
+
+        // masked acceptance
+        Scalar next;
+        for (size_t l = 0; l < lanes; ++l) {
+            if (err[l] <= 1.0) {
+                ensemble.time()[l] = t0[l] + step_size[l];
+            } else {
+                ensemble.time()[l] = t0[l];
+                rej_num_++;
+            }
+        }
+        for (size_t i = 0; i < input_.size(); ++i) {
+            for (size_t l = 0; l < lanes; ++l) {
+                ensemble.state()[i][l] = err[l] <= 1.0 ? extrap_list_[0][i][l] : input_[i][l];
+            }
+        }
+
+        // depth selection on the work per unit step of the whole ensemble
+        size_t new_rank = k;
+        Scalar ratio = ratio_[k];
+        if (k >= 3 && work(k - 1) < BSConsts::dec_factor * work(k)) {
+            new_rank = k - 1;
+            ratio = ratio_[k - 1];
+        } else if (k + 1 < MaxIter - 1 && work(k) < BSConsts::inc_factor * work(k - 1)) {
+            new_rank = k + 1;
+            ratio = (consts_.cost(k + 1) / consts_.cost(k)) * ratio_[k];
+        }
+        ideal_rank_ = math::in_range(static_cast<size_t>(2), new_rank, MaxIter - 2);
+        first_step_ = false;
+
+        for (size_t l = 0; l < lanes; ++l) {
+            next[l] = step_size[l] * step_ctrl_.limiter(2 * new_rank + 1, ratio[l]);
+        }
+        return next;
+    }
+
+    template <typename Ensemble, size_t MaxIter>
+    void EnsembleBulirschStoer<Ensemble, MaxIter>::integrate_by_n_steps(Ensemble &ensemble, Scalar const &step_size,
+                                                                       size_t steps) {
+        Scalar h = step_size / static_cast<Real>(steps);
+        Scalar half_h = 0.5 * h;
+        ensemble.drift(half_h);
+        for (size_t i = 1; i < steps; i++) {
+            ensemble.kick(h);
+            ensemble.drift(h);
+        }
+        ensemble.kick(h);
+        ensemble.drift(half_h);
+    }
+
+    template <typename Ensemble, size_t MaxIter>
+    void EnsembleBulirschStoer<Ensemble, MaxIter>::extrapolate(size_t k) {
+        for (size_t j = k; j > 0; --j) {
+            Real coef = consts_.table_coef(k, k - j);
+            for (size_t i = 0; i < input_.size(); ++i) {
+                for (size_t l = 0; l < lanes; ++l) {
+                    extrap_list_[j - 1][i][l] =
+                        extrap_list_[j][i][l] + (extrap_list_[j][i][l] - extrap_list_[j - 1][i][l]) * coef;
+                }
+            }
+        }
+    }
+
+    template <typename Ensemble, size_t MaxIter>
+    auto EnsembleBulirschStoer<Ensemble, MaxIter>::error() const -> Scalar {
+        Scalar err;
+        err.fill(0);
+        for (size_t i = 0; i < input_.size(); ++i) {
+            for (size_t l = 0; l < lanes; ++l) {
+                Real scale = math::max(fabs(input_[i][l]), fabs(extrap_list_[0][i][l]));
+                Real diff = fabs(extrap_list_[0][i][l] - extrap_list_[1][i][l]);
+                err[l] = math::max(err[l], diff / (atol_ + scale * rtol_));
+            }
+        }
+        return err;
+    }
+
+    template <typename Ensemble, size_t MaxIter>
+    auto EnsembleBulirschStoer<Ensemble, MaxIter>::work(size_t k) const -> Real {
+        Real inv_ratio = 0;
+        for (size_t l = 0; l < lanes; ++l) {
+            inv_ratio += 1 / ratio_[k][l];
+        }
+        return consts_.cost(k) * inv_ratio;
+    }
+}  // namespace hub::ode
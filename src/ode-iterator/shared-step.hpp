@@ -0,0 +1,117 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file shared-step.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include "../core-computation.hpp"
+#include "../spacehub-concepts.hpp"
+
+namespace hub::ode {
+
+    /*---------------------------------------------------------------------------*\
+          Class SharedStepIterator Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Shared adaptive steps for predictor-corrector integrators (integrator::Hermite).
+     *
+     * All particles take the smallest of their individual steps from the StepController, allowed to at most double
+     * from one step to the next. The macro step is always completed, in equal sub-steps if it is longer than the
+     * allowed step.
+     *
+     * @tparam Integrator Predictor-corrector integrator.
+     * @tparam StepController Individual step criterion.
+     */
+    template <typename Integrator, typename StepController>
+    class SharedStepIterator {
+       public:
+        SPACEHUB_USING_TYPE_SYSTEM_OF(Integrator);
+
+        template <CONCEPT_PARTICLE_SYSTEM T>
+        auto iterate(T &particles, typename T::Scalar macro_step_size) -> typename T::Scalar;
+
+        void set_rtol(Scalar rtol);
+
+        /**
+         * @brief Number of single particle force evaluations so far.
+         */
+        SPACEHUB_READ_ACCESSOR(size_t, eval_count, eval_count_);
+
+       private:
+        // Private members
+        Integrator integrator_;
+
+        StepController step_ctrl_;
+
+        IdxArray all_;
+
+        Scalar step_{0};
+
+        size_t eval_count_{0};
+    };
+
+    /*---------------------------------------------------------------------------*\
+          Class SharedStepIterator Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename Integrator, typename StepController>
+    void SharedStepIterator<Integrator, StepController>::set_rtol(Scalar rtol) {
+        step_ctrl_.set_rtol(Integrator::order, rtol);
+    }
+
+    template <typename Integrator, typename StepController>
+    template <CONCEPT_PARTICLE_SYSTEM T>
+    auto SharedStepIterator<Integrator, StepController>::iterate(T &particles, typename T::Scalar macro_step_size) ->
+        typename T::Scalar {
+        size_t num = particles.number();
+        auto const &derivs = integrator_.derivatives();
+        if (!integrator_.is_synchronized(particles)) {
+            integrator_.start(particles);
+            eval_count_ += num;
+            all_.resize(num);
+            step_ = math::max_value<Scalar>::value;
+            for (size_t i = 0; i < num; ++i) {
+                all_[i] = i;
+                step_ = std::min(step_, step_ctrl_.start(derivs[i][0], derivs[i][1]));
+            }
+        }
+
+        Scalar const end = particles.time() + macro_step_size;
+        for (Scalar rest = macro_step_size; rest > 0; rest = end - particles.time()) {
+            auto sub_steps = static_cast<size_t>(std::ceil(static_cast<double>(rest / step_)));
+            Scalar h = sub_steps > 1 ? rest / static_cast<Scalar>(sub_steps) : rest;
+            integrator_.predict(particles, sub_steps > 1 ? particles.time() + h : end);
+            integrator_.correct(particles, all_);
+            eval_count_ += num;
+
+            Scalar next = 2 * h;
+            for (size_t i = 0; i < num; ++i) {
+                next = std::min(next, step_ctrl_.next(derivs[i]));
+            }
+            step_ = next;
+        }
+        return step_;
+    }
+}  // namespace hub::ode
@@ -0,0 +1,106 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file Aarseth-controller.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <array>
+
+#include "../../math.hpp"
+
+namespace hub::ode {
+    /*---------------------------------------------------------------------------*\
+         Class AarsethController Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Individual time step criterion of Aarseth, generalized to the order of the integrator.
+     *
+     * For an integrator of order p with the magnitudes of the derivatives |a^(k)|, k < p, at the end of the step, the
+     * next step is eta (A1 / A(p-2))^(1/(p-3)) with A(k) = sqrt(|a^(k-1)||a^(k+1)| + |a^(k)|^2) (Nitadori & Makino
+     * 2008). For p = 4 this is Aarseth's sqrt(eta^2 (|a||s| + |j|^2) / (|j||c| + |s|^2)), for p = 2 the criterion
+     * falls back to eta |a| / |j|.
+     *
+     * @tparam TypeSystem
+     */
+    template <typename TypeSystem>
+    class AarsethController {
+       public:
+        // Type member
+        SPACEHUB_USING_TYPE_SYSTEM_OF(TypeSystem);
+
+        /**
+         * @brief Set eta from the relative tolerance of an integrator of the given order.
+         *
+         * The local error of an order p step is ~eta^(p+1).
+         *
+         * @param[in] order Order of the integrator.
+         * @param[in] rtol Relative tolerance.
+         */
+        void set_rtol(size_t order, Scalar rtol);
+
+        void set_eta(Scalar eta) { eta_ = eta; };
+
+        SPACEHUB_READ_ACCESSOR(Scalar, eta, eta_);
+
+        /**
+         * @brief Conservative step to start from, when only the acceleration and jerk are known.
+         */
+        Scalar start(Scalar acc, Scalar jerk) const;
+
+        template <size_t Order>
+        Scalar next(std::array<Scalar, Order> const &derivatives) const;
+
+       private:
+        Scalar eta_{0.1};
+    };
+
+    /*---------------------------------------------------------------------------*\
+         Class AarsethController Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename TypeSystem>
+    void AarsethController<TypeSystem>::set_rtol(size_t order, Scalar rtol) {
+        eta_ = std::min(POW(rtol, 1.0 / static_cast<double>(order + 1)), Scalar{0.1});
+    }
+
+    template <typename TypeSystem>
+    auto AarsethController<TypeSystem>::start(Scalar acc, Scalar jerk) const -> Scalar {
+        return jerk > 0 ? eta_ * eta_ * acc / jerk : math::max_value<Scalar>::value;
+    }
+
+    template <typename TypeSystem>
+    template <size_t Order>
+    auto AarsethController<TypeSystem>::next(std::array<Scalar, Order> const &d) const -> Scalar {
+        if constexpr (Order == 2) {
+            return d[1] > 0 ? eta_ * d[0] / d[1] : math::max_value<Scalar>::value;
+        } else {
+            static_assert(Order >= 4, "Aarseth's criterion needs the derivatives up to the third!");
+            Scalar low = d[0] * d[2] + d[1] * d[1];
+            Scalar high = d[Order - 3] * d[Order - 1] + d[Order - 2] * d[Order - 2];
+            if (high > 0) {
+                return eta_ * POW(low / high, 0.5 / static_cast<double>(Order - 3));
+            } else {
+                return math::max_value<Scalar>::value;
+            }
+        }
+    }
+}  // namespace hub::ode
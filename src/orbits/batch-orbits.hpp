@@ -0,0 +1,273 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file orbits/batch-orbits.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <vector>
+
+#include "../multi-thread/multi-thread.hpp"
+#include "orbits.hpp"
+
+namespace hub::orbit {
+
+    /*---------------------------------------------------------------------------*\
+         Class OrbitArray Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Structure of arrays of Kepler orbit parameters. The i-th element of each array describes the i-th orbit.
+     *
+     * @tparam ScalarArray Contiguous array like type.
+     */
+    template <typename ScalarArray = std::vector<double>>
+    struct OrbitArray {
+        using Scalar = typename ScalarArray::value_type;
+
+        ScalarArray m1, m2, p, e, i, Omega, omega, nu;
+
+        [[nodiscard]] size_t size() const { return e.size(); }
+
+        void resize(size_t n) {
+            m1.resize(n), m2.resize(n), p.resize(n), e.resize(n);
+            i.resize(n), Omega.resize(n), omega.resize(n), nu.resize(n);
+        }
+
+        void reserve(size_t n) {
+            m1.reserve(n), m2.reserve(n), p.reserve(n), e.reserve(n);
+            i.reserve(n), Omega.reserve(n), omega.reserve(n), nu.reserve(n);
+        }
+
+        void emplace_back(KeplerOrbit<Scalar> const &args) {
+            m1.emplace_back(args.m1), m2.emplace_back(args.m2), p.emplace_back(args.p), e.emplace_back(args.e);
+            i.emplace_back(args.i), Omega.emplace_back(args.Omega), omega.emplace_back(args.omega);
+            nu.emplace_back(args.nu);
+        }
+
+        [[nodiscard]] KeplerOrbit<Scalar> operator[](size_t k) const {
+            KeplerOrbit<Scalar> args;
+            args.m1 = m1[k], args.m2 = m2[k], args.p = p[k], args.e = e[k];
+            args.i = i[k], args.Omega = Omega[k], args.omega = omega[k], args.nu = nu[k];
+            args.orbit_type = classify_orbit(args.e);
+            return args;
+        }
+    };
+
+    /*---------------------------------------------------------------------------*\
+         Class CoordArray Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Structure of arrays of relative positions and velocities.
+     *
+     * @tparam ScalarArray Contiguous array like type.
+     */
+    template <typename ScalarArray = std::vector<double>>
+    struct CoordArray {
+        using Scalar = typename ScalarArray::value_type;
+
+        ScalarArray x, y, z, vx, vy, vz;
+
+        [[nodiscard]] size_t size() const { return x.size(); }
+
+        void resize(size_t n) { x.resize(n), y.resize(n), z.resize(n), vx.resize(n), vy.resize(n), vz.resize(n); }
+    };
+
+    /**
+     * @brief Arrays shorter than this are converted on the calling thread.
+     */
+    inline constexpr size_t batch_multi_thread_threshold = 16384;
+
+    /**
+     * @brief Number of elements processed per inner block. The trigonometric functions of a block are evaluated in
+     * separated tight loops, so that compilers with a vector math library (e.g. glibc libmvec) can vectorize them.
+     */
+    inline constexpr size_t batch_block_size = 256;
+
+    namespace detail {
+        template <typename Lambda>
+        void batch_dispatch(size_t n, size_t thread_num, Lambda &&kernel) {
+            if (n < batch_multi_thread_threshold || thread_num <= 1) {
+                kernel(0, n);
+            } else {
+                multi_thread::multi_threads_loop(n, math::min(thread_num, n / batch_block_size + 1),
+                                                 std::forward<Lambda>(kernel));
+            }
+        }
+
+        template <typename Orbits, typename Coords>
+        void orbit_to_coord_block(Orbits const &orb, Coords &coord, size_t begin, size_t end) {
+            using Scalar = typename Coords::Scalar;
+            Scalar sin_nu[batch_block_size], cos_nu[batch_block_size];
+            Scalar sin_O[batch_block_size], cos_O[batch_block_size];
+            Scalar sin_i[batch_block_size], cos_i[batch_block_size];
+            Scalar sin_w[batch_block_size], cos_w[batch_block_size];
+
+            for (size_t b = begin; b < end; b += batch_block_size) {
+                size_t const len = math::min(batch_block_size, end - b);
+                Scalar const *nu = &orb.nu[b];
+                Scalar const *Omega = &orb.Omega[b];
+                Scalar const *inc = &orb.i[b];
+                Scalar const *omega = &orb.omega[b];
+
+                for (size_t k = 0; k < len; ++k) sin_nu[k] = sin(nu[k]);
+                for (size_t k = 0; k < len; ++k) cos_nu[k] = cos(nu[k]);
+                for (size_t k = 0; k < len; ++k) sin_O[k] = sin(Omega[k]);
+                for (size_t k = 0; k < len; ++k) cos_O[k] = cos(Omega[k]);
+                for (size_t k = 0; k < len; ++k) sin_i[k] = sin(inc[k]);
+                for (size_t k = 0; k < len; ++k) cos_i[k] = cos(inc[k]);
+                for (size_t k = 0; k < len; ++k) sin_w[k] = sin(omega[k]);
+                for (size_t k = 0; k < len; ++k) cos_w[k] = cos(omega[k]);
+
+                for (size_t k = 0; k < len; ++k) {
+                    size_t const j = b + k;
+                    Scalar const u = (orb.m1[j] + orb.m2[j]) * consts::G;
+                    Scalar const e = orb.e[j];
+                    Scalar const r = orb.p[j] / (1 + e * cos_nu[k]);
+                    Scalar const v = sqrt(u / orb.p[j]);
+
+                    // Same rotation as euler_rotate(., Omega, i, omega + pi), written as the perifocal basis P, Q.
+                    Scalar const s_psi = -sin_w[k];
+                    Scalar const c_psi = -cos_w[k];
+                    Scalar const Px = cos_O[k] * c_psi - sin_O[k] * cos_i[k] * s_psi;
+                    Scalar const Py = sin_O[k] * c_psi + cos_O[k] * cos_i[k] * s_psi;
+                    Scalar const Pz = sin_i[k] * s_psi;
+                    Scalar const Qx = -(cos_O[k] * s_psi + sin_O[k] * cos_i[k] * c_psi);
+                    Scalar const Qy = -(sin_O[k] * s_psi - cos_O[k] * cos_i[k] * c_psi);
+                    Scalar const Qz = sin_i[k] * c_psi;
+
+                    Scalar const px = r * cos_nu[k];
+                    Scalar const py = r * sin_nu[k];
+                    Scalar const qx = -v * sin_nu[k];
+                    Scalar const qy = v * (e + cos_nu[k]);
+
+                    coord.x[j] = px * Px + py * Qx;
+                    coord.y[j] = px * Py + py * Qy;
+                    coord.z[j] = px * Pz + py * Qz;
+                    coord.vx[j] = qx * Px + qy * Qx;
+                    coord.vy[j] = qx * Py + qy * Qy;
+                    coord.vz[j] = qx * Pz + qy * Qz;
+                }
+            }
+        }
+    }  // namespace detail
+
+    /**
+     * @brief Transfer arrays of Kepler orbit parameters to relative positions and velocities.
+     *
+     * Equivalent to calling orbit_to_coord() on each orbit, but every angle is passed through sin/cos only once and
+     * the work is spread over threads if the arrays are longer than batch_multi_thread_threshold.
+     *
+     * @tparam ScalarArray1 Contiguous array like type.
+     * @tparam ScalarArray2 Contiguous array like type.
+     * @param[in] orbits Orbit parameters.
+     * @param[out] coords Relative positions and velocities. Resized to match the input.
+     * @param[in] thread_num Maximum number of threads.
+     */
+    template <typename ScalarArray1, typename ScalarArray2>
+    void orbit_to_coord(OrbitArray<ScalarArray1> const &orbits, CoordArray<ScalarArray2> &coords,
+                        size_t thread_num = multi_thread::auto_thread) {
+        size_t const n = orbits.size();
+        coords.resize(n);
+        detail::batch_dispatch(n, thread_num, [&](size_t begin, size_t end) {
+            detail::orbit_to_coord_block(orbits, coords, begin, end);
+        });
+    }
+
+    /**
+     * @brief Transfer arrays of relative positions and velocities to Kepler orbit parameters.
+     *
+     * @tparam ScalarArray1 Contiguous array like type.
+     * @tparam ScalarArray2 Contiguous array like type.
+     * @tparam ScalarArray3 Contiguous array like type.
+     * @param[in] m1 Masses of the primaries.
+     * @param[in] m2 Masses of the secondaries.
+     * @param[in] coords Relative positions and velocities.
+     * @param[out] orbits Orbit parameters. Resized to match the input.
+     * @param[in] thread_num Maximum number of threads.
+     */
+    template <typename ScalarArray1, typename ScalarArray2, typename ScalarArray3>
+    void coord_to_orbit(ScalarArray1 const &m1, ScalarArray1 const &m2, CoordArray<ScalarArray2> const &coords,
+                        OrbitArray<ScalarArray3> &orbits, size_t thread_num = multi_thread::auto_thread) {
+        using Scalar = typename ScalarArray3::value_type;
+        using Vector = Vec3<Scalar>;
+        size_t const n = coords.size();
+        DEBUG_MODE_ASSERT(m1.size() == n && m2.size() == n, "Mass arrays and coordinate arrays size mismatch!");
+        orbits.resize(n);
+        detail::batch_dispatch(n, thread_num, [&](size_t begin, size_t end) {
+            for (size_t j = begin; j < end; ++j) {
+                auto args = orbit::coord_to_orbit(static_cast<Scalar>(m1[j]), static_cast<Scalar>(m2[j]),
+                                                  Vector(coords.x[j], coords.y[j], coords.z[j]),
+                                                  Vector(coords.vx[j], coords.vy[j], coords.vz[j]));
+                orbits.m1[j] = args.m1, orbits.m2[j] = args.m2, orbits.p[j] = args.p, orbits.e[j] = args.e;
+                orbits.i[j] = args.i, orbits.Omega[j] = args.Omega, orbits.omega[j] = args.omega;
+                orbits.nu[j] = args.nu;
+            }
+        });
+    }
+
+    /**
+     * @brief Rotate arrays of vectors with Euler angles in place. Batched version of euler_rotate().
+     *
+     * @tparam ScalarArray Contiguous array like type.
+     * @param[in,out] x X components.
+     * @param[in,out] y Y components.
+     * @param[in,out] z Z components.
+     * @param[in] phi First Euler angles.
+     * @param[in] theta Second Euler angles.
+     * @param[in] psi Third Euler angles.
+     * @param[in] thread_num Maximum number of threads.
+     */
+    template <typename ScalarArray>
+    void euler_rotate(ScalarArray &x, ScalarArray &y, ScalarArray &z, ScalarArray const &phi, ScalarArray const &theta,
+                      ScalarArray const &psi, size_t thread_num = multi_thread::auto_thread) {
+        using Scalar = typename ScalarArray::value_type;
+        size_t const n = x.size();
+        DEBUG_MODE_ASSERT(y.size() == n && z.size() == n && phi.size() == n && theta.size() == n && psi.size() == n,
+                          "Array size mismatch!");
+        detail::batch_dispatch(n, thread_num, [&](size_t begin, size_t end) {
+            Scalar s_phi[batch_block_size], c_phi[batch_block_size];
+            Scalar s_theta[batch_block_size], c_theta[batch_block_size];
+            Scalar s_psi[batch_block_size], c_psi[batch_block_size];
+            for (size_t b = begin; b < end; b += batch_block_size) {
+                size_t const len = math::min(batch_block_size, end - b);
+                for (size_t k = 0; k < len; ++k) s_phi[k] = sin(phi[b + k]);
+                for (size_t k = 0; k < len; ++k) c_phi[k] = cos(phi[b + k]);
+                for (size_t k = 0; k < len; ++k) s_theta[k] = sin(theta[b + k]);
+                for (size_t k = 0; k < len; ++k) c_theta[k] = cos(theta[b + k]);
+                for (size_t k = 0; k < len; ++k) s_psi[k] = sin(psi[b + k]);
+                for (size_t k = 0; k < len; ++k) c_psi[k] = cos(psi[b + k]);
+
+                for (size_t k = 0; k < len; ++k) {
+                    size_t const j = b + k;
+                    Scalar const vx = x[j], vy = y[j], vz = z[j];
+                    x[j] = vx * (c_phi[k] * c_psi[k] - s_phi[k] * c_theta[k] * s_psi[k]) -
+                           vy * (c_phi[k] * s_psi[k] + s_phi[k] * c_theta[k] * c_psi[k]) +
+                           vz * (s_phi[k] * s_theta[k]);
+                    y[j] = vx * (s_phi[k] * c_psi[k] + c_phi[k] * c_theta[k] * s_psi[k]) -
+                           vy * (s_phi[k] * s_psi[k] - c_phi[k] * c_theta[k] * c_psi[k]) -
+                           vz * (c_phi[k] * s_theta[k]);
+                    z[j] = vx * s_theta[k] * s_psi[k] + vy * s_theta[k] * c_psi[k] + vz * c_theta[k];
+                }
+            }
+        });
+    }
+}  // namespace hub::orbit
@@ -51,7 +51,9 @@ namespace hub::orbit {
      * @brief A place holder that indicates one of the three angles in orbital parameters will be randomly generated.
      */
     struct RandomIndicator {
-    } isotherm;
+    };
+
+    inline RandomIndicator isotherm;
 
 #if __cplusplus > COMPILER_VERSION
     template <typename T>
@@ -308,6 +310,98 @@ namespace hub::orbit {
         }
     }
 
+    /**
+     * @brief Solve the elliptic Kepler equation E - e*sin(E) = M.
+     *
+     * The mean anomaly is reduced to [-pi, pi) and the Danby starter E0 = M + 0.85*e*sign(M) is refined with Halley
+     * iterations, which converges to machine precision in 2-4 iterations for any 0 <= e < 1. The returned eccentric
+     * anomaly is shifted back by the same number of turns, i.e. E - M keeps the periodicity of the input.
+     *
+     * @tparam Scalar Floating point like type.
+     * @param M_anomaly Mean anomaly.
+     * @param e Eccentricity.
+     * @return Scalar Eccentric anomaly.
+     */
+    template <typename Scalar>
+    Scalar solve_elliptic_kepler(Scalar M_anomaly, Scalar e) {
+        constexpr size_t max_iter = 16;
+        Scalar const two_pi = 2 * consts::pi;
+        Scalar const turns = floor((M_anomaly + consts::pi) / two_pi);
+        Scalar const M = M_anomaly - turns * two_pi;
+
+        Scalar E = M + (M >= 0 ? 0.85 : -0.85) * e;
+        for (size_t i = 0; i < max_iter; ++i) {
+            Scalar e_sin = e * sin(E);
+            Scalar e_cos = e * cos(E);
+            Scalar f = E - e_sin - M;
+            Scalar df = 1 - e_cos;
+            Scalar dE = -f / (df - 0.5 * f * e_sin / df);
+            E += dE;
+            if (fabs(dE) <= 4 * math::epsilon<Scalar>::value * math::max(static_cast<Scalar>(1), fabs(E))) {
+                break;
+            }
+        }
+        return E + turns * two_pi;
+    }
+
+    /**
+     * @brief Solve the hyperbolic Kepler equation e*sinh(H) - H = M.
+     *
+     * The root always lies in [asinh(|M|/e), asinh(|M|/(e-1))], because H <= |M|/(e-1) implies e*sinh(H) <= |M|/(e-1)
+     * and the left side of the equation is monotonic. The Danby starter H0 = ln(2|M|/e + 1.8) is clamped into that
+     * bracket and refined by Halley iterations, falling back to bisection whenever a step leaves the (shrinking)
+     * bracket. Unlike a fixed [-pi, pi] bracket this stays valid for arbitrarily large mean anomalies.
+     *
+     * @tparam Scalar Floating point like type.
+     * @param M_anomaly Mean anomaly.
+     * @param e Eccentricity.
+     * @return Scalar Hyperbolic eccentric anomaly.
+     */
+    template <typename Scalar>
+    Scalar solve_hyperbolic_kepler(Scalar M_anomaly, Scalar e) {
+        constexpr size_t max_iter = 64;
+        Scalar const M = fabs(M_anomaly);
+        Scalar low = asinh(M / e);
+        Scalar high = asinh(M / (e - 1));
+
+        Scalar H = math::in_range(low, static_cast<Scalar>(log(2 * M / e + 1.8)), high);
+        for (size_t i = 0; i < max_iter; ++i) {
+            Scalar e_sinh = e * sinh(H);
+            Scalar f = e_sinh - H - M;
+            if (f > 0) {
+                high = H;
+            } else {
+                low = H;
+            }
+            Scalar df = e * cosh(H) - 1;
+            Scalar H_new = H - f / (df - 0.5 * f * e_sinh / df);
+            if (!(low < H_new && H_new < high)) {
+                H_new = 0.5 * (low + high);
+            }
+            Scalar dH = H_new - H;
+            H = H_new;
+            if (fabs(dH) <= 4 * math::epsilon<Scalar>::value * math::max(static_cast<Scalar>(1), H)) {
+                break;
+            }
+        }
+        return M_anomaly >= 0 ? H : -H;
+    }
+
+    /**
+     * @brief Solve the parabolic Kepler(Barker) equation D + D^3/3 = M analytically.
+     *
+     * @tparam Scalar Floating point like type.
+     * @param M_anomaly Mean anomaly.
+     * @return Scalar Parabolic anomaly D = tan(nu/2).
+     */
+    template <typename Scalar>
+    Scalar solve_parabolic_kepler(Scalar M_anomaly) {
+        Scalar const M = fabs(M_anomaly);
+        Scalar y = cbrt(1.5 * M + sqrt(2.25 * M * M + 1));
+        Scalar D = y - 1 / y;
+        return M_anomaly >= 0 ? D : -D;
+    }
+
     /**
      * @brief Calculate the corresponding eccentric anomaly of the mean anomaly.
      *
@@ -323,14 +417,11 @@ namespace hub::orbit {
         }
 
         if (0 <= e && e < 1)
-            return math::root_bisection([=](Scalar x) -> Scalar { return (x - e * sin(x) - M_anomaly); },
-                                        -hub::consts::pi, hub::consts::pi);
+            return solve_elliptic_kepler(M_anomaly, e);
         else if (e > 1)
-            return math::root_bisection([=](Scalar x) -> Scalar { return (e * sinh(x) - x - M_anomaly); },
-                                        -hub::consts::pi, hub::consts::pi);
+            return solve_hyperbolic_kepler(M_anomaly, e);
         else if (fabs(e - 1) < math::epsilon<Scalar>::value)
-            return math::root_bisection([=](Scalar x) -> Scalar { return (x + x * x * x / 3 - M_anomaly); },
-                                        -hub::consts::pi, hub::consts::pi);
+            return solve_parabolic_kepler(M_anomaly);
         else {
             spacehub_abort("Eccentricity cannot be negative, Nan or inf!");
         }
@@ -349,6 +440,48 @@ namespace hub::orbit {
         return E_anomaly_to_T_anomaly(M_anomaly_to_E_anomaly(M_anomaly, e), e);
     }
 
+    /**
+     * @brief Calculate the corresponding eccentric anomalies of arrays of mean anomalies and eccentricities.
+     *
+     * @tparam ScalarArray1 Type of the mean anomaly array.
+     * @tparam ScalarArray2 Type of the eccentricity array.
+     * @tparam ScalarArray3 Type of the output array.
+     * @param[in] M_anomaly Mean anomalies.
+     * @param[in] e Eccentricities.
+     * @param[out] E_anomaly Eccentric anomalies.
+     * @note The memory of E_anomaly need to be allocated in advance. The size of the input arrays need to be the same.
+     */
+    template <typename ScalarArray1, typename ScalarArray2, typename ScalarArray3>
+    void M_anomaly_to_E_anomaly(ScalarArray1 const &M_anomaly, ScalarArray2 const &e, ScalarArray3 &E_anomaly) {
+        DEBUG_MODE_ASSERT(M_anomaly.size() == e.size() && E_anomaly.size() >= M_anomaly.size(),
+                          "length of the array mismatch!");
+        size_t const size = M_anomaly.size();
+        for (size_t i = 0; i < size; ++i) {
+            E_anomaly[i] = M_anomaly_to_E_anomaly(M_anomaly[i], e[i]);
+        }
+    }
+
+    /**
+     * @brief Calculate the corresponding true anomalies of arrays of mean anomalies and eccentricities.
+     *
+     * @tparam ScalarArray1 Type of the mean anomaly array.
+     * @tparam ScalarArray2 Type of the eccentricity array.
+     * @tparam ScalarArray3 Type of the output array.
+     * @param[in] M_anomaly Mean anomalies.
+     * @param[in] e Eccentricities.
+     * @param[out] T_anomaly True anomalies.
+     * @note The memory of T_anomaly need to be allocated in advance. The size of the input arrays need to be the same.
+     */
+    template <typename ScalarArray1, typename ScalarArray2, typename ScalarArray3>
+    void M_anomaly_to_T_anomaly(ScalarArray1 const &M_anomaly, ScalarArray2 const &e, ScalarArray3 &T_anomaly) {
+        DEBUG_MODE_ASSERT(M_anomaly.size() == e.size() && T_anomaly.size() >= M_anomaly.size(),
+                          "length of the array mismatch!");
+        size_t const size = M_anomaly.size();
+        for (size_t i = 0; i < size; ++i) {
+            T_anomaly[i] = M_anomaly_to_T_anomaly(M_anomaly[i], e[i]);
+        }
+    }
+
     /**
      * @brief Calculate the corresponding eccentric anomaly of the true anomaly.
      *
@@ -827,6 +960,59 @@ namespace hub::orbit {
         }
     }
 
+    /**
+     * @brief Advance the relative position and velocity of a two-body orbit by the given time.
+     *
+     * The new state is obtained with the Lagrange f and g functions of the eccentric(hyperbolic) anomaly, so no
+     * orbital angles are involved and circular or planar orbits need no special treatment. Parabolic orbits are not
+     * supported.
+     *
+     * @tparam Scalar Floating point like type.
+     * @tparam Vector 3D vector type.
+     * @param[in] u Standard gravitational parameter G(m1+m2).
+     * @param[in,out] dr Relative position.
+     * @param[in,out] dv Relative velocity.
+     * @param[in] dt Time to advance, can be negative.
+     */
+    template <typename Scalar, typename Vector>
+    void kepler_advance(Scalar u, Vector &dr, Vector &dv, Scalar dt) {
+        Scalar r0 = norm(dr);
+        Scalar a = -u / (norm2(dv) - 2 * u / r0);
+        Scalar e_cos = 1 - r0 / a;
+        Scalar rv = dot(dr, dv);
+        Scalar f, g, df, dg;
+        if (a > 0) {
+            Scalar sqrt_ua = sqrt(u * a);
+            Scalar e_sin = rv / sqrt_ua;
+            Scalar n = sqrt(u / (a * a * a));
+            Scalar E0 = atan2(e_sin, e_cos);
+            Scalar e = sqrt(e_cos * e_cos + e_sin * e_sin);
+            Scalar E1 = solve_elliptic_kepler(E0 - e_sin + n * dt, e);
+            Scalar dE = E1 - E0;
+            Scalar r1 = a * (1 - e * cos(E1));
+            f = 1 - a / r0 * (1 - cos(dE));
+            g = dt - (dE - sin(dE)) / n;
+            df = -sqrt_ua * sin(dE) / (r0 * r1);
+            dg = 1 - a / r1 * (1 - cos(dE));
+        } else {
+            Scalar sqrt_ua = sqrt(-u * a);
+            Scalar e_sinh = rv / sqrt_ua;
+            Scalar n = sqrt(-u / (a * a * a));
+            Scalar H0 = atanh(e_sinh / e_cos);
+            Scalar e = sqrt(e_cos * e_cos - e_sinh * e_sinh);
+            Scalar H1 = solve_hyperbolic_kepler(e_sinh - H0 + n * dt, e);
+            Scalar dH = H1 - H0;
+            Scalar r1 = a * (1 - e * cosh(H1));
+            f = 1 - a / r0 * (1 - cosh(dH));
+            g = dt - (sinh(dH) - dH) / n;
+            df = -sqrt_ua * sinh(dH) / (r0 * r1);
+            dg = 1 - a / r1 * (1 - cosh(dH));
+        }
+        Vector r = f * dr + g * dv;
+        dv = df * dr + dg * dv;
+        dr = r;
+    }
+
     template <typename Scalar>
     auto tidal_factor(Scalar r, Scalar m_tot1, Scalar m_tot2, Scalar R1, Scalar R2) {
         auto ratio1 = R1 / r;
@@ -26,6 +26,7 @@ License
 
 #include "../type-class.hpp"
 #include "chain.hpp"
+#include "diagnostics.hpp"
 #include "regu-system.hpp"
 namespace hub::system {
 
@@ -61,6 +62,15 @@ namespace hub::system {
         template <CONCEPT_PARTICLE_CONTAINER STL>
         ARchainSystem(Scalar time, STL const &particle_set);
 
+        /**
+         * @brief Reinitialize the system with a new particle set, reusing the allocated memory.
+         *
+         * @param[in] time Initial time of the system.
+         * @param[in] particle_set Input particle set.
+         */
+        template <CONCEPT_PARTICLE_CONTAINER STL>
+        void reset(Scalar time, STL const &particle_set);
+
         // Public methods
         SPACEHUB_ARRAY_ACCESSOR(StateVectorArray, chain_pos, chain_pos_);
 
@@ -102,6 +112,17 @@ namespace hub::system {
 
         inline void collect_increment(bool sync) { sync_increment_ = sync; };
 
+        /**
+         * @brief Energy and angular momentum of the current state. Recomputed only if the state changed since the
+         * last query; the potential energy of the last kick is reused.
+         */
+        Diagnostics<TypeSet> const &diagnostics() const;
+
+        /**
+         * @brief Drop the cached diagnostics after modifying the state through the pos()/vel() accessors.
+         */
+        inline void invalidate_diagnostics() { diag_.invalidate(); };
+
         inline constexpr size_t time_offset() const { return 0; };
 
         inline constexpr size_t pos_offset() const { return 1; };
@@ -179,6 +200,8 @@ namespace hub::system {
 
         StateScalarArray increment_;
 
+        mutable Diagnostics<TypeSet> diag_;
+
         bool sync_increment_{false};
 
         CREATE_MEMBER_CHECK(err);
@@ -208,6 +231,38 @@ namespace hub::system {
         }
         regu_ = std::move(
             Regularization<TypeSet, RegType>{*this});  // re-construct the regularization with chain coordinates
+        diag_.reset(*this);
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, ReguType RegType>
+    template <CONCEPT_PARTICLE_CONTAINER STL>
+    void ARchainSystem<Particles, Interactions, RegType>::reset(Scalar time, const STL &particle_set) {
+        size_t const num = particle_set.size();
+        Particles::assign(time, particle_set);
+        accels_.resize(num);
+        chain_pos_.resize(num);
+        chain_vel_.resize(num);
+        chain_acc_.resize(num);
+        index_.resize(num);
+        new_index_.resize(num);
+        increment_.resize(this->variable_number());
+        calc::array_set_zero(increment_);
+        Chain::calc_chain_index(this->pos(), index_);
+        Chain::calc_chain(this->pos(), chain_pos(), index());
+        Chain::calc_chain(this->vel(), chain_vel(), index());
+        if constexpr (Interactions::ext_vel_dep) {
+            aux_vel_ = this->vel();
+            chain_aux_vel_ = chain_vel_;
+        }
+        regu_ = Regularization<TypeSet, RegType>{*this};
+        sync_increment_ = false;
+        diag_.reset(*this);
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, ReguType RegType>
+    auto ARchainSystem<Particles, Interactions, RegType>::diagnostics() const -> Diagnostics<TypeSet> const & {
+        diag_.update(*this);
+        return diag_;
     }
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, ReguType RegType>
@@ -218,6 +273,7 @@ namespace hub::system {
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, ReguType RegType>
     void ARchainSystem<Particles, Interactions, RegType>::drift(Scalar step_size) {
+        diag_.invalidate();
         Scalar phy_time = regu_.eval_pos_phy_time(*this, step_size);
         chain_advance(this->pos(), chain_pos(), chain_vel(), phy_time);
         this->time() += phy_time;
@@ -227,11 +283,12 @@ namespace hub::system {
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, ReguType RegType>
     void ARchainSystem<Particles, Interactions, RegType>::kick(Scalar step_size) {
-        Scalar phy_time = regu_.eval_vel_phy_time(*this, step_size);
-        Scalar half_time = 0.5 * phy_time;
-
+        diag_.invalidate_velocity();
         eval_vel_indep_acc();
 
+        Scalar phy_time = regu_.eval_vel_phy_time_from_potential(accels_.newtonian_potential(), step_size);
+        Scalar half_time = 0.5 * phy_time;
+
         if constexpr (Interactions::ext_vel_dep) {
             kick_real_vel(half_time);
             kick_pseu_vel(phy_time);
@@ -262,13 +319,13 @@ namespace hub::system {
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, ReguType RegType>
     void ARchainSystem<Particles, Interactions, RegType>::post_iter_process() {
-        Chain::calc_chain_index(this->pos(), new_index_);
-        if (new_index_ != index_) {
+        if (Chain::refresh_chain_index(this->pos(), chain_pos_, index_, new_index_)) {
             Chain::update_chain(chain_pos_, this->pos(), index_, new_index_);
             Chain::calc_cartesian(this->mass(), chain_pos_, this->pos(), new_index_);
             Chain::update_chain(chain_vel_, this->vel(), index_, new_index_);
             Chain::calc_cartesian(this->mass(), chain_vel_, this->vel(), new_index_);
             index_ = new_index_;
+            diag_.invalidate();
         }
     }
 
@@ -297,11 +354,14 @@ namespace hub::system {
         dy_dh.reserve(this->variable_number());
 
         Scalar pos_regu = regu_.eval_pos_phy_time(*this, 1);
-        Scalar vel_regu = regu_.eval_vel_phy_time(*this, 1);
 
-        dy_dh.emplace_back(pos_regu);
+        Interactions::eval_newtonian_acc(*this, accels_.newtonian_acc(), accels_.newtonian_potential());
 
-        Interactions::eval_newtonian_acc(*this, accels_.newtonian_acc());
+        diag_.set_potential_energy(accels_.newtonian_potential());
+
+        Scalar vel_regu = regu_.eval_vel_phy_time_from_potential(accels_.newtonian_potential(), 1);
+
+        dy_dh.emplace_back(pos_regu);
         if constexpr (Interactions::ext_vel_indep || Interactions::ext_vel_dep) {
             Interactions::eval_extra_acc(*this, accels_.acc());
             calc::array_add(accels_.acc(), accels_.acc(), accels_.newtonian_acc());
@@ -385,6 +445,7 @@ namespace hub::system {
 
             Chain::calc_cartesian(this->mass(), chain_pos_, this->pos(), index());
             Chain::calc_cartesian(this->mass(), chain_vel_, this->vel(), index());
+            diag_.invalidate();
 
             if constexpr (Interactions::ext_vel_dep) {
                 auto aux_vel_begin = begin + auxi_vel_offset();
@@ -428,7 +489,8 @@ namespace hub::system {
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, ReguType RegType>
     void ARchainSystem<Particles, Interactions, RegType>::eval_vel_indep_acc() {
-        Interactions::eval_newtonian_acc(*this, accels_.newtonian_acc());
+        Interactions::eval_newtonian_acc(*this, accels_.newtonian_acc(), accels_.newtonian_potential());
+        diag_.set_potential_energy(accels_.newtonian_potential());
 
         if constexpr (Interactions::ext_vel_indep) {
             Interactions::eval_extra_vel_indep_acc(*this, accels_.ext_vel_indep_acc());
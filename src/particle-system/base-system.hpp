@@ -30,6 +30,7 @@ License
 #include "../interaction/interaction.hpp"
 #include "../spacehub-concepts.hpp"
 #include "../type-class.hpp"
+#include "diagnostics.hpp"
 namespace hub::system {
 
     /*---------------------------------------------------------------------------*\
@@ -71,6 +72,15 @@ namespace hub::system {
         SimpleSystem(Scalar time, STL const &particle_set);
 
         // Public methods
+        /**
+         * @brief Reinitialize the system with a new particle set, reusing the allocated memory.
+         *
+         * @param[in] time Initial time of the system.
+         * @param[in] particle_set Input particle set.
+         */
+        template <CONCEPT_PARTICLE_CONTAINER STL>
+        void reset(Scalar time, STL const &particle_set);
+
         /**
          *
          * @param acceleration
@@ -78,6 +88,39 @@ namespace hub::system {
         template <typename GenVectorArray>
         void evaluate_acc(GenVectorArray &acceleration) const;
 
+        /**
+         * @brief Evaluate the acceleration of the active particles only, from all particles.
+         *
+         * @param[in] active Indices of the active particles.
+         * @param[out] acceleration Acceleration array, only the entries of the active particles are written.
+         */
+        template <typename GenVectorArray>
+        void evaluate_acc(IdxArray const &active, GenVectorArray &acceleration) const;
+
+        /**
+         * @brief Evaluate the acceleration and jerk of the active particles, from all particles.
+         *
+         * @param[in] active Indices of the active particles.
+         * @param[out] acceleration Acceleration array, only the entries of the active particles are written.
+         * @param[out] jerk Jerk array, only the entries of the active particles are written.
+         */
+        template <typename GenVectorArray>
+        void evaluate_acc_and_jerk(IdxArray const &active, GenVectorArray &acceleration, GenVectorArray &jerk) const;
+
+        /**
+         * @brief Evaluate the acceleration, jerk and snap of the active particles, from all particles.
+         *
+         * @param[in] pred_acc Accelerations of all particles at the current state.
+         * @param[in] active Indices of the active particles.
+         * @param[out] acceleration Acceleration array, only the entries of the active particles are written.
+         * @param[out] jerk Jerk array, only the entries of the active particles are written.
+         * @param[out] snap Snap array, only the entries of the active particles are written.
+         */
+        template <typename GenVectorArray>
+        void evaluate_acc_jerk_and_snap(GenVectorArray const &pred_acc, IdxArray const &active,
+                                        GenVectorArray &acceleration, GenVectorArray &jerk,
+                                        GenVectorArray &snap) const;
+
         /**
          *
          * @param step_size
@@ -118,6 +161,17 @@ namespace hub::system {
         template <typename ScalarIterable>
         void evaluate_general_derivative(ScalarIterable &dy_dh);
 
+        /**
+         * @brief Energy and angular momentum of the current state. Recomputed only if the state changed since the
+         * last query.
+         */
+        Diagnostics<TypeSet> const &diagnostics() const;
+
+        /**
+         * @brief Drop the cached diagnostics after modifying the state through the pos()/vel() accessors.
+         */
+        inline void invalidate_diagnostics() { diag_.invalidate(); };
+
         inline void collect_increment(bool sync) { sync_increment_ = sync; };
 
         void clear_increment() { calc::array_set_zero(increment_); };
@@ -177,6 +231,8 @@ namespace hub::system {
 
         std::conditional_t<Interactions::ext_vel_dep, StateVectorArray, Empty> aux_vel_;
 
+        mutable Diagnostics<TypeSet> diag_;
+
         bool sync_increment_{false};
     };
 }  // namespace hub::system
@@ -192,6 +248,27 @@ namespace hub::system {
         if constexpr (Interactions::ext_vel_dep) {
             aux_vel_ = this->vel();
         }
+        diag_.reset(*this);
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    template <CONCEPT_PARTICLE_CONTAINER STL>
+    void SimpleSystem<Particles, Interactions>::reset(Scalar time, const STL &particle_set) {
+        Particles::assign(time, particle_set);
+        accels_.resize(particle_set.size());
+        increment_.resize(this->variable_number());
+        calc::array_set_zero(increment_);
+        if constexpr (Interactions::ext_vel_dep) {
+            aux_vel_ = this->vel();
+        }
+        sync_increment_ = false;
+        diag_.reset(*this);
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    auto SimpleSystem<Particles, Interactions>::diagnostics() const -> Diagnostics<TypeSet> const & {
+        diag_.update(*this);
+        return diag_;
     }
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
@@ -208,6 +285,7 @@ namespace hub::system {
 
             load_to_coords(pos_begin, pos_end, this->pos());
             load_to_coords(vel_begin, vel_end, this->vel());
+            diag_.invalidate();
             if constexpr (Interactions::ext_vel_dep) {
                 auto aux_vel_begin = begin + auxi_vel_offset();
                 auto aux_vel_end = y.end();
@@ -259,6 +337,7 @@ namespace hub::system {
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
     void SimpleSystem<Particles, Interactions>::kick(Scalar step_size) {
+        diag_.invalidate_velocity();
         if constexpr (Interactions::ext_vel_dep) {
             Scalar half_step = 0.5 * step_size;
 
@@ -276,6 +355,7 @@ namespace hub::system {
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
     void SimpleSystem<Particles, Interactions>::drift(Scalar step_size) {
+        diag_.invalidate();
         this->time() += step_size;
         calc::array_advance(this->pos(), this->vel(), step_size);
         sync_time_increment(step_size);
@@ -288,6 +368,31 @@ namespace hub::system {
         Interactions::eval_acc(*this, acceleration);
     }
 
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    template <typename GenVectorArray>
+    void SimpleSystem<Particles, Interactions>::evaluate_acc(IdxArray const &active,
+                                                             GenVectorArray &acceleration) const {
+        Interactions::eval_acc(*this, active, acceleration);
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    template <typename GenVectorArray>
+    void SimpleSystem<Particles, Interactions>::evaluate_acc_and_jerk(IdxArray const &active,
+                                                                      GenVectorArray &acceleration,
+                                                                      GenVectorArray &jerk) const {
+        Interactions::eval_acc_and_jerk(*this, active, acceleration, jerk);
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    template <typename GenVectorArray>
+    void SimpleSystem<Particles, Interactions>::evaluate_acc_jerk_and_snap(GenVectorArray const &pred_acc,
+                                                                           IdxArray const &active,
+                                                                           GenVectorArray &acceleration,
+                                                                           GenVectorArray &jerk,
+                                                                           GenVectorArray &snap) const {
+        Interactions::eval_acc_jerk_and_snap(*this, pred_acc, active, acceleration, jerk, snap);
+    }
+
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
     void SimpleSystem<Particles, Interactions>::kick_real_vel(Scalar step_size) {
         std::swap(aux_vel_, this->vel());
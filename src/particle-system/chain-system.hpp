@@ -29,6 +29,7 @@ License
 #include "../core-computation.hpp"
 #include "../type-class.hpp"
 #include "chain.hpp"
+#include "diagnostics.hpp"
 namespace hub::system {
 
     /*---------------------------------------------------------------------------*\
@@ -91,6 +92,17 @@ namespace hub::system {
         template <typename ScalarIterable>
         void evaluate_general_derivative(ScalarIterable &dy_dh);
 
+        /**
+         * @brief Energy and angular momentum of the current state. Recomputed only if the state changed since the
+         * last query.
+         */
+        Diagnostics<TypeSet> const &diagnostics() const;
+
+        /**
+         * @brief Drop the cached diagnostics after modifying the state through the pos()/vel() accessors.
+         */
+        inline void invalidate_diagnostics() { diag_.invalidate(); };
+
         inline void collect_increment(bool sync) { sync_increment_ = sync; };
 
         void clear_increment() { calc::array_set_zero(increment_); };
@@ -147,6 +159,8 @@ namespace hub::system {
         std::conditional_t<Interactions::ext_vel_dep, StateVectorArray, Empty> aux_vel_;
         std::conditional_t<Interactions::ext_vel_dep, StateVectorArray, Empty> chain_aux_vel_;
 
+        mutable Diagnostics<TypeSet> diag_;
+
         bool sync_increment_{false};
     };
 
@@ -172,6 +186,13 @@ namespace hub::system {
             aux_vel_ = this->vel();
             chain_aux_vel_ = chain_vel_;
         }
+        diag_.reset(*this);
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    auto ChainSystem<Particles, Interactions>::diagnostics() const -> Diagnostics<TypeSet> const & {
+        diag_.update(*this);
+        return diag_;
     }
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
@@ -182,6 +203,7 @@ namespace hub::system {
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
     void ChainSystem<Particles, Interactions>::drift(Scalar step_size) {
+        diag_.invalidate();
         this->time() += step_size;
         chain_advance(this->pos(), chain_pos(), chain_vel(), step_size);
         sync_time_increment(step_size);
@@ -190,6 +212,7 @@ namespace hub::system {
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
     void ChainSystem<Particles, Interactions>::kick(Scalar step_size) {
+        diag_.invalidate_velocity();
         if constexpr (Interactions::ext_vel_dep) {
             Scalar half_step = 0.5 * step_size;
 
@@ -216,13 +239,13 @@ namespace hub::system {
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
     void ChainSystem<Particles, Interactions>::post_iter_process() {
-        Chain::calc_chain_index(this->pos(), new_index_);
-        if (new_index_ != index_) {
+        if (Chain::refresh_chain_index(this->pos(), chain_pos_, index_, new_index_)) {
             Chain::update_chain(chain_pos_, this->pos(), index_, new_index_);
             Chain::calc_cartesian(this->mass(), chain_pos_, this->pos(), new_index_);
             Chain::update_chain(chain_vel_, this->vel(), index_, new_index_);
             Chain::calc_cartesian(this->mass(), chain_vel_, this->vel(), new_index_);
             index_ = new_index_;
+            diag_.invalidate();
         }
     }
 
@@ -270,6 +293,7 @@ namespace hub::system {
 
             Chain::calc_cartesian(this->mass(), chain_pos_, this->pos(), index_);
             Chain::calc_cartesian(this->mass(), chain_vel_, this->vel(), index_);
+            diag_.invalidate();
             if constexpr (Interactions::ext_vel_dep) {
                 auto aux_vel_begin = begin + auxi_vel_offset();
                 auto aux_vel_end = y.end();
@@ -25,7 +25,7 @@ License
 #pragma once
 
 #include <algorithm>
-#include <list>
+#include <limits>
 #include <vector>
 
 #include "../core-computation.hpp"
@@ -41,28 +41,6 @@ namespace hub {
      */
     class Chain {
        public:
-        /**
-         * @brief Node used to create chain index.
-         */
-        struct Node {
-            /**
-             * @brief Relative distance between two particles.
-             */
-            double r;
-            /**
-             * @brief The index of the first particle.
-             */
-            size_t i;
-            /**
-             * @brief The index of the second particle.
-             */
-            size_t j;
-            /**
-             * @brief Flag indicates if this node has been added to the chain.
-             */
-            bool avail;
-        };
-
         // Constructors
         SPACEHUB_MAKE_CONSTRUCTORS(Chain, default, default, default, default, default);
 
@@ -79,6 +57,54 @@ namespace hub {
         template <typename VectorArray, typename IdxArray>
         static void calc_chain_index(VectorArray const &pos, IdxArray &index);
 
+        /**
+         * @brief Locally repair an existing chain index instead of rebuilding it.
+         *
+         * Neighbours along the chain are swapped whenever that shortens the chain, which fixes the common case of two
+         * particles passing each other in O(N) per sweep. The result is a valid chain but not necessarily the one
+         * calc_chain_index() would build from scratch.
+         *
+         * @tparam VectorArray Type of the Structure of Array coordinates.
+         * @tparam IdxArray Type of the index array.
+         * @param[in] pos Input position in Cartesian coordinates.
+         * @param[in,out] index Chain index array to be repaired.
+         * @return true If the index has been changed.
+         */
+        template <typename VectorArray, typename IdxArray>
+        static bool repair_chain_index(VectorArray const &pos, IdxArray &index);
+
+        /**
+         * @brief Check if the chain is still acceptable, using only the chain vectors.
+         *
+         * The chain is considered broken if any particle is closer to its second neighbour along the chain than the
+         * longer of the two links in between, i.e. a non-chained distance became shorter than a chained one next to it.
+         * This costs O(N) and needs no Cartesian coordinates.
+         *
+         * @tparam VectorArray Type of the Structure of Array coordinates.
+         * @param[in] chain The chain coordinates.
+         * @return true If the chain does not need to be rebuilt.
+         */
+        template <typename VectorArray>
+        static bool is_valid_chain(VectorArray const &chain);
+
+        /**
+         * @brief Find the chain index for the current positions, rebuilding it only if the current chain is broken.
+         *
+         * A broken chain is first repaired locally by repair_chain_index(), and rebuilt with calc_chain_index() only if
+         * that does not fix it.
+         *
+         * @tparam VectorArray Type of the Structure of Array coordinates.
+         * @tparam IdxArray Type of the index array.
+         * @param[in] pos Input position in Cartesian coordinates.
+         * @param[in] chain The chain coordinates under current index.
+         * @param[in] index Current chain index array.
+         * @param[out] new_index New chain index array. Only meaningful if returns true.
+         * @return true If the new index is different from the current one.
+         */
+        template <typename VectorArray, typename IdxArray>
+        static bool refresh_chain_index(VectorArray const &pos, VectorArray const &chain, IdxArray const &index,
+                                        IdxArray &new_index);
+
         /**
          * @brief Update the chain coordinates from old index array to new index array.
          *
@@ -131,19 +157,36 @@ namespace hub {
         static constexpr bool bijective_transfer{true};
 
        private:
-        template <typename T>
-        static bool not_in_list(std::list<T> &list, T var);
-
-        template <typename InsertOpt>
-        static bool try_insert(std::list<size_t> &list, size_t &chain_end, Node &n, size_t idx, InsertOpt insert);
+        /**
+         * @brief Reusable work space of the chain builder, so that rebuilding the chain does not allocate.
+         */
+        struct BuildBuffer {
+            std::vector<double> head_dist;
+            std::vector<double> tail_dist;
+            std::vector<size_t> order;
+            std::vector<size_t> inverse;
+            std::vector<bool> chained;
+
+            void reset(size_t num) {
+                head_dist.resize(num);
+                tail_dist.resize(num);
+                order.resize(2 * num);
+                chained.assign(num, false);
+            }
+        };
 
-        static bool try_add_to_chain(std::list<size_t> &list, size_t &head, size_t &tail, Node &n);
+        static inline BuildBuffer &build_buffer() {
+            static thread_local BuildBuffer buffer;
+            return buffer;
+        }
 
-        template <typename VectorArray, typename Container>
-        static void create_distances_array(VectorArray const &pos, Container &vec);
+        static inline bool is_shortcut(double r1, double r2, double r_skip) { return r_skip < math::max(r1, r2); }
 
-        template <typename IdxArray>
-        static void create_index_from_dist_array(std::vector<Node> &dist, IdxArray &idx, size_t num);
+        template <typename Vector>
+        static double distance2(Vector const &a, Vector const &b) {
+            auto dr = b - a;
+            return static_cast<double>(dr.x * dr.x + dr.y * dr.y + dr.z * dr.z);
+        }
 
         template <typename VectorArray>
         static auto get_new_node(VectorArray const &chain, size_t head, size_t tail) ->
@@ -163,38 +206,179 @@ namespace hub {
     \*---------------------------------------------------------------------------*/
     template <typename VectorArray, typename IdxArray>
     void Chain::calc_chain_index(VectorArray const &pos, IdxArray &index) {
-        std::vector<Node> dist;
-        create_distances_array(pos, dist);
-        std::sort(dist.begin(), dist.end(), [&](Node const &ni, Node const &nj) { return (ni.r < nj.r); });
-        create_index_from_dist_array(dist, index, pos.size());
+        // Greedy nearest neighbour chain: start from the closest pair, then repeatedly attach the unchained particle
+        // closest to either end. Each end keeps the distances from itself to all particles, so every attachment is
+        // one O(N) scan instead of a search through all sorted pairs.
+        size_t const num = pos.size();
+        index.resize(num);
+        if (num < 2) {
+            if (num == 1) index[0] = 0;
+            return;
+        }
+
+        auto &buf = build_buffer();
+        buf.reset(num);
+
+        size_t head = 0;
+        size_t tail = 1;
+        double r_min = std::numeric_limits<double>::max();
+        for (size_t i = 0; i < num; ++i) {
+            for (size_t j = i + 1; j < num; ++j) {
+                double r2 = distance2(pos[i], pos[j]);
+                if (r2 < r_min) {
+                    r_min = r2, head = i, tail = j;
+                }
+            }
+        }
+
+        size_t front = num;
+        size_t back = num + 1;
+        buf.order[front] = head;
+        buf.order[back] = tail;
+        buf.chained[head] = buf.chained[tail] = true;
+
+        for (size_t j = 0; j < num; ++j) {
+            buf.head_dist[j] = distance2(pos[head], pos[j]);
+            buf.tail_dist[j] = distance2(pos[tail], pos[j]);
+        }
+
+        for (size_t chained_num = 2; chained_num < num; ++chained_num) {
+            size_t head_next = num;
+            size_t tail_next = num;
+            double head_min = std::numeric_limits<double>::max();
+            double tail_min = std::numeric_limits<double>::max();
+            for (size_t j = 0; j < num; ++j) {
+                if (!buf.chained[j]) {
+                    if (buf.head_dist[j] < head_min) head_min = buf.head_dist[j], head_next = j;
+                    if (buf.tail_dist[j] < tail_min) tail_min = buf.tail_dist[j], tail_next = j;
+                }
+            }
+
+            if (head_min <= tail_min) {
+                head = head_next;
+                buf.order[--front] = head;
+                buf.chained[head] = true;
+                for (size_t j = 0; j < num; ++j) buf.head_dist[j] = distance2(pos[head], pos[j]);
+            } else {
+                tail = tail_next;
+                buf.order[++back] = tail;
+                buf.chained[tail] = true;
+                for (size_t j = 0; j < num; ++j) buf.tail_dist[j] = distance2(pos[tail], pos[j]);
+            }
+        }
+
+        for (size_t i = 0; i < num; ++i) {
+            index[i] = buf.order[front + i];
+        }
+    }
+
+    template <typename VectorArray, typename IdxArray>
+    bool Chain::repair_chain_index(VectorArray const &pos, IdxArray &index) {
+        size_t const num = index.size();
+        if (num < 3) return false;
+
+        auto dist = [&](size_t a, size_t b) { return sqrt(distance2(pos[index[a]], pos[index[b]])); };
+
+        bool changed = false;
+        for (size_t sweep = 0; sweep < num; ++sweep) {
+            bool swapped = false;
+            for (size_t k = 0; k + 1 < num; ++k) {
+                // Swapping k and k+1 keeps the link between them and changes the two links around them.
+                double old_len = 0;
+                double new_len = 0;
+                if (k > 0) {
+                    old_len += dist(k - 1, k);
+                    new_len += dist(k - 1, k + 1);
+                }
+                if (k + 2 < num) {
+                    old_len += dist(k + 1, k + 2);
+                    new_len += dist(k, k + 2);
+                }
+                if (new_len < old_len) {
+                    std::swap(index[k], index[k + 1]);
+                    swapped = changed = true;
+                }
+            }
+            if (!swapped) break;
+        }
+        return changed;
+    }
+
+    template <typename VectorArray>
+    bool Chain::is_valid_chain(VectorArray const &chain) {
+        size_t const links = chain.size() - 1;
+        for (size_t k = 0; k + 1 < links; ++k) {
+            double r1 = static_cast<double>(norm2(chain[k]));
+            double r2 = static_cast<double>(norm2(chain[k + 1]));
+            double r_skip = static_cast<double>(norm2(chain[k] + chain[k + 1]));
+            if (is_shortcut(r1, r2, r_skip)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename VectorArray, typename IdxArray>
+    bool Chain::refresh_chain_index(VectorArray const &pos, VectorArray const &chain, IdxArray const &index,
+                                    IdxArray &new_index) {
+        if (chain.size() < 3 || is_valid_chain(chain)) {
+            return false;
+        }
+
+        new_index = index;
+        if (repair_chain_index(pos, new_index)) {
+            bool broken = false;
+            size_t const links = new_index.size() - 1;
+            for (size_t k = 0; k + 1 < links && !broken; ++k) {
+                double r1 = distance2(pos[new_index[k]], pos[new_index[k + 1]]);
+                double r2 = distance2(pos[new_index[k + 1]], pos[new_index[k + 2]]);
+                broken = is_shortcut(r1, r2, distance2(pos[new_index[k]], pos[new_index[k + 2]]));
+            }
+            if (!broken) {
+                return true;
+            }
+        }
+
+        calc_chain_index(pos, new_index);
+        return new_index != index;
     }
 
     template <typename VectorArray, typename IdxArray>
     void Chain::update_chain(VectorArray &chain, VectorArray const &cartesian, const IdxArray &idx,
                              const IdxArray &new_idx) {
         using Vector = typename VectorArray::value_type;
-        // using Scalar = typename Vector::value_type;
 
-        size_t size = chain.size();
+        size_t const size = chain.size();
 
-        VectorArray new_chain;
-        new_chain.reserve(size);
+        // Position of each particle in the old chain, so that each new link is located in O(1).
+        auto &inverse = build_buffer().inverse;
+        inverse.resize(size);
+        for (size_t i = 0; i < size; ++i) {
+            inverse[idx[i]] = i;
+        }
 
-        auto get_idx = [&](auto var) -> auto { return std::find(idx.begin(), idx.end(), var) - idx.begin(); };
+        static thread_local VectorArray new_chain;
+        new_chain.resize(size);
 
         for (size_t i = 0; i < size - 1; ++i) {
-            auto first = get_idx(new_idx[i]);
-            auto last = get_idx(new_idx[i + 1]);
-            new_chain.emplace_back(get_new_node(chain, first, last));
+            size_t first = inverse[new_idx[i]];
+            size_t last = inverse[new_idx[i + 1]];
+            if (last == first + 1) {
+                new_chain[i] = chain[first];
+            } else if (first == last + 1) {
+                new_chain[i] = -chain[last];
+            } else {
+                new_chain[i] = get_new_node(chain, first, last);
+            }
         }
 
         if constexpr (!bijective_transfer) {
-            new_chain.emplace_back(Vector(0, 0, 0));
+            new_chain[size - 1] = Vector(0, 0, 0);
         } else {
-            new_chain.emplace_back(cartesian[new_idx[0]]);
+            new_chain[size - 1] = cartesian[new_idx[0]];
         }
 
-        chain = std::move(new_chain);
+        std::swap(chain, new_chain);
     }
 
     template <typename ScalarArray, typename VectorArray, typename IdxArray>
@@ -211,79 +395,6 @@ namespace hub {
         to_chain(cartesian, chain, index);
     }
 
-    template <typename T>
-    bool Chain::not_in_list(std::list<T> &list, T var) {
-        return list.end() == std::find(list.begin(), list.end(), var);
-    }
-
-    template <typename InsertOpt>
-    bool Chain::try_insert(std::list<size_t> &list, size_t &chain_end, Chain::Node &n, size_t idx, InsertOpt insert) {
-        n.avail = false;
-        if (not_in_list(list, idx)) {
-            insert(idx);
-            chain_end = idx;
-            return true;
-        } else {
-            return false;
-        }
-    }
-
-    bool Chain::try_add_to_chain(std::list<size_t> &list, size_t &head, size_t &tail, Chain::Node &n) {
-        if (head == n.i) {
-            return try_insert(list, head, n, n.j, [&](size_t idx) { list.emplace_front(idx); });
-        } else if (head == n.j) {
-            return try_insert(list, head, n, n.i, [&](size_t idx) { list.emplace_front(idx); });
-        } else if (tail == n.i) {
-            return try_insert(list, tail, n, n.j, [&](size_t idx) { list.emplace_back(idx); });
-        } else if (tail == n.j) {
-            return try_insert(list, tail, n, n.i, [&](size_t idx) { list.emplace_back(idx); });
-        }
-        return false;
-    }
-
-    template <typename VectorArray, typename Container>
-    void Chain::create_distances_array(VectorArray const &pos, Container &vec) {
-        size_t num = pos.size();
-        vec.reserve(num * (num - 1));
-        for (size_t i = 0; i < num; ++i) {
-            for (size_t j = i + 1; j < num; ++j) {
-                decltype(pos[j]) dr = (pos[j] - pos[i]);
-                decltype(dr.x) r2 = dr.x * dr.x + dr.y * dr.y + dr.z * dr.z;
-                vec.emplace_back(Node{r2, i, j, true});
-            }
-        }
-    }
-
-    template <typename IdxArray>
-    void Chain::create_index_from_dist_array(std::vector<Node> &dist, IdxArray &idx, size_t num) {
-        auto head = dist[0].i;
-        auto tail = dist[0].j;
-        dist[0].avail = false;
-
-        std::list<size_t> idx_list{head, tail};
-
-        size_t chained_num = 1;
-
-        size_t dist_size = dist.size();
-        for (size_t k = 1; k < dist_size; ++k) {
-            if (dist[k].avail) {
-                if (try_add_to_chain(idx_list, head, tail, dist[k])) {
-                    chained_num++;
-                    if (chained_num == num) {
-                        break;
-                    } else {
-                        k = 1;
-                    }
-                }
-            }
-        }
-
-        idx.clear();
-        for (auto &l : idx_list) {
-            idx.emplace_back(l);
-        }
-    }
-
     template <typename VectorArray>
     auto Chain::get_new_node(VectorArray const &chain, size_t head, size_t tail) -> typename VectorArray::value_type {
         using Vector = typename VectorArray::value_type;
@@ -0,0 +1,182 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file diagnostics.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include "../core-computation.hpp"
+
+namespace hub::system {
+    /*---------------------------------------------------------------------------*\
+        Class Diagnostics Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Cached conserved quantities (energy and angular momentum) of a particle system.
+     *
+     * The cache is owned by the particle system. The system tells the cache which part of its state has been
+     * modified (positions or velocities) and hands over the potential energy whenever a force pass already produced
+     * it. Everything that is not valid is recomputed lazily on the next query, so several callbacks asking for the
+     * energy of the same state only pay for one O(N^2) potential evaluation.
+     *
+     * Direct writes through the pos()/vel() accessors of the system are not tracked, call `invalidate()` after them.
+     *
+     * The initial energy is lazy too: reset() only records the masses, positions and kinetic energy of the initial
+     * state in O(N). Its potential energy is taken from the first potential of the unchanged initial positions, or
+     * evaluated from the recorded positions on the first initial_energy() query after they moved, so constructing or
+     * resetting a system never pays for an O(N^2) evaluation nobody asks for.
+     *
+     * @tparam TypeSystem The type system of the particle system.
+     */
+    template <typename TypeSystem>
+    class Diagnostics {
+       public:
+        SPACEHUB_USING_TYPE_SYSTEM_OF(TypeSystem);
+
+        /**
+         * @brief Refresh the stale entries of the cache against the current state of `particles`.
+         *
+         * @tparam Particles Type of the particle system.
+         * @param[in] particles The particle system that owns the cache.
+         */
+        template <typename Particles>
+        void update(Particles const &particles);
+
+        /**
+         * @brief Record the initial state for initial_energy(). Called by the system constructors and resets.
+         *
+         * @tparam Particles Type of the particle system.
+         * @param[in] particles The particle system that owns the cache.
+         */
+        template <typename Particles>
+        void reset(Particles const &particles);
+
+        /**
+         * @brief Hand over the potential energy of the current positions computed by a force pass.
+         *
+         * @param[in] potential The potential energy.
+         */
+        inline void set_potential_energy(Scalar potential) {
+            potential_energy_ = potential;
+            potential_valid_ = true;
+            settle_initial_energy();
+        }
+
+        /**
+         * @brief Positions (and thus everything) have changed.
+         */
+        inline void invalidate() { potential_valid_ = momenta_valid_ = initial_positions_ = false; }
+
+        /**
+         * @brief Only velocities have changed, the potential energy is kept.
+         */
+        inline void invalidate_velocity() { momenta_valid_ = false; }
+
+        SPACEHUB_READ_ACCESSOR(Scalar, potential_energy, potential_energy_);
+
+        SPACEHUB_READ_ACCESSOR(Scalar, kinetic_energy, kinetic_energy_);
+
+        SPACEHUB_READ_ACCESSOR(Vector, angular_momentum, angular_momentum_);
+
+        /**
+         * @brief Total energy of the state passed to the last reset().
+         */
+        Scalar initial_energy() const;
+
+        inline Scalar total_energy() const { return potential_energy_ + kinetic_energy_; }
+
+        inline Scalar energy_error() const {
+            Scalar E0 = initial_energy();
+            return fabs((total_energy() - E0) / E0);
+        }
+
+       private:
+        inline void settle_initial_energy() {
+            if (initial_pending_ && initial_positions_) {
+                initial_energy_ = potential_energy_ + initial_kinetic_energy_;
+                initial_pending_ = false;
+            }
+        }
+
+        ScalarArray initial_mass_;
+        StateVectorArray initial_pos_;
+        Scalar initial_kinetic_energy_{0};
+        Scalar potential_energy_{0};
+        Scalar kinetic_energy_{0};
+        Vector angular_momentum_{0, 0, 0};
+        mutable Scalar initial_energy_{0};
+        bool potential_valid_{false};
+        bool momenta_valid_{false};
+        /** The positions are still those of the last reset().*/
+        bool initial_positions_{false};
+        mutable bool initial_pending_{false};
+    };
+
+    /*---------------------------------------------------------------------------*\
+        Class Diagnostics Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename TypeSystem>
+    template <typename Particles>
+    void Diagnostics<TypeSystem>::update(const Particles &particles) {
+        if (!potential_valid_) {
+            potential_energy_ = calc::calc_potential_energy(particles);
+            potential_valid_ = true;
+            settle_initial_energy();
+        }
+        if (!momenta_valid_) {
+            kinetic_energy_ = calc::calc_kinetic_energy(particles);
+            // calc::calc_total_angular_momentum dispatches back to this cache, so the sum is spelled out here.
+            angular_momentum_ = Vector{0, 0, 0};
+            for (size_t i = 0; i < particles.number(); ++i) {
+                angular_momentum_ += particles.mass(i) * cross(particles.pos(i), particles.vel(i));
+            }
+            momenta_valid_ = true;
+        }
+    }
+
+    template <typename TypeSystem>
+    template <typename Particles>
+    void Diagnostics<TypeSystem>::reset(const Particles &particles) {
+        invalidate();
+        initial_mass_ = particles.mass();
+        initial_pos_ = particles.pos();
+        initial_kinetic_energy_ = calc::calc_kinetic_energy(particles);
+        initial_pending_ = initial_positions_ = true;
+    }
+
+    template <typename TypeSystem>
+    auto Diagnostics<TypeSystem>::initial_energy() const -> Scalar {
+        if (initial_pending_) {
+            // the positions moved before anybody asked, evaluate the potential of the recorded initial positions
+            Scalar potential{0};
+            size_t const size = initial_mass_.size();
+            for (size_t i = 0; i < size; ++i) {
+                for (size_t j = i + 1; j < size; ++j) {
+                    potential -= initial_mass_[i] * initial_mass_[j] / norm(initial_pos_[i] - initial_pos_[j]);
+                }
+            }
+            initial_energy_ = potential * consts::G + initial_kinetic_energy_;
+            initial_pending_ = false;
+        }
+        return initial_energy_;
+    }
+}  // namespace hub::system
@@ -0,0 +1,302 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file ensemble-system.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "../core-computation.hpp"
+#include "../spacehub-concepts.hpp"
+
+namespace hub::system {
+
+    /*---------------------------------------------------------------------------*\
+        Class LaneScalar Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief One scalar per lane of an ensemble. Arithmetic is lane-wise, in loops over a fixed length contiguous
+     * array that compilers map onto SIMD registers.
+     *
+     * @tparam T Underlying floating point type.
+     * @tparam Lanes Number of lanes.
+     */
+    template <typename T, size_t Lanes>
+    struct alignas(sizeof(T) * Lanes) LaneScalar {
+        T v[Lanes];
+
+        static constexpr size_t size() { return Lanes; }
+
+        inline T &operator[](size_t l) { return v[l]; }
+
+        inline T const &operator[](size_t l) const { return v[l]; }
+
+        /**
+         * @brief Set every lane to the same value.
+         */
+        inline void fill(T x) {
+            for (size_t l = 0; l < Lanes; ++l) v[l] = x;
+        }
+
+        friend inline LaneScalar operator*(T c, LaneScalar const &a) {
+            LaneScalar r;
+            for (size_t l = 0; l < Lanes; ++l) r.v[l] = c * a.v[l];
+            return r;
+        }
+
+        friend inline LaneScalar operator*(LaneScalar const &a, T c) { return c * a; }
+
+        friend inline LaneScalar operator/(LaneScalar const &a, T c) { return (1 / c) * a; }
+    };
+
+    /*---------------------------------------------------------------------------*\
+        Class EnsembleSystem Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Lanes independent Newtonian systems of N particles each, integrated in lockstep.
+     *
+     * The state is stored as an array of structures of arrays: for every particle index and component there is one
+     * LaneScalar holding that coordinate of all lanes, so the force loop and the drift/kick updates run over the
+     * lanes in the innermost loop. Every lane has its own time, and drift()/kick() take one step size per lane, so the
+     * lanes may advance with different steps; a lane stepped by zero stays untouched.
+     *
+     * The Scalar type of the system is the LaneScalar, which lets the symplectic integrators of hub::integrator drive
+     * an ensemble exactly as they drive a single system.
+     *
+     * The lane loops of the force pass only vectorize if the compiler may treat sqrt() as a pure function. Build the
+     * translation units using an ensemble with -fno-math-errno (implied by -ffast-math) to get the SIMD speed-up.
+     *
+     * @tparam TypeSystem Type class of SpaceHub.
+     * @tparam N Number of particles in each lane.
+     * @tparam Lanes Number of lanes, typically the SIMD width (4 for AVX2 or 8 for AVX-512 doubles).
+     */
+    template <typename TypeSystem, size_t N, size_t Lanes = 4>
+    class EnsembleSystem {
+       public:
+        // Type members
+        using TypeSet = TypeSystem;
+
+        using Real = typename TypeSystem::Scalar;
+
+        using Scalar = LaneScalar<Real, Lanes>;
+
+        /**
+         * @brief Coordinates of all lanes: x, y, z, vx, vy and vz of the N particles, in this order.
+         */
+        using State = std::array<Scalar, 6 * N>;
+
+        // static public members
+        static constexpr size_t number_of_particles{N};
+
+        static constexpr size_t lanes{Lanes};
+
+        // Constructors
+        EnsembleSystem();
+
+        // Public methods
+        SPACEHUB_ARRAY_ACCESSOR(State, state, state_);
+
+        SPACEHUB_READ_ACCESSOR(Scalar, time, time_);
+
+        inline Scalar &time() noexcept { return time_; };
+
+        inline Real time(size_t lane) const { return time_[lane]; };
+
+        [[nodiscard]] constexpr size_t number() const { return N; };
+
+        /**
+         * @brief Load an independent system into a lane.
+         *
+         * @tparam Particle Any particle type with mass, pos and vel members.
+         * @param[in] lane Lane index.
+         * @param[in] time Initial time of the lane.
+         * @param[in] particles N particles.
+         */
+        template <typename Particle>
+        void load(size_t lane, Real time, std::vector<Particle> const &particles);
+
+        /**
+         * @brief Write the current positions and velocities of a lane back to particles.
+         *
+         * @param[in] lane Lane index.
+         * @param[in,out] particles N particles, the masses are left untouched.
+         */
+        template <typename Particle>
+        void store(size_t lane, std::vector<Particle> &particles) const;
+
+        /**
+         * @brief Park an empty lane on a harmless massless configuration.
+         */
+        void clear(size_t lane);
+
+        /**
+         * @brief Total energy of a lane.
+         */
+        Real total_energy(size_t lane) const;
+
+        void drift(Scalar const &step_size);
+
+        void kick(Scalar const &step_size);
+
+        void pre_iter_process(){};
+
+        void post_iter_process(){};
+
+       private:
+        // Private methods
+        inline Scalar &x(size_t i) { return state_[i]; };
+        inline Scalar &y(size_t i) { return state_[N + i]; };
+        inline Scalar &z(size_t i) { return state_[2 * N + i]; };
+        inline Scalar &vx(size_t i) { return state_[3 * N + i]; };
+        inline Scalar &vy(size_t i) { return state_[4 * N + i]; };
+        inline Scalar &vz(size_t i) { return state_[5 * N + i]; };
+
+        void eval_acc();
+
+        // Private members
+        State state_;
+
+        std::array<Scalar, N> mass_;
+
+        std::array<Scalar, 3 * N> acc_;
+
+        Scalar time_;
+    };
+
+    /*---------------------------------------------------------------------------*\
+        Class EnsembleSystem Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename TypeSystem, size_t N, size_t Lanes>
+    EnsembleSystem<TypeSystem, N, Lanes>::EnsembleSystem() {
+        for (size_t l = 0; l < Lanes; ++l) {
+            clear(l);
+        }
+    }
+
+    template <typename TypeSystem, size_t N, size_t Lanes>
+    template <typename Particle>
+    void EnsembleSystem<TypeSystem, N, Lanes>::load(size_t lane, Real time, std::vector<Particle> const &particles) {
+        if (particles.size() != N) {
+            spacehub_abort("The ensemble takes ", N, " particles per lane, but ", particles.size(), " are given!");
+        }
+        time_[lane] = time;
+        for (size_t i = 0; i < N; ++i) {
+            mass_[i][lane] = particles[i].mass;
+            x(i)[lane] = particles[i].pos.x, y(i)[lane] = particles[i].pos.y, z(i)[lane] = particles[i].pos.z;
+            vx(i)[lane] = particles[i].vel.x, vy(i)[lane] = particles[i].vel.y, vz(i)[lane] = particles[i].vel.z;
+        }
+    }
+
+    template <typename TypeSystem, size_t N, size_t Lanes>
+    template <typename Particle>
+    void EnsembleSystem<TypeSystem, N, Lanes>::store(size_t lane, std::vector<Particle> &particles) const {
+        particles.resize(N);
+        for (size_t i = 0; i < N; ++i) {
+            particles[i].pos.x = state_[i][lane];
+            particles[i].pos.y = state_[N + i][lane];
+            particles[i].pos.z = state_[2 * N + i][lane];
+            particles[i].vel.x = state_[3 * N + i][lane];
+            particles[i].vel.y = state_[4 * N + i][lane];
+            particles[i].vel.z = state_[5 * N + i][lane];
+        }
+    }
+
+    template <typename TypeSystem, size_t N, size_t Lanes>
+    void EnsembleSystem<TypeSystem, N, Lanes>::clear(size_t lane) {
+        // massless particles on a line: finite forces and no close encounters in the idle lane
+        time_[lane] = 0;
+        for (size_t i = 0; i < N; ++i) {
+            mass_[i][lane] = 0;
+            x(i)[lane] = static_cast<Real>(i), y(i)[lane] = z(i)[lane] = 0;
+            vx(i)[lane] = vy(i)[lane] = vz(i)[lane] = 0;
+        }
+    }
+
+    template <typename TypeSystem, size_t N, size_t Lanes>
+    auto EnsembleSystem<TypeSystem, N, Lanes>::total_energy(size_t lane) const -> Real {
+        Real kinetic = 0;
+        Real potential = 0;
+        for (size_t i = 0; i < N; ++i) {
+            Real v2 = state_[3 * N + i][lane] * state_[3 * N + i][lane] +
+                      state_[4 * N + i][lane] * state_[4 * N + i][lane] +
+                      state_[5 * N + i][lane] * state_[5 * N + i][lane];
+            kinetic += 0.5 * mass_[i][lane] * v2;
+            for (size_t j = i + 1; j < N; ++j) {
+                Real dx = state_[j][lane] - state_[i][lane];
+                Real dy = state_[N + j][lane] - state_[N + i][lane];
+                Real dz = state_[2 * N + j][lane] - state_[2 * N + i][lane];
+                potential -= consts::G * mass_[i][lane] * mass_[j][lane] / sqrt(dx * dx + dy * dy + dz * dz);
+            }
+        }
+        return kinetic + potential;
+    }
+
+    template <typename TypeSystem, size_t N, size_t Lanes>
+    void EnsembleSystem<TypeSystem, N, Lanes>::drift(Scalar const &step_size) {
+        for (size_t l = 0; l < Lanes; ++l) {
+            time_[l] += step_size[l];
+        }
+        for (size_t k = 0; k < 3 * N; ++k) {
+            for (size_t l = 0; l < Lanes; ++l) {
+                state_[k][l] += state_[3 * N + k][l] * step_size[l];
+            }
+        }
+    }
+
+    template <typename TypeSystem, size_t N, size_t Lanes>
+    void EnsembleSystem<TypeSystem, N, Lanes>::kick(Scalar const &step_size) {
+        eval_acc();
+        for (size_t k = 0; k < 3 * N; ++k) {
+            for (size_t l = 0; l < Lanes; ++l) {
+                state_[3 * N + k][l] += acc_[k][l] * step_size[l];
+            }
+        }
+    }
+
+    template <typename TypeSystem, size_t N, size_t Lanes>
+    void EnsembleSystem<TypeSystem, N, Lanes>::eval_acc() {
+        for (auto &a : acc_) {
+            a.fill(0);
+        }
+        for (size_t i = 0; i < N; ++i) {
+            // the i-th accelerations are accumulated in locals, so that the compiler sees no aliasing with the j-th
+            Scalar ax = acc_[i], ay = acc_[N + i], az = acc_[2 * N + i];
+            for (size_t j = i + 1; j < N; ++j) {
+#pragma GCC unroll 1
+                for (size_t l = 0; l < Lanes; ++l) {
+                    Real dx = state_[j][l] - state_[i][l];
+                    Real dy = state_[N + j][l] - state_[N + i][l];
+                    Real dz = state_[2 * N + j][l] - state_[2 * N + i][l];
+                    Real r2 = dx * dx + dy * dy + dz * dz;
+                    Real rr3 = consts::G / (r2 * sqrt(r2));
+                    Real mi = mass_[i][l] * rr3;
+                    Real mj = mass_[j][l] * rr3;
+                    ax[l] += mj * dx, ay[l] += mj * dy, az[l] += mj * dz;
+                    acc_[j][l] -= mi * dx, acc_[N + j][l] -= mi * dy, acc_[2 * N + j][l] -= mi * dz;
+                }
+            }
+            acc_[i] = ax, acc_[N + i] = ay, acc_[2 * N + i] = az;
+        }
+    }
+}  // namespace hub::system
@@ -0,0 +1,527 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file hierarchical-system.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include "../core-computation.hpp"
+#include "../integrator/symplectic/symplectic-integrator.hpp"
+#include "../interaction/interaction.hpp"
+#include "../ode-iterator/Bulirsch-Stoer.hpp"
+#include "../ode-iterator/error-checker/worst-offender.hpp"
+#include "../ode-iterator/step-controller/PID-controller.hpp"
+#include "../scattering/hierarchical.hpp"
+#include "../spacehub-concepts.hpp"
+#include "../type-class.hpp"
+#include "archain.hpp"
+#include "diagnostics.hpp"
+
+namespace hub::system {
+
+    /*---------------------------------------------------------------------------*\
+        Class HierarchicalSystem Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Particle system split into compact subsystems, each integrated by its own AR-chain.
+     *
+     * The Hamiltonian is split into the internal Hamiltonians of the subsystems (single bodies included) and the
+     * Newtonian interaction between the centres of mass of different subsystems. The drift advances every subsystem
+     * independently, the multi-body ones with an AR-chain and Bulirsch-Stoer to the relative tolerance of the run at
+     * their own step size, the single bodies on straight lines. The kick accelerates each subsystem as a whole by the
+     * attraction of the other centres of mass, which leaves the internal orbits untouched. Any symplectic integrator
+     * on top of drift/kick therefore only has to resolve the motion of the subsystems relative to each other, however
+     * tight the binaries inside them are.
+     *
+     * The price is the tidal field of the other subsystems, which is neglected inside a subsystem; set_isolation()
+     * controls how isolated a pair must be to become a subsystem and therefore the size of the neglected term. The
+     * partition is rebuilt before every step with scattering::find_subsystems(), so subsystems merge and split as
+     * encounters happen. Extra forces (PN, tides, ...) act inside the subsystems only.
+     *
+     * Every multi-body subsystem keeps its AR-chain, iterator and step size across steps: the chain holds the internal
+     * motion in the centre of mass frame, the kick only moves the centre of mass. Only subsystems whose members
+     * change are rebuilt; a state loaded by read_from_scalar_array(), e.g. on a rejected step of an outer iterator,
+     * is reset into the existing chains without allocation.
+     *
+     * @tparam Particles
+     * @tparam Interactions
+     */
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    class HierarchicalSystem : public Particles {
+       public:
+        // Type members
+        SPACEHUB_USING_TYPE_SYSTEM_OF(Particles);
+
+        using Particle = typename Particles::Particle;
+
+        using Interaction = Interactions;
+
+        using SubSystem = ARchainSystem<Particles, Interactions>;
+
+        using SubIterator = ode::BulirschStoer<integrator::LeapFrogDKD<TypeSet>, ode::WorstOffender<TypeSet>,
+                                               ode::PIDController<TypeSet>>;
+
+        // static public members
+        static constexpr bool ext_vel_dep{Interactions::ext_vel_dep};
+
+        static constexpr bool ext_vel_indep{Interactions::ext_vel_indep};
+
+        // Constructors
+        SPACEHUB_MAKE_CONSTRUCTORS(HierarchicalSystem, delete, default, default, default, default);
+
+        template <CONCEPT_PARTICLE_CONTAINER STL>
+        HierarchicalSystem(Scalar time, STL const &particle_set);
+
+        // Public methods
+        /**
+         * @brief Subsystem index of each particle.
+         */
+        SPACEHUB_READ_ACCESSOR(IdxArray, subsystem_index, group_);
+
+        /**
+         * @brief Number of subsystems, single bodies included.
+         */
+        SPACEHUB_READ_ACCESSOR(size_t, subsystem_number, group_num_);
+
+        /**
+         * @brief Interaction time below which two bodies are put in the same subsystem.
+         */
+        SPACEHUB_READ_ACCESSOR(Scalar, link_time, link_time_);
+
+        /**
+         * @brief Set the interaction time below which two bodies are put in the same subsystem. The default is 1% of
+         * the dynamical time sqrt(R^3/(G M)) of the whole system, with R the rms distance to the centre of mass.
+         *
+         * @param[in] t Link time.
+         */
+        void set_link_time(Scalar t);
+
+        /**
+         * @brief Ratio of the internal to the external interaction time below which an isolated pair becomes a
+         * subsystem.
+         */
+        SPACEHUB_READ_ACCESSOR(Scalar, isolation, isolation_);
+
+        /**
+         * @brief Set the isolation ratio of subsystems. The tidal acceleration neglected inside a subsystem is
+         * roughly isolation^2 of its internal acceleration. The default is 0.05.
+         *
+         * @param[in] ratio Isolation ratio.
+         */
+        void set_isolation(Scalar ratio);
+
+        void set_atol(Scalar atol);
+
+        void set_rtol(Scalar rtol);
+
+        Scalar step_scale() const { return 1.0; };
+
+        template <typename GenVectorArray>
+        void evaluate_acc(GenVectorArray &acceleration) const;
+
+        void drift(Scalar step_size);
+
+        void kick(Scalar step_size);
+
+        void pre_iter_process();
+
+        void post_iter_process() {}
+
+        template <typename ScalarIterable>
+        void write_to_scalar_array(ScalarIterable &y);
+
+        template <typename ScalarIterable>
+        void read_from_scalar_array(ScalarIterable const &y);
+
+        /**
+         * @brief Energy and angular momentum of the current state. Recomputed only if the state changed since the
+         * last query.
+         */
+        Diagnostics<TypeSet> const &diagnostics() const;
+
+        /**
+         * @brief Drop the cached diagnostics and reload the subsystems after modifying the state through the
+         * pos()/vel() accessors.
+         */
+        void invalidate_diagnostics();
+
+        size_t variable_number() const;
+
+        inline constexpr size_t time_offset() const { return 0; };
+
+        inline constexpr size_t pos_offset() const { return 1; };
+
+        inline constexpr size_t vel_offset() const { return this->number() * 3 + 1; };
+
+        // Friend functions
+        template <CONCEPT_PARTICLES P, CONCEPT_INTERACTION F>
+        friend std::ostream &operator<<(std::ostream &os, HierarchicalSystem<P, F> const &ps);
+
+       private:
+        // Private methods
+        void partition();
+
+        /**
+         * @brief A subsystem with more than one body.
+         */
+        struct Subsystem {
+            /** Indices of the members. */
+            IdxArray member;
+
+            /** Internal motion of the members in the centre of mass frame. */
+            SubSystem chain;
+
+            SubIterator iter;
+
+            /** Step size of the iterator in the fictitious time of the chain. */
+            Scalar step{0};
+
+            Vector com_pos;
+
+            Vector com_vel;
+        };
+
+        Subsystem make_subsystem(IdxArray const &member);
+
+        void load_subsystem(Subsystem &sub);
+
+        void load_com_frame(IdxArray const &member, Vector &com_pos, Vector &com_vel);
+
+        void advance_subsystem(Subsystem &sub, Scalar step_size);
+
+        // Private members
+        std::vector<Subsystem> subs_;
+
+        std::vector<Subsystem> new_subs_;
+
+        /** Bodies that form a subsystem on their own. */
+        IdxArray singles_;
+
+        IdxArray group_;
+
+        IdxArray new_group_;
+
+        std::vector<Particle> all_;
+
+        std::vector<Particle> buffer_;
+
+        ScalarArray com_mass_;
+
+        VectorArray com_pos_;
+
+        VectorArray acc_;
+
+        size_t group_num_{0};
+
+        Scalar link_time_{0};
+
+        Scalar isolation_{0.05};
+
+        Scalar atol_{0};
+
+        Scalar rtol_{1e-14};
+
+        mutable Diagnostics<TypeSet> diag_;
+    };
+}  // namespace hub::system
+
+namespace hub::system {
+    /*---------------------------------------------------------------------------*\
+        Class HierarchicalSystem Implementation
+    \*---------------------------------------------------------------------------*/
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    template <CONCEPT_PARTICLE_CONTAINER STL>
+    HierarchicalSystem<Particles, Interactions>::HierarchicalSystem(Scalar time, const STL &particle_set)
+        : Particles(time, particle_set) {
+        auto const &m = this->mass();
+        auto const &p = this->pos();
+        Scalar M = calc::array_sum(m);
+        Vector com = calc::calc_com(m, p);
+        Scalar R2 = 0;
+        for (size_t i = 0; i < this->number(); ++i) {
+            R2 += m[i] * norm2(p[i] - com);
+        }
+        R2 /= M;
+        link_time_ = 0.01 * sqrt(R2 * sqrt(R2) / (consts::G * M));
+        partition();
+        diag_.reset(*this);
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    auto HierarchicalSystem<Particles, Interactions>::diagnostics() const -> Diagnostics<TypeSet> const & {
+        diag_.update(*this);
+        return diag_;
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    void HierarchicalSystem<Particles, Interactions>::invalidate_diagnostics() {
+        diag_.invalidate();
+        if (!subs_.empty()) {
+            all_ = this->to_AoS();
+        }
+        for (auto &sub : subs_) {
+            load_subsystem(sub);
+        }
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    void HierarchicalSystem<Particles, Interactions>::set_link_time(Scalar t) {
+        link_time_ = t;
+        partition();
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    void HierarchicalSystem<Particles, Interactions>::set_isolation(Scalar ratio) {
+        isolation_ = ratio;
+        partition();
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    void HierarchicalSystem<Particles, Interactions>::set_atol(Scalar atol) {
+        atol_ = atol;
+        for (auto &sub : subs_) {
+            sub.iter.set_atol(atol);
+        }
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    void HierarchicalSystem<Particles, Interactions>::set_rtol(Scalar rtol) {
+        rtol_ = rtol;
+        for (auto &sub : subs_) {
+            sub.iter.set_rtol(rtol);
+        }
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    template <typename ScalarIterable>
+    void HierarchicalSystem<Particles, Interactions>::read_from_scalar_array(const ScalarIterable &y) {
+        if (y.size() == this->variable_number()) {
+            auto begin = y.begin();
+            this->time() = *(begin + time_offset());
+            load_to_coords(begin + pos_offset(), begin + vel_offset(), this->pos());
+            load_to_coords(begin + vel_offset(), y.end(), this->vel());
+            invalidate_diagnostics();
+        } else {
+            spacehub_abort("Wrong input array size!");
+        }
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    template <typename ScalarIterable>
+    void HierarchicalSystem<Particles, Interactions>::write_to_scalar_array(ScalarIterable &y) {
+        y.clear();
+        y.reserve(this->variable_number());
+        y.emplace_back(this->time());
+        add_coords_to(y, this->pos());
+        add_coords_to(y, this->vel());
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    size_t HierarchicalSystem<Particles, Interactions>::variable_number() const {
+        return this->number() * 6 + 1;
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    void HierarchicalSystem<Particles, Interactions>::pre_iter_process() {
+        partition();
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    void HierarchicalSystem<Particles, Interactions>::partition() {
+        size_t num =
+            scattering::find_subsystems(this->mass(), this->pos(), this->vel(), link_time_, isolation_, new_group_);
+        if (num == group_num_ && new_group_ == group_) {
+            return;
+        }
+        std::swap(group_, new_group_);
+        group_num_ = num;
+
+        std::vector<IdxArray> members(group_num_);
+        for (size_t i = 0; i < this->number(); ++i) {
+            members[group_[i]].emplace_back(i);
+        }
+        singles_.clear();
+        new_subs_.clear();
+        all_ = this->to_AoS();
+        for (auto &m : members) {
+            if (m.size() == 1) {
+                singles_.emplace_back(m[0]);
+                continue;
+            }
+            // a subsystem that keeps its members keeps its chain, iterator and step size
+            auto old = std::find_if(subs_.begin(), subs_.end(), [&](auto const &sub) { return sub.member == m; });
+            if (old != subs_.end()) {
+                new_subs_.emplace_back(std::move(*old));
+                subs_.erase(old);
+            } else {
+                new_subs_.emplace_back(make_subsystem(m));
+            }
+        }
+        std::swap(subs_, new_subs_);
+        new_subs_.clear();
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    auto HierarchicalSystem<Particles, Interactions>::make_subsystem(IdxArray const &member) -> Subsystem {
+        Vector com_pos, com_vel;
+        load_com_frame(member, com_pos, com_vel);
+        Subsystem sub{member, SubSystem(this->time(), buffer_), SubIterator{}, 0, com_pos, com_vel};
+        sub.iter.set_atol(atol_);
+        sub.iter.set_rtol(rtol_);
+        auto const &chain = sub.chain;
+        sub.step = 0.1 * calc::calc_step_scale(chain) * calc::calc_fall_free_time(chain.mass(), chain.pos());
+        return sub;
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    void HierarchicalSystem<Particles, Interactions>::load_subsystem(Subsystem &sub) {
+        load_com_frame(sub.member, sub.com_pos, sub.com_vel);
+        sub.chain.reset(this->time(), buffer_);
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    void HierarchicalSystem<Particles, Interactions>::load_com_frame(IdxArray const &member, Vector &com_pos,
+                                                                     Vector &com_vel) {
+        Scalar M = 0;
+        com_pos = com_vel = Vector{0};
+        for (auto i : member) {
+            M += all_[i].mass;
+            com_pos += all_[i].mass * all_[i].pos;
+            com_vel += all_[i].mass * all_[i].vel;
+        }
+        com_pos /= M;
+        com_vel /= M;
+
+        buffer_.clear();
+        for (auto i : member) {
+            buffer_.emplace_back(all_[i]);
+            buffer_.back().pos -= com_pos;
+            buffer_.back().vel -= com_vel;
+        }
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    void HierarchicalSystem<Particles, Interactions>::advance_subsystem(Subsystem &sub, Scalar step_size) {
+        static constexpr size_t max_landing_iter{64};
+        auto &chain = sub.chain;
+        auto &h = sub.step;
+        chain.time() = this->time();
+
+        Scalar const end_time = this->time() + step_size;
+        Scalar const time_tol = 4 * math::epsilon<Scalar>::value * math::max(fabs(end_time), fabs(step_size));
+        for (size_t landing = 0; fabs(end_time - chain.time()) > time_tol;) {
+            Scalar rest_step = (end_time - chain.time()) * chain.step_scale();
+            chain.pre_iter_process();
+            if (h < fabs(rest_step)) {
+                // regular steps, backwards if a landing correction overshot the end time
+                h = fabs(sub.iter.iterate(chain, rest_step > 0 ? h : -h));
+            } else {
+                // the fictitious time does not map linearly onto the physical time, land on the end time by corrections
+                if (landing++ == max_landing_iter) {
+                    spacehub_abort("The subsystem fails to land on the end time of the step: ", end_time - chain.time(),
+                                   " left after ", max_landing_iter, " corrections!");
+                }
+                // a landing step that the iterator had to shrink also shrinks the regular step, so that the next
+                // corrections start from a step it can take
+                Scalar next = fabs(sub.iter.iterate(chain, rest_step));
+                if (next < fabs(rest_step)) {
+                    h = next;
+                }
+            }
+            chain.post_iter_process();
+        }
+
+        sub.com_pos += sub.com_vel * step_size;
+        for (size_t j = 0; j < sub.member.size(); ++j) {
+            this->pos(sub.member[j]) = sub.com_pos + chain.pos(j);
+            this->vel(sub.member[j]) = sub.com_vel + chain.vel(j);
+        }
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    void HierarchicalSystem<Particles, Interactions>::drift(Scalar step_size) {
+        diag_.invalidate();
+        for (auto &sub : subs_) {
+            advance_subsystem(sub, step_size);
+        }
+        for (auto i : singles_) {
+            this->pos(i) += this->vel(i) * step_size;
+        }
+        this->time() += step_size;
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    void HierarchicalSystem<Particles, Interactions>::kick(Scalar step_size) {
+        diag_.invalidate_velocity();
+        auto const &m = this->mass();
+        auto const &p = this->pos();
+        size_t const num = this->number();
+
+        com_mass_.resize(group_num_);
+        com_pos_.resize(group_num_);
+        acc_.resize(group_num_);
+        calc::array_set_zero(com_mass_);
+        calc::array_set_zero(com_pos_);
+        calc::array_set_zero(acc_);
+        for (size_t i = 0; i < num; ++i) {
+            com_mass_[group_[i]] += m[i];
+            com_pos_[group_[i]] += m[i] * p[i];
+        }
+        for (size_t k = 0; k < group_num_; ++k) {
+            com_pos_[k] /= com_mass_[k];
+        }
+
+        for (size_t k = 0; k < group_num_; ++k) {
+            for (size_t l = k + 1; l < group_num_; ++l) {
+                Vector dr = com_pos_[l] - com_pos_[k];
+                Scalar r = norm(dr);
+                Scalar rr3 = consts::G / (r * r * r);
+                acc_[k] += dr * (rr3 * com_mass_[l]);
+                acc_[l] -= dr * (rr3 * com_mass_[k]);
+            }
+        }
+
+        for (size_t i = 0; i < num; ++i) {
+            this->vel(i) += acc_[group_[i]] * step_size;
+        }
+        // the internal motion is untouched, only the centres of mass of the subsystems follow the kick
+        for (auto &sub : subs_) {
+            sub.com_vel += acc_[group_[sub.member[0]]] * step_size;
+        }
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    template <typename GenVectorArray>
+    void HierarchicalSystem<Particles, Interactions>::evaluate_acc(GenVectorArray &acceleration) const {
+        Interactions::eval_acc(*this, acceleration);
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    std::ostream &operator<<(std::ostream &os, HierarchicalSystem<Particles, Interactions> const &ps) {
+        os << static_cast<Particles>(ps);
+        return os;
+    }
+}  // namespace hub::system
@@ -0,0 +1,849 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file ks-system.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
+
+#include "../core-computation.hpp"
+#include "../interaction/interaction.hpp"
+#include "../orbits/orbits.hpp"
+#include "../spacehub-concepts.hpp"
+#include "../type-class.hpp"
+#include "diagnostics.hpp"
+#include "ks.hpp"
+namespace hub::system {
+
+    /*---------------------------------------------------------------------------*\
+        Class KSRegularizedSystem Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Particle system with the most tightly bound pair in Kustaanheimo-Stiefel coordinates.
+     *
+     * The pair with the largest m_i*m_j/r_ij at construction is replaced by its centre of mass and its relative motion
+     * is integrated in the 4D KS form u'' = (h/2)u + (r/2)L^T(u)P, h' = 2u'.L^T(u)P, where P is the relative
+     * perturbing acceleration (Newtonian attraction of the other bodies plus all extra forces, PN and tides included).
+     * The whole system is evolved in the fictitious time s of the pair, dt = r ds, so all other bodies follow
+     * dx/ds = r v, dv/ds = r a. The equations are regular at r -> 0, which removes the pericentre step collapse of very
+     * eccentric binaries.
+     *
+     * The drift solves the flow of (u, x, t) with (u', v) frozen exactly (t(s) is a cubic in s), the kick advances
+     * (u', h, v) with the positions frozen; h is kicked in two halves around u', so the leapfrog stays time symmetric
+     * and works with the BulirschStoer extrapolation. Velocity dependent extra forces use the same auxiliary velocity
+     * scheme as the other systems.
+     *
+     * The Cartesian pos()/vel() of all particles are kept in sync for callbacks and extra forces. The internal force is
+     * assumed to be Newtonian.
+     *
+     * With `SlowDown` the Mikkola & Aarseth (1996, CeMDA 64, 197) slow-down is applied to a weakly perturbed bound
+     * pair: one slowed orbit stands for kappa physical orbits, i.e. dt = kappa r ds for the outer bodies and the
+     * perturbation on the pair is enhanced by kappa, while the internal Kepler motion is unchanged. The secular
+     * (orbit averaged) evolution is preserved, the phase of the pair is not. kappa = sqrt(slow_down_gamma / gamma) with
+     * the relative perturbation gamma = |P| r^2 / (G M), clamped to [1, max_slow_down]. kappa is raised only at
+     * apocentre passages and lowered as soon as the perturbation requires it.
+     *
+     * Only the single pair chosen at construction is regularized; it is not re-selected when the hierarchy changes, and
+     * the other bodies are integrated in plain Cartesian coordinates whatever their separations.
+     *
+     * If enabled with set_unperturbed_tol() (off by default), the KS pair is treated as unperturbed while it is bound
+     * and its relative perturbation stays below the tolerance: it acts and is acted on as a point mass at its centre
+     * of mass, the fictitious time runs as dt = kappa a ds, and the drift advances the Kepler phase of the pair
+     * analytically by solving Kepler's equation. An isolated pair then costs nothing however many orbits a step spans.
+     * The tidal perturbation is still monitored at every kick, and the pair is resolved again as soon as it exceeds
+     * the tolerance. Systems with velocity dependent forces are always integrated numerically.
+     *
+     * @tparam Particles
+     * @tparam Interactions
+     * @tparam SlowDown Enable the slow-down of weakly perturbed pairs.
+     */
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown = false>
+    class KSRegularizedSystem : public Particles {
+       public:
+        // Type members
+        SPACEHUB_USING_TYPE_SYSTEM_OF(Particles);
+
+        using Particle = typename Particles::Particle;
+
+        using Interaction = Interactions;
+
+        using KSVector = KS::Vector4<StateScalar>;
+
+        // Static public members
+        static constexpr bool ext_vel_dep{Interactions::ext_vel_dep};
+
+        static constexpr bool ext_vel_indep{Interactions::ext_vel_indep};
+
+        /** Relative perturbation below which the pair is slowed down. */
+        static constexpr double slow_down_gamma{1e-6};
+
+        /** Upper limit of the slow-down factor. */
+        static constexpr double max_slow_down{1e6};
+
+        // Constructors
+        SPACEHUB_MAKE_CONSTRUCTORS(KSRegularizedSystem, delete, default, default, default, default);
+
+        template <CONCEPT_PARTICLE_CONTAINER STL>
+        KSRegularizedSystem(Scalar time, STL const &particle_set);
+
+        // Public methods
+        SPACEHUB_READ_ACCESSOR(KSVector, ks_pos, u_);
+
+        SPACEHUB_READ_ACCESSOR(KSVector, ks_vel, up_);
+
+        SPACEHUB_READ_ACCESSOR(StateScalar, kepler_energy, h_);
+
+        /**
+         * @brief Current slow-down factor kappa of the KS pair (always 1 without `SlowDown`).
+         */
+        SPACEHUB_READ_ACCESSOR(Scalar, slow_down, kappa_);
+
+        /**
+         * @brief If the KS pair is currently propagated analytically as an unperturbed Kepler orbit.
+         */
+        SPACEHUB_READ_ACCESSOR(bool, is_unperturbed, kepler_drift_);
+
+        /**
+         * @brief Set the relative perturbation below which the KS pair is propagated analytically. Zero (the
+         * default) disables the analytic propagation. The Simulator forwards RunArgs::unperturbed_tol.
+         *
+         * @param[in] tol Tolerance of the relative perturbation |P| r^2 / (G M).
+         */
+        void set_unperturbed_tol(Scalar tol);
+
+        SPACEHUB_ARRAY_ACCESSOR(StateScalarArray, increment, increment_);
+
+        /**
+         * @brief Indices of the two particles of the KS pair.
+         */
+        inline std::array<size_t, 2> ks_pair() const { return {i1_, i2_}; };
+
+        /**
+         * @brief dh/dt of the fictitious time, 1/(kappa r) of the KS pair, or 1/(kappa a) while the pair is
+         * unperturbed.
+         */
+        Scalar step_scale() const;
+
+        template <typename GenVectorArray>
+        void evaluate_acc(GenVectorArray &acceleration) const;
+
+        void drift(Scalar step_size);
+
+        void kick(Scalar step_size);
+
+        void pre_iter_process();
+
+        void post_iter_process();
+
+        template <typename ScalarIterable>
+        void write_to_scalar_array(ScalarIterable &y);
+
+        template <typename ScalarIterable>
+        void read_from_scalar_array(ScalarIterable const &y);
+
+        template <typename ScalarIterable>
+        void evaluate_general_derivative(ScalarIterable &dy_dh);
+
+        /**
+         * @brief Energy and angular momentum of the current state. Recomputed only if the state changed since the
+         * last query.
+         */
+        Diagnostics<TypeSet> const &diagnostics() const;
+
+        /**
+         * @brief Drop the cached diagnostics after modifying the state through the pos()/vel() accessors.
+         */
+        inline void invalidate_diagnostics() { diag_.invalidate(); };
+
+        inline void collect_increment(bool sync) { sync_increment_ = sync; };
+
+        void clear_increment() { calc::array_set_zero(increment_); };
+
+        size_t variable_number() const;
+
+        inline constexpr size_t time_offset() const { return 0; };
+
+        inline constexpr size_t pos_offset() const { return 1; };
+
+        inline constexpr size_t vel_offset() const { return outer_number() * 3 + 1; };
+
+        inline constexpr size_t auxi_vel_offset() const { return outer_number() * 6 + 1; };
+
+        inline constexpr size_t ks_pos_offset() const {
+            return outer_number() * 3 * (2 + static_cast<size_t>(Interactions::ext_vel_dep)) + 1;
+        };
+
+        inline constexpr size_t ks_vel_offset() const { return ks_pos_offset() + 4; };
+
+        inline constexpr size_t ks_auxi_vel_offset() const { return ks_pos_offset() + 8; };
+
+        inline constexpr size_t kepler_energy_offset() const {
+            return ks_pos_offset() + 8 + 4 * static_cast<size_t>(Interactions::ext_vel_dep);
+        };
+
+        // Friend functions
+        template <CONCEPT_PARTICLES P, CONCEPT_INTERACTION F, bool S>
+        friend std::ostream &operator<<(std::ostream &os, KSRegularizedSystem<P, F, S> const &ps);
+
+       private:
+        // Private methods
+        /**
+         * @brief Number of bodies outside the KS pair plus one for the centre of mass of the pair.
+         */
+        inline constexpr size_t outer_number() const { return this->number() - 1; };
+
+        void sync_cartesian_pos();
+
+        template <typename OuterVel, typename KSVel, typename VelArray>
+        void write_cartesian_vel(OuterVel const &outer_vel, KSVel const &up, VelArray &vel) const;
+
+        void eval_vel_indep_acc();
+
+        void eval_vel_dep_acc();
+
+        void eval_unperturbed_acc();
+
+        void reduce_to_ks(VectorArray const &acc);
+
+        void kick_real_vel(Scalar step_size);
+
+        void kick_pseu_vel(Scalar step_size);
+
+        void advance_kepler_energy(KS::Vector4<Scalar> const &ks_pert, Scalar step_size);
+
+        Scalar relative_perturbation() const;
+
+        void update_slow_down();
+
+        void update_unperturbed();
+
+        Scalar kepler_drift(Scalar step_size);
+
+        template <typename Array>
+        void sync_pos_increment(Array const &inc, Scalar step_size);
+
+        template <typename Array>
+        void sync_vel_increment(Array const &inc, Scalar step_size);
+
+        template <typename Array>
+        void sync_auxi_vel_increment(Array const &inc, Scalar step_size);
+
+        void sync_time_increment(Scalar phy_time);
+
+        void sync_ks_increment(size_t offset, size_t i, Scalar inc);
+
+        // Private members
+        force::InteractionData<Interactions, VectorArray> accels_;
+
+        StateScalarArray increment_;
+
+        /** Centre of mass of the pair at [0], the other bodies after it. */
+        StateVectorArray outer_pos_;
+
+        StateVectorArray outer_vel_;
+
+        std::conditional_t<Interactions::ext_vel_dep, StateVectorArray, Empty> aux_outer_vel_;
+
+        /** Particle index of outer_pos_[k] for k > 0. */
+        IdxArray outer_index_;
+
+        VectorArray outer_acc_;
+
+        std::conditional_t<Interactions::ext_vel_dep, StateVectorArray, Empty> aux_vel_;
+
+        KSVector u_;
+
+        KSVector up_;
+
+        std::conditional_t<Interactions::ext_vel_dep, KSVector, Empty> aux_up_;
+
+        StateScalar h_{0};
+
+        Vector ks_pert_;
+
+        Scalar kappa_{1};
+
+        bool receding_{false};
+
+        Scalar unperturbed_tol_{0};
+
+        bool kepler_drift_{false};
+
+        size_t i1_{0};
+
+        size_t i2_{1};
+
+        mutable Diagnostics<TypeSet> diag_;
+
+        bool sync_increment_{false};
+    };
+
+    /**
+     * @brief KS regularized system with the slow-down of weakly perturbed pairs enabled.
+     */
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    using SlowDownKSSystem = KSRegularizedSystem<Particles, Interactions, true>;
+
+    /*---------------------------------------------------------------------------*\
+        Class KSRegularizedSystem Implementation
+    \*---------------------------------------------------------------------------*/
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    template <CONCEPT_PARTICLE_CONTAINER STL>
+    KSRegularizedSystem<Particles, Interactions, SlowDown>::KSRegularizedSystem(Scalar time, const STL &particle_set)
+        : Particles(time, particle_set), accels_(particle_set.size()) {
+        size_t const num = this->number();
+        if (num < 2) {
+            spacehub_abort("KS regularization needs at least two particles!");
+        }
+
+        auto const &m = this->mass();
+        auto const &p = this->pos();
+        Scalar max_bind = -1;
+        for (size_t i = 0; i < num; ++i) {
+            for (size_t j = i + 1; j < num; ++j) {
+                Scalar bind = m[i] * m[j] / distance(p[i], p[j]);
+                if (bind > max_bind) {
+                    max_bind = bind;
+                    i1_ = i;
+                    i2_ = j;
+                }
+            }
+        }
+
+        Scalar const m1 = m[i1_];
+        Scalar const m2 = m[i2_];
+        Scalar const M = m1 + m2;
+
+        outer_pos_.resize(outer_number());
+        outer_vel_.resize(outer_number());
+        outer_acc_.resize(outer_number());
+        outer_index_.resize(outer_number());
+        outer_pos_[0] = (m1 * p[i1_] + m2 * p[i2_]) / M;
+        outer_vel_[0] = (m1 * this->vel(i1_) + m2 * this->vel(i2_)) / M;
+        outer_index_[0] = i1_;
+        for (size_t i = 0, k = 1; i < num; ++i) {
+            if (i != i1_ && i != i2_) {
+                outer_pos_[k] = p[i];
+                outer_vel_[k] = this->vel(i);
+                outer_index_[k] = i;
+                ++k;
+            }
+        }
+
+        KS::from_cartesian(p[i2_] - p[i1_], this->vel(i2_) - this->vel(i1_), u_, up_);
+        h_ = KS::kepler_energy(u_, up_, consts::G * M);
+
+        sync_cartesian_pos();
+        write_cartesian_vel(outer_vel_, up_, this->vel());
+
+        if constexpr (Interactions::ext_vel_dep) {
+            aux_outer_vel_ = outer_vel_;
+            aux_up_ = up_;
+            aux_vel_ = this->vel();
+        }
+        increment_.resize(variable_number());
+        diag_.reset(*this);
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    auto KSRegularizedSystem<Particles, Interactions, SlowDown>::diagnostics() const -> Diagnostics<TypeSet> const & {
+        diag_.update(*this);
+        return diag_;
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    std::ostream &operator<<(std::ostream &os, const KSRegularizedSystem<Particles, Interactions, SlowDown> &ps) {
+        os << static_cast<Particles>(ps);
+        return os;
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    template <typename GenVectorArray>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::evaluate_acc(GenVectorArray &acceleration) const {
+        Interactions::eval_acc(*this, acceleration);
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::drift(Scalar step_size) {
+        diag_.invalidate();
+        Scalar phy_time;
+        if (kepler_drift_) {
+            phy_time = kappa_ * kepler_drift(step_size);
+        } else {
+            Scalar r = KS::norm2(u_);
+            Scalar ru = KS::dot(u_, up_);
+            Scalar rup = KS::norm2(up_);
+            // exact physical time along u(s) = u + u's with u' frozen
+            phy_time = kappa_ * step_size * (r + step_size * (ru + step_size * rup / 3));
+
+            for (size_t i = 0; i < 4; ++i) {
+                Scalar du = up_[i] * step_size;
+                u_[i] += du;
+                sync_ks_increment(ks_pos_offset(), i, du);
+            }
+        }
+        calc::array_advance(outer_pos_, outer_vel_, phy_time);
+        this->time() += phy_time;
+        sync_time_increment(phy_time);
+        sync_pos_increment(outer_vel_, phy_time);
+
+        sync_cartesian_pos();
+        write_cartesian_vel(outer_vel_, up_, this->vel());
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::kick(Scalar step_size) {
+        diag_.invalidate_velocity();
+        if (!kepler_drift_) {
+            eval_vel_indep_acc();
+        }
+        if constexpr (Interactions::ext_vel_dep) {
+            Scalar half_step = 0.5 * step_size;
+            kick_real_vel(half_step);
+            write_cartesian_vel(outer_vel_, up_, this->vel());
+            eval_vel_dep_acc();
+            reduce_to_ks(accels_.acc());
+            kick_pseu_vel(step_size);
+            kick_real_vel(half_step);
+        } else {
+            if (kepler_drift_) {
+                eval_unperturbed_acc();
+            } else {
+                reduce_to_ks(accels_.tot_vel_indep_acc());
+            }
+            kick_real_vel(step_size);
+        }
+        write_cartesian_vel(outer_vel_, up_, this->vel());
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::pre_iter_process() {
+        if constexpr (Interactions::ext_vel_dep) {
+            aux_outer_vel_ = outer_vel_;
+            aux_up_ = up_;
+        }
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::post_iter_process() {
+        if constexpr (SlowDown) {
+            update_slow_down();
+        }
+        update_unperturbed();
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    auto KSRegularizedSystem<Particles, Interactions, SlowDown>::step_scale() const -> Scalar {
+        if (kepler_drift_) {
+            Scalar mu = consts::G * (this->mass(i1_) + this->mass(i2_));
+            return -2 * static_cast<Scalar>(h_) / (kappa_ * mu);
+        } else {
+            return 1 / (kappa_ * static_cast<Scalar>(KS::norm2(u_)));
+        }
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::set_unperturbed_tol(Scalar tol) {
+        unperturbed_tol_ = tol;
+        if constexpr (!Interactions::ext_vel_dep) {
+            eval_vel_indep_acc();
+            reduce_to_ks(accels_.tot_vel_indep_acc());
+        }
+        update_unperturbed();
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    template <typename ScalarIterable>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::write_to_scalar_array(ScalarIterable &y) {
+        y.clear();
+        y.reserve(this->variable_number());
+        y.emplace_back(this->time());
+        add_coords_to(y, outer_pos_);
+        add_coords_to(y, outer_vel_);
+        if constexpr (Interactions::ext_vel_dep) {
+            add_coords_to(y, aux_outer_vel_);
+        }
+        y.insert(y.end(), u_.begin(), u_.end());
+        y.insert(y.end(), up_.begin(), up_.end());
+        if constexpr (Interactions::ext_vel_dep) {
+            y.insert(y.end(), aux_up_.begin(), aux_up_.end());
+        }
+        y.emplace_back(h_);
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    template <typename ScalarIterable>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::read_from_scalar_array(const ScalarIterable &y) {
+        if (y.size() == this->variable_number()) {
+            auto begin = y.begin();
+            this->time() = *(begin + time_offset());
+            load_to_coords(begin + pos_offset(), begin + vel_offset(), outer_pos_);
+            load_to_coords(begin + vel_offset(), begin + auxi_vel_offset(), outer_vel_);
+            if constexpr (Interactions::ext_vel_dep) {
+                load_to_coords(begin + auxi_vel_offset(), begin + ks_pos_offset(), aux_outer_vel_);
+            }
+            std::copy(begin + ks_pos_offset(), begin + ks_pos_offset() + 4, u_.begin());
+            std::copy(begin + ks_vel_offset(), begin + ks_vel_offset() + 4, up_.begin());
+            if constexpr (Interactions::ext_vel_dep) {
+                std::copy(begin + ks_auxi_vel_offset(), begin + ks_auxi_vel_offset() + 4, aux_up_.begin());
+            }
+            h_ = *(begin + kepler_energy_offset());
+
+            sync_cartesian_pos();
+            write_cartesian_vel(outer_vel_, up_, this->vel());
+            diag_.invalidate();
+        } else {
+            spacehub_abort("Wrong input array size!");
+        }
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    template <typename ScalarIterable>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::evaluate_general_derivative(ScalarIterable &dy_dh) {
+        dy_dh.clear();
+        dy_dh.reserve(this->variable_number());
+
+        eval_vel_indep_acc();
+        if constexpr (Interactions::ext_vel_dep) {
+            eval_vel_dep_acc();
+            reduce_to_ks(accels_.acc());
+        } else {
+            reduce_to_ks(accels_.tot_vel_indep_acc());
+        }
+
+        Scalar r = KS::norm2(u_);
+        Scalar kr = kappa_ * r;
+        auto Q = KS::transpose_mul(u_, ks_pert_ * kappa_);
+
+        dy_dh.emplace_back(kr);                         // dt/ds
+        add_scaled_coords_to(dy_dh, outer_vel_, kr);  // dx/ds
+        add_scaled_coords_to(dy_dh, outer_acc_, kr);  // dv/ds
+        if constexpr (Interactions::ext_vel_dep) {
+            add_scaled_coords_to(dy_dh, outer_acc_, kr);  // dw/ds
+        }
+        dy_dh.insert(dy_dh.end(), up_.begin(), up_.end());  // du/ds
+        for (size_t i = 0; i < 4; ++i) {
+            dy_dh.emplace_back(0.5 * (h_ * u_[i] + r * Q[i]));  // du'/ds
+        }
+        if constexpr (Interactions::ext_vel_dep) {
+            for (size_t i = 0; i < 4; ++i) {
+                dy_dh.emplace_back(0.5 * (h_ * u_[i] + r * Q[i]));
+            }
+        }
+        dy_dh.emplace_back(2 * KS::dot(up_, Q));  // dh/ds
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    size_t KSRegularizedSystem<Particles, Interactions, SlowDown>::variable_number() const {
+        return kepler_energy_offset() + 1;
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::sync_cartesian_pos() {
+        auto &p = this->pos();
+        Scalar const m1 = this->mass(i1_);
+        Scalar const m2 = this->mass(i2_);
+        Scalar const M = m1 + m2;
+        Vector R = KS::to_cartesian_pos<Vector>(u_);
+        p[i1_] = outer_pos_[0] - R * (m2 / M);
+        p[i2_] = outer_pos_[0] + R * (m1 / M);
+        for (size_t k = 1; k < outer_number(); ++k) {
+            p[outer_index_[k]] = outer_pos_[k];
+        }
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    template <typename OuterVel, typename KSVel, typename VelArray>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::write_cartesian_vel(OuterVel const &outer_vel,
+                                                                                     KSVel const &up,
+                                                                                     VelArray &vel) const {
+        Scalar const m1 = this->mass(i1_);
+        Scalar const m2 = this->mass(i2_);
+        Scalar const M = m1 + m2;
+        Vector V = KS::to_cartesian_vel<Vector>(u_, up);
+        vel[i1_] = outer_vel[0] - V * (m2 / M);
+        vel[i2_] = outer_vel[0] + V * (m1 / M);
+        for (size_t k = 1; k < outer_number(); ++k) {
+            vel[outer_index_[k]] = outer_vel[k];
+        }
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::eval_vel_indep_acc() {
+        auto &acc = accels_.tot_vel_indep_acc();
+        auto const &m = this->mass();
+        auto const &p = this->pos();
+        size_t const num = this->number();
+
+        // Newtonian attraction of every pair except the KS pair, whose mutual force is in the KS equations.
+        calc::array_set_zero(acc);
+        for (size_t i = 0; i < num; ++i) {
+            for (size_t j = i + 1; j < num; ++j) {
+                if (i == i1_ && j == i2_) {
+                    continue;
+                }
+                Vector dr = p[j] - p[i];
+                Scalar r = norm(dr);
+                Scalar rr3 = consts::G / (r * r * r);
+                acc[i] += dr * (rr3 * m[j]);
+                acc[j] -= dr * (rr3 * m[i]);
+            }
+        }
+
+        if constexpr (Interactions::ext_vel_indep) {
+            Interactions::eval_extra_vel_indep_acc(*this, accels_.ext_vel_indep_acc());
+            calc::array_add(acc, acc, accels_.ext_vel_indep_acc());
+        }
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::eval_unperturbed_acc() {
+        auto &acc = accels_.tot_vel_indep_acc();
+        auto const &m = this->mass();
+        auto const &p = this->pos();
+        Scalar const M = m[i1_] + m[i2_];
+
+        // The pair attracts and is attracted as a point mass at its centre of mass. The tidal acceleration on the
+        // pair members is still collected, but only to monitor the perturbation.
+        calc::array_set_zero(acc);
+        Vector com_acc{0, 0, 0};
+        for (size_t k = 1; k < outer_number(); ++k) {
+            size_t const j = outer_index_[k];
+            Vector dr = p[j] - outer_pos_[0];
+            Scalar r = norm(dr);
+            Scalar rr3 = consts::G / (r * r * r);
+            com_acc += dr * (rr3 * m[j]);
+            acc[j] -= dr * (rr3 * M);
+            for (size_t i : {i1_, i2_}) {
+                Vector dri = p[j] - p[i];
+                Scalar ri = norm(dri);
+                acc[i] += dri * (consts::G * m[j] / (ri * ri * ri));
+            }
+            for (size_t l = k + 1; l < outer_number(); ++l) {
+                size_t const n = outer_index_[l];
+                Vector drn = p[n] - p[j];
+                Scalar rn = norm(drn);
+                Scalar rn3 = consts::G / (rn * rn * rn);
+                acc[j] += drn * (rn3 * m[n]);
+                acc[n] -= drn * (rn3 * m[j]);
+            }
+        }
+
+        if constexpr (Interactions::ext_vel_indep) {
+            Interactions::eval_extra_vel_indep_acc(*this, accels_.ext_vel_indep_acc());
+            calc::array_add(acc, acc, accels_.ext_vel_indep_acc());
+            auto const &ext = accels_.ext_vel_indep_acc();
+            com_acc += (m[i1_] * ext[i1_] + m[i2_] * ext[i2_]) / M;
+        }
+        reduce_to_ks(acc);
+        outer_acc_[0] = com_acc;
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::eval_vel_dep_acc() {
+        Interactions::eval_extra_vel_dep_acc(*this, accels_.ext_vel_dep_acc());
+        calc::array_add(accels_.acc(), accels_.tot_vel_indep_acc(), accels_.ext_vel_dep_acc());
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::reduce_to_ks(VectorArray const &acc) {
+        Scalar const m1 = this->mass(i1_);
+        Scalar const m2 = this->mass(i2_);
+        outer_acc_[0] = (m1 * acc[i1_] + m2 * acc[i2_]) / (m1 + m2);
+        for (size_t k = 1; k < outer_number(); ++k) {
+            outer_acc_[k] = acc[outer_index_[k]];
+        }
+        ks_pert_ = acc[i2_] - acc[i1_];
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::advance_kepler_energy(
+        KS::Vector4<Scalar> const &ks_pert, Scalar step_size) {
+        Scalar dh = 2 * KS::dot(up_, ks_pert) * step_size;
+        h_ += dh;
+        sync_ks_increment(kepler_energy_offset(), 0, dh);
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    auto KSRegularizedSystem<Particles, Interactions, SlowDown>::relative_perturbation() const -> Scalar {
+        Scalar r = KS::norm2(u_);
+        Scalar mu = consts::G * (this->mass(i1_) + this->mass(i2_));
+        return norm(ks_pert_) * r * r / mu;
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::update_slow_down() {
+        bool const was_receding = receding_;
+        receding_ = KS::dot(u_, up_) > 0;
+
+        Scalar kappa = 1;
+        if (h_ < 0) {
+            Scalar gamma = relative_perturbation();
+            kappa = gamma > 0 ? sqrt(slow_down_gamma / gamma) : max_slow_down;
+            kappa = std::clamp(kappa, Scalar{1}, static_cast<Scalar>(max_slow_down));
+        }
+
+        if (kappa < kappa_) {
+            kappa_ = kappa;
+        } else if (was_receding && !receding_) {
+            // a larger slow-down only at apocentre, where the pair's internal motion is slowest
+            kappa_ = kappa;
+        }
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::update_unperturbed() {
+        if constexpr (!Interactions::ext_vel_dep) {
+            if (unperturbed_tol_ > 0 && h_ < 0) {
+                // The tidal perturbation grows as r, gamma as r^3: judge the pair by its value at apocentre. Its
+                // direction still changes gamma by a factor of ~2 along the orbit, hence the hysteresis.
+                Scalar mu = consts::G * (this->mass(i1_) + this->mass(i2_));
+                Scalar r = KS::norm2(u_);
+                Scalar a = -0.5 * mu / static_cast<Scalar>(h_);
+                Scalar e_cos = 1 - r / a;
+                Scalar e_sin = 2 * KS::dot(u_, up_) / sqrt(mu * a);
+                Scalar apo = a * (1 + sqrt(e_cos * e_cos + e_sin * e_sin)) / r;
+                Scalar gamma = relative_perturbation() * apo * apo * apo;
+                kepler_drift_ = gamma < (kepler_drift_ ? unperturbed_tol_ : 0.25 * unperturbed_tol_);
+            } else {
+                kepler_drift_ = false;
+            }
+        }
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    auto KSRegularizedSystem<Particles, Interactions, SlowDown>::kepler_drift(Scalar step_size) -> Scalar {
+        Scalar mu = consts::G * (this->mass(i1_) + this->mass(i2_));
+        Scalar h = h_;
+        Scalar a = -0.5 * mu / h;
+        Scalar e_cos = 1 - KS::norm2(u_) / a;
+        Scalar e_sin = 2 * KS::dot(u_, up_) / sqrt(mu * a);
+        Scalar E0 = atan2(e_sin, e_cos);
+        Scalar dt = a * step_size;
+        Scalar E1 =
+            orbit::solve_elliptic_kepler(E0 - e_sin + sqrt(mu / (a * a * a)) * dt, sqrt(e_cos * e_cos + e_sin * e_sin));
+
+        // u(s) = u0 cos(ws) + u0'/w sin(ws) with w^2 = -h/2 and 2ws the change of the eccentric anomaly
+        Scalar w = sqrt(-0.5 * h);
+        Scalar theta = 0.5 * (E1 - E0);
+        Scalar c = cos(theta);
+        Scalar sn = sin(theta);
+        for (size_t i = 0; i < 4; ++i) {
+            Scalar new_u = u_[i] * c + up_[i] / w * sn;
+            Scalar new_up = up_[i] * c - u_[i] * w * sn;
+            sync_ks_increment(ks_pos_offset(), i, new_u - u_[i]);
+            sync_ks_increment(ks_vel_offset(), i, new_up - up_[i]);
+            u_[i] = new_u;
+            up_[i] = new_up;
+        }
+        return dt;
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::kick_real_vel(Scalar step_size) {
+        if constexpr (Interactions::ext_vel_dep) {
+            write_cartesian_vel(aux_outer_vel_, aux_up_, aux_vel_);
+            std::swap(aux_vel_, this->vel());
+            eval_vel_dep_acc();
+            std::swap(aux_vel_, this->vel());
+            reduce_to_ks(accels_.acc());
+        }
+        Scalar r = KS::norm2(u_);
+        auto Q = KS::transpose_mul(u_, ks_pert_ * kappa_);
+        Scalar half_step = 0.5 * step_size;
+
+        // an unperturbed pair moves on its Kepler orbit entirely in the drift
+        if (!kepler_drift_) {
+            advance_kepler_energy(Q, half_step);
+            for (size_t i = 0; i < 4; ++i) {
+                Scalar dup = 0.5 * (h_ * u_[i] + r * Q[i]) * step_size;
+                up_[i] += dup;
+                sync_ks_increment(ks_vel_offset(), i, dup);
+            }
+            advance_kepler_energy(Q, half_step);
+        }
+
+        Scalar phy_time = step_size / step_scale();
+        calc::array_advance(outer_vel_, outer_acc_, phy_time);
+        sync_vel_increment(outer_acc_, phy_time);
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::kick_pseu_vel(Scalar step_size) {
+        if constexpr (Interactions::ext_vel_dep) {
+            Scalar r = KS::norm2(u_);
+            auto Q = KS::transpose_mul(u_, ks_pert_ * kappa_);
+            for (size_t i = 0; i < 4; ++i) {
+                Scalar dup = 0.5 * (h_ * u_[i] + r * Q[i]) * step_size;
+                aux_up_[i] += dup;
+                sync_ks_increment(ks_auxi_vel_offset(), i, dup);
+            }
+            calc::array_advance(aux_outer_vel_, outer_acc_, kappa_ * r * step_size);
+            sync_auxi_vel_increment(outer_acc_, kappa_ * r * step_size);
+        }
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    template <typename Array>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::sync_pos_increment(Array const &inc,
+                                                                                    Scalar step_size) {
+        if (sync_increment_) {
+            advance_scaled_coords_to(increment_.begin() + pos_offset(), inc, step_size);
+        }
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    template <typename Array>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::sync_vel_increment(Array const &inc,
+                                                                                    Scalar step_size) {
+        if (sync_increment_) {
+            advance_scaled_coords_to(increment_.begin() + vel_offset(), inc, step_size);
+        }
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    template <typename Array>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::sync_auxi_vel_increment(Array const &inc,
+                                                                                         Scalar step_size) {
+        if (sync_increment_) {
+            advance_scaled_coords_to(increment_.begin() + auxi_vel_offset(), inc, step_size);
+        }
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::sync_time_increment(Scalar phy_time) {
+        if (sync_increment_) {
+            increment_[time_offset()] += phy_time;
+        }
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, bool SlowDown>
+    void KSRegularizedSystem<Particles, Interactions, SlowDown>::sync_ks_increment(size_t offset, size_t i,
+                                                                                   Scalar inc) {
+        if (sync_increment_) {
+            increment_[offset + i] += inc;
+        }
+    }
+}  // namespace hub::system
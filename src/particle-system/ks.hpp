@@ -0,0 +1,174 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file ks.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <array>
+
+#include "../core-computation.hpp"
+
+namespace hub {
+
+    /*---------------------------------------------------------------------------*\
+          Class KS Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Static class for the Kustaanheimo-Stiefel transformation of a relative two-body vector.
+     *
+     * A 3D relative position R is represented by a 4D vector u with R = L(u)u and |R| = |u|^2. With the fictitious time
+     * s defined by dt = |R| ds the Kepler problem becomes the harmonic oscillator u'' = (h/2)u, where h is the specific
+     * Kepler energy. See Stiefel & Scheifele, Linear and Regular Celestial Mechanics (1971).
+     */
+    class KS {
+       public:
+        template <typename T>
+        using Vector4 = std::array<T, 4>;
+
+        // Constructors
+        SPACEHUB_MAKE_CONSTRUCTORS(KS, default, default, default, default, default);
+
+        /**
+         * @brief Squared norm of a 4D vector, which is also the separation |R| of the pair.
+         */
+        template <typename T>
+        static auto norm2(Vector4<T> const &u);
+
+        /**
+         * @brief Inner product of two 4D vectors.
+         */
+        template <typename T, typename U>
+        static auto dot(Vector4<T> const &u, Vector4<U> const &v);
+
+        /**
+         * @brief Cartesian relative position R = L(u)u.
+         *
+         * @tparam Vector 3D vector type of the output.
+         * @param[in] u KS position.
+         */
+        template <typename Vector, typename T>
+        static Vector to_cartesian_pos(Vector4<T> const &u);
+
+        /**
+         * @brief Cartesian relative velocity V = 2L(u)u'/|u|^2.
+         *
+         * @tparam Vector 3D vector type of the output.
+         * @param[in] u KS position.
+         * @param[in] up KS velocity, derivative of u with respect to the fictitious time.
+         */
+        template <typename Vector, typename T, typename U>
+        static Vector to_cartesian_vel(Vector4<T> const &u, Vector4<U> const &up);
+
+        /**
+         * @brief Transform a Cartesian relative position and velocity to KS variables.
+         *
+         * The free rotation of u is fixed by zeroing one component, the bilinear relation is satisfied by construction.
+         *
+         * @param[in] pos Cartesian relative position.
+         * @param[in] vel Cartesian relative velocity.
+         * @param[out] u KS position.
+         * @param[out] up KS velocity.
+         */
+        template <typename Vector, typename T>
+        static void from_cartesian(Vector const &pos, Vector const &vel, Vector4<T> &u, Vector4<T> &up);
+
+        /**
+         * @brief Product L^T(u)P of a 3D vector P (extended with a zero 4th component).
+         *
+         * With P the perturbing acceleration, the KS equations read u'' = (h/2)u + (|u|^2/2)L^T(u)P and
+         * h' = 2u'.L^T(u)P.
+         */
+        template <typename T, typename Vector>
+        static auto transpose_mul(Vector4<T> const &u, Vector const &P);
+
+        /**
+         * @brief Specific Kepler energy h = |V|^2/2 - mu/|R| from KS variables.
+         *
+         * @param[in] u KS position.
+         * @param[in] up KS velocity.
+         * @param[in] mu Gravitational parameter G(m1+m2).
+         */
+        template <typename T, typename U, typename Scalar>
+        static auto kepler_energy(Vector4<T> const &u, Vector4<U> const &up, Scalar mu);
+    };
+
+    /*---------------------------------------------------------------------------*\
+          Class KS Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename T>
+    auto KS::norm2(Vector4<T> const &u) {
+        return u[0] * u[0] + u[1] * u[1] + u[2] * u[2] + u[3] * u[3];
+    }
+
+    template <typename T, typename U>
+    auto KS::dot(Vector4<T> const &u, Vector4<U> const &v) {
+        return u[0] * v[0] + u[1] * v[1] + u[2] * v[2] + u[3] * v[3];
+    }
+
+    template <typename Vector, typename T>
+    Vector KS::to_cartesian_pos(Vector4<T> const &u) {
+        return Vector{u[0] * u[0] - u[1] * u[1] - u[2] * u[2] + u[3] * u[3], 2 * (u[0] * u[1] - u[2] * u[3]),
+                      2 * (u[0] * u[2] + u[1] * u[3])};
+    }
+
+    template <typename Vector, typename T, typename U>
+    Vector KS::to_cartesian_vel(Vector4<T> const &u, Vector4<U> const &up) {
+        auto scale = 2 / norm2(u);
+        return Vector{(u[0] * up[0] - u[1] * up[1] - u[2] * up[2] + u[3] * up[3]) * scale,
+                      (u[1] * up[0] + u[0] * up[1] - u[3] * up[2] - u[2] * up[3]) * scale,
+                      (u[2] * up[0] + u[3] * up[1] + u[0] * up[2] + u[1] * up[3]) * scale};
+    }
+
+    template <typename Vector, typename T>
+    void KS::from_cartesian(Vector const &pos, Vector const &vel, Vector4<T> &u, Vector4<T> &up) {
+        auto r = norm(pos);
+        if (pos.x >= 0) {
+            u[0] = sqrt(0.5 * (r + pos.x));
+            u[1] = 0.5 * pos.y / u[0];
+            u[2] = 0.5 * pos.z / u[0];
+            u[3] = 0;
+        } else {
+            u[1] = sqrt(0.5 * (r - pos.x));
+            u[0] = 0.5 * pos.y / u[1];
+            u[2] = 0;
+            u[3] = 0.5 * pos.z / u[1];
+        }
+        auto lv = transpose_mul(u, vel);
+        for (size_t i = 0; i < 4; ++i) {
+            up[i] = 0.5 * lv[i];
+        }
+    }
+
+    template <typename T, typename Vector>
+    auto KS::transpose_mul(Vector4<T> const &u, Vector const &P) {
+        using Scalar = typename Vector::value_type;
+        Scalar u0 = u[0], u1 = u[1], u2 = u[2], u3 = u[3];
+        return Vector4<Scalar>{u0 * P.x + u1 * P.y + u2 * P.z, -u1 * P.x + u0 * P.y + u3 * P.z,
+                               -u2 * P.x - u3 * P.y + u0 * P.z, u3 * P.x - u2 * P.y + u1 * P.z};
+    }
+
+    template <typename T, typename U, typename Scalar>
+    auto KS::kepler_energy(Vector4<T> const &u, Vector4<U> const &up, Scalar mu) {
+        return (2 * dot(up, up) - mu) / norm2(u);
+    }
+}  // namespace hub
@@ -30,6 +30,7 @@ License
 #include "../interaction/interaction.hpp"
 #include "../spacehub-concepts.hpp"
 #include "../type-class.hpp"
+#include "diagnostics.hpp"
 namespace hub::system {
     /**
      *
@@ -64,6 +65,15 @@ namespace hub::system {
         template <CONCEPT_PARTICLES_DATA Particles>
         Scalar eval_vel_phy_time(Particles const &particles, Scalar step_size);
 
+        /**
+         * @brief Same as eval_vel_phy_time(), with the potential energy already evaluated by the force pass.
+         *
+         * @param[in] potential Potential energy of the current positions.
+         * @param[in] step_size Step size in regularized time.
+         * @return Scalar Step size in physical time.
+         */
+        Scalar eval_vel_phy_time_from_potential(Scalar potential, Scalar step_size);
+
         template <typename Particles>
         inline StateScalar regu_function(Particles const &particles) const;
 
@@ -110,6 +120,15 @@ namespace hub::system {
         template <CONCEPT_PARTICLE_CONTAINER STL>
         RegularizedSystem(Scalar time, STL const &particle_set);
 
+        /**
+         * @brief Reinitialize the system with a new particle set, reusing the allocated memory.
+         *
+         * @param[in] time Initial time of the system.
+         * @param[in] particle_set Input particle set.
+         */
+        template <CONCEPT_PARTICLE_CONTAINER STL>
+        void reset(Scalar time, STL const &particle_set);
+
         // Static public members
 
         static constexpr bool ext_vel_dep{Interactions::ext_vel_dep};
@@ -147,6 +166,17 @@ namespace hub::system {
         template <typename ScalarIterable>
         void evaluate_general_derivative(ScalarIterable &dy_dh);
 
+        /**
+         * @brief Energy and angular momentum of the current state. Recomputed only if the state changed since the
+         * last query; the potential energy of the last kick is reused.
+         */
+        Diagnostics<TypeSet> const &diagnostics() const;
+
+        /**
+         * @brief Drop the cached diagnostics after modifying the state through the pos()/vel() accessors.
+         */
+        inline void invalidate_diagnostics() { diag_.invalidate(); };
+
         inline void collect_increment(bool sync) { sync_increment_ = sync; };
 
         void clear_increment() { calc::array_set_zero(increment_); };
@@ -212,6 +242,7 @@ namespace hub::system {
         StateScalarArray increment_;
         Regularization<TypeSet, RegType> regu_;
         std::conditional_t<Interactions::ext_vel_dep, StateVectorArray, Empty> aux_vel_;
+        mutable Diagnostics<TypeSet> diag_;
         bool sync_increment_{false};
     };
 
@@ -228,6 +259,28 @@ namespace hub::system {
         if constexpr (Interactions::ext_vel_dep) {
             aux_vel_ = this->vel();
         }
+        diag_.reset(*this);
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, ReguType RegType>
+    template <CONCEPT_PARTICLE_CONTAINER STL>
+    void RegularizedSystem<Particles, Interactions, RegType>::reset(Scalar time, const STL &particle_set) {
+        Particles::assign(time, particle_set);
+        accels_.resize(particle_set.size());
+        increment_.resize(this->variable_number());
+        calc::array_set_zero(increment_);
+        regu_ = Regularization<TypeSet, RegType>(*this);
+        if constexpr (Interactions::ext_vel_dep) {
+            aux_vel_ = this->vel();
+        }
+        sync_increment_ = false;
+        diag_.reset(*this);
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, ReguType RegType>
+    auto RegularizedSystem<Particles, Interactions, RegType>::diagnostics() const -> Diagnostics<TypeSet> const & {
+        diag_.update(*this);
+        return diag_;
     }
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, ReguType RegType>
@@ -250,6 +303,7 @@ namespace hub::system {
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, ReguType RegType>
     void RegularizedSystem<Particles, Interactions, RegType>::drift(Scalar step_size) {
+        diag_.invalidate();
         Scalar phy_time = regu_.eval_pos_phy_time(*this, step_size);
         calc::array_advance(this->pos(), this->vel(), phy_time);
         this->time() += phy_time;
@@ -259,11 +313,12 @@ namespace hub::system {
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, ReguType RegType>
     void RegularizedSystem<Particles, Interactions, RegType>::kick(Scalar step_size) {
-        Scalar phy_time = regu_.eval_vel_phy_time(*this, step_size);
-        Scalar half_time = 0.5 * phy_time;
-
+        diag_.invalidate_velocity();
         eval_vel_indep_acc();
 
+        Scalar phy_time = regu_.eval_vel_phy_time_from_potential(accels_.newtonian_potential(), step_size);
+        Scalar half_time = 0.5 * phy_time;
+
         if constexpr (Interactions::ext_vel_dep) {
             kick_real_vel(half_time);
             kick_pseu_vel(phy_time);
@@ -313,11 +368,14 @@ namespace hub::system {
         dy_dh.reserve(this->number() * 3 * (2 + static_cast<size_t>(Interactions::ext_vel_dep)) + 3);
 
         Scalar pos_regu = regu_.eval_pos_phy_time(*this, 1);
-        Scalar vel_regu = regu_.eval_vel_phy_time(*this, 1);
 
-        dy_dh.emplace_back(pos_regu);
+        Interactions::eval_newtonian_acc(*this, accels_.newtonian_acc(), accels_.newtonian_potential());
+
+        diag_.set_potential_energy(accels_.newtonian_potential());
 
-        Interactions::eval_newtonian_acc(*this, accels_.newtonian_acc());
+        Scalar vel_regu = regu_.eval_vel_phy_time_from_potential(accels_.newtonian_potential(), 1);
+
+        dy_dh.emplace_back(pos_regu);
 
         if constexpr (Interactions::ext_vel_indep || Interactions::ext_vel_dep) {
             Interactions::eval_extra_acc(*this, accels_.acc());
@@ -351,6 +409,7 @@ namespace hub::system {
             auto vel_end = begin + auxi_vel_offset();
             load_to_coords(pos_begin, pos_end, this->pos());
             load_to_coords(vel_begin, vel_end, this->vel());
+            diag_.invalidate();
             if constexpr (Interactions::ext_vel_dep) {
                 auto aux_vel_begin = begin + auxi_vel_offset();
                 auto aux_vel_end = y.end();
@@ -416,7 +475,8 @@ namespace hub::system {
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, ReguType RegType>
     void RegularizedSystem<Particles, Interactions, RegType>::eval_vel_indep_acc() {
-        Interactions::eval_newtonian_acc(*this, accels_.newtonian_acc());
+        Interactions::eval_newtonian_acc(*this, accels_.newtonian_acc(), accels_.newtonian_potential());
+        diag_.set_potential_energy(accels_.newtonian_potential());
 
         if constexpr (Interactions::ext_vel_indep) {
             Interactions::eval_extra_vel_indep_acc(*this, accels_.ext_vel_indep_acc());
@@ -499,8 +559,9 @@ namespace hub::system {
     template <typename TypeSystem, ReguType Type>
     template <typename Particles>
     Regularization<TypeSystem, Type>::Regularization(Particles const &particles) {
-        omega_ = capital_omega(particles);
-        bindE_ = -calc::calc_total_energy(particles);
+        Scalar potential = calc::calc_potential_energy(particles);
+        omega_ = -potential;
+        bindE_ = -(potential + calc::calc_kinetic_energy(particles));
         if constexpr (Type != ReguType::None) {
             scale_ = omega_;
         }
@@ -538,6 +599,18 @@ namespace hub::system {
         }
     }
 
+    template <typename TypeSystem, ReguType Type>
+    auto Regularization<TypeSystem, Type>::eval_vel_phy_time_from_potential(Scalar potential, Scalar step_size)
+        -> Scalar {
+        if constexpr (Type == ReguType::LogH || Type == ReguType::TTL) {
+            // Both the LogH scale -U and the TTL weight Omega = -U come directly from the potential.
+            scale_ = -potential;
+            return step_size / scale_;
+        } else {
+            return step_size;
+        }
+    }
+
     template <typename TypeSystem, ReguType Type>
     template <typename Particles>
     auto Regularization<TypeSystem, Type>::capital_omega(Particles const &particles) const -> StateScalar {
@@ -120,7 +120,7 @@ namespace hub::particles {
          * @brief Construct a new Size Particles object from std::ranges(Container).
          *
          * @tparam STL std::ranges(Container)
-         * @param[in] t Initial time of the the particle group.
+         * @param[in] t Initial time of the particle group.
          * @param[in] particle_set Input particle set.
          */
         template <CONCEPT_PARTICLE_CONTAINER STL>
@@ -151,6 +151,16 @@ namespace hub::particles {
 
         void clear();
 
+        /**
+         * @brief Replace the particles with a new particle set, reusing the allocated memory.
+         *
+         * @tparam STL std::ranges(Container)
+         * @param[in] time Initial time of the particle group.
+         * @param[in] particles_set Input particle set.
+         */
+        template <CONCEPT_PARTICLE_CONTAINER STL>
+        void assign(Scalar time, STL const &particles_set);
+
         std::string column_names() const;
 
         std::vector<Particle> to_AoS() const;
@@ -186,6 +196,13 @@ namespace hub::particles {
     template <typename TypeSystem>
     template <CONCEPT_PARTICLE_CONTAINER STL>
     SizeParticles<TypeSystem>::SizeParticles(Scalar time, const STL &particles_set) {
+        assign(time, particles_set);
+    }
+
+    template <typename TypeSystem>
+    template <CONCEPT_PARTICLE_CONTAINER STL>
+    void SizeParticles<TypeSystem>::assign(Scalar time, const STL &particles_set) {
+        this->clear();
         size_t input_num = particles_set.size();
         this->reserve(input_num);
         size_t id = 0;
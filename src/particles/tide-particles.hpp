@@ -152,6 +152,16 @@ namespace hub::particles {
 
         void clear();
 
+        /**
+         * @brief Replace the particles with a new particle set, reusing the allocated memory.
+         *
+         * @tparam STL std::ranges(Container)
+         * @param[in] t Initial time of the particle group.
+         * @param[in] particle_set Input particle set.
+         */
+        template <CONCEPT_PARTICLE_CONTAINER STL>
+        void assign(Scalar t, STL const &particle_set);
+
         std::string column_names() const;
 
         std::vector<Particle> to_AoS() const;
@@ -229,6 +239,13 @@ namespace hub::particles {
     template <typename TypeSystem>
     template <CONCEPT_PARTICLE_CONTAINER STL>
     TideParticles<TypeSystem>::TideParticles(Scalar t, const STL &particle_set) {
+        assign(t, particle_set);
+    }
+
+    template <typename TypeSystem>
+    template <CONCEPT_PARTICLE_CONTAINER STL>
+    void TideParticles<TypeSystem>::assign(Scalar t, const STL &particle_set) {
+        this->clear();
         size_t input_num = particle_set.size();
         this->reserve(input_num);
         size_t id = 0;
@@ -24,10 +24,15 @@ License
  */
 #pragma once
 
+#include <array>
 #include <cmath>
+#include <cstdint>
 #include <functional>
+#include <limits>
 #include <random>
+#include <utility>
 
+#include "macros.hpp"
 #include "math.hpp"
 #include "multi-thread/multi-thread.hpp"
 
@@ -37,6 +42,200 @@ License
  */
 namespace hub::random {
 
+    /*---------------------------------------------------------------------------*\
+         Class Philox Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Counter based random number generator (Philox4x32-10, Salmon et al. 2011).
+     *
+     * The n-th 64-bit output of a stream is a pure function of (seed, task id, n), so independent tasks get
+     * reproducible, non-overlapping streams regardless of which thread runs them or in which order. The whole state is
+     * 32 bytes. Satisfies the UniformRandomBitGenerator requirement, thus can also be used with <random>
+     * distributions.
+     */
+    class Philox {
+       public:
+        using result_type = uint64_t;
+        using Block = std::array<uint32_t, 4>;
+        using Key = std::array<uint32_t, 2>;
+
+        Philox() = default;
+
+        /**
+         * @brief Construct a new stream.
+         *
+         * @param[in] seed Campaign seed.
+         * @param[in] task_id Stream(task) index.
+         * @param[in] draw_index Index of the first 64-bit output.
+         */
+        inline explicit Philox(uint64_t seed, uint64_t task_id = 0, uint64_t draw_index = 0);
+
+        static constexpr result_type min() { return 0; }
+
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        /**
+         * @brief The 64-bit output at the current draw index. Advances the draw index by one.
+         */
+        inline result_type operator()();
+
+        /**
+         * @brief Double uniformly distributed in [0, 1) with 53 random bits. Advances the draw index by one.
+         */
+        inline double uniform();
+
+        /**
+         * @brief Standard normal variate. Consumes two draws per pair of calls.
+         */
+        inline double normal();
+
+        /**
+         * @brief Fill an array with doubles uniformly distributed in [low, high).
+         *
+         * @tparam ScalarArray Contiguous array like type.
+         * @param[out] array Output array. Its size decides the number of draws.
+         */
+        template <typename ScalarArray>
+        void fill_uniform(ScalarArray &array, double low = 0, double high = 1);
+
+        /**
+         * @brief Fill an array with normal variates.
+         *
+         * @tparam ScalarArray Contiguous array like type.
+         * @param[out] array Output array. Its size decides the number of draws.
+         */
+        template <typename ScalarArray>
+        void fill_normal(ScalarArray &array, double mean = 0, double sigma = 1);
+
+        /**
+         * @brief Reset the stream to (seed, task_id) and rewind it to draw_index.
+         */
+        inline void seed(uint64_t seed, uint64_t task_id = 0, uint64_t draw_index = 0);
+
+        /**
+         * @brief Move the stream to an arbitrary draw index in O(1).
+         */
+        inline void seek(uint64_t draw_index);
+
+        /**
+         * @brief Skip n draws in O(1).
+         */
+        inline void discard(uint64_t n);
+
+        [[nodiscard]] inline uint64_t draw_index() const { return index_; }
+
+        [[nodiscard]] inline uint64_t task_id() const { return task_; }
+
+        /**
+         * @brief The bare Philox4x32-10 bijection.
+         */
+        static inline Block bijection(Block ctr, Key key);
+
+        /**
+         * @brief Stateless access to the 64-bit output at (seed, task_id, draw_index).
+         */
+        static inline result_type draw(uint64_t seed, uint64_t task_id, uint64_t draw_index);
+
+        static inline double to_unit(result_type x) { return static_cast<double>(x >> 11) * 0x1.0p-53; }
+
+       private:
+        static inline Block make_counter(uint64_t task_id, uint64_t block_index);
+
+        template <typename Callback>
+        void generate(size_t n, Callback &&func);
+
+        Key key_{0, 0};
+        uint64_t task_{0};
+        uint64_t index_{0};
+        double spare_normal_{0};
+        bool has_spare_{false};
+    };
+
+    /**
+     * @brief The generator used by the free sampling functions below on the calling thread. Each thread starts from a
+     * non-deterministic seed; call seed_thread_generator() at the beginning of a task for reproducible sampling.
+     */
+    inline Philox &thread_generator() {
+        static thread_local Philox generator{(static_cast<uint64_t>(std::random_device{}()) << 32) |
+                                             std::random_device{}()};
+        return generator;
+    }
+
+    /**
+     * @brief Key the calling thread's generator to (seed, task_id). Every sampling function called afterwards on this
+     * thread draws from that stream.
+     *
+     * @param[in] seed Campaign seed.
+     * @param[in] task_id Task index.
+     */
+    inline void seed_thread_generator(uint64_t seed, uint64_t task_id = 0) { thread_generator().seed(seed, task_id); }
+
+    /*---------------------------------------------------------------------------*\
+         Class TruncatedNormalQuantile Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Inverse CDF of the normal distribution truncated into [low, high].
+     *
+     * The window constants are computed once at construction, each quantile then costs a few Newton iterations
+     * regardless of the acceptance rate a rejection sampler would have. Windows that lie entirely in one tail are
+     * inverted through the logarithm of the survival function, so windows far in the tail (where 1 - CDF underflows)
+     * are sampled exactly too.
+     */
+    class TruncatedNormalQuantile {
+       public:
+        /**
+         * @param[in] low The lower limit of the distribution.
+         * @param[in] high The higher limit of the distribution.
+         * @param[in] mean The mean value of the untruncated normal distribution.
+         * @param[in] sigma The standard deviation of the untruncated normal distribution.
+         */
+        inline TruncatedNormalQuantile(double low, double high, double mean = 0, double sigma = 1);
+
+        /**
+         * @brief Map a uniform number in [0, 1) to the truncated distribution.
+         */
+        inline double operator()(double u) const;
+
+       private:
+        double mean_;
+        double sigma_;
+        double low_;
+        double high_;
+        double p_low_{0};
+        double p_high_{0};
+        bool tail_{false};
+        bool mirror_{false};
+    };
+
+    /*---------------------------------------------------------------------------*\
+         Class TruncatedMaxwellianQuantile Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Inverse CDF of the Maxwellian distribution truncated into [low, high]. See TruncatedNormalQuantile.
+     */
+    class TruncatedMaxwellianQuantile {
+       public:
+        /**
+         * @param[in] low The lower limit of the distribution.
+         * @param[in] high The higher limit of the distribution.
+         * @param[in] sigma_1d The 1D dispersion of the Maxwellian distribution.
+         */
+        inline TruncatedMaxwellianQuantile(double low, double high, double sigma_1d);
+
+        /**
+         * @brief Map a uniform number in [0, 1) to the truncated distribution.
+         */
+        inline double operator()(double u) const;
+
+       private:
+        double sigma_;
+        double low_;
+        double high_;
+        double p_low_{0};
+        double p_high_{0};
+        bool tail_{false};
+    };
+
     /**
      * @brief Uniform distributed random number generator
      *
@@ -45,9 +244,7 @@ namespace hub::random {
      * @return double The generated number.
      */
     inline static double Uniform(double low, double high) {
-        static thread_local std::mt19937 generator{std::random_device{}()};
-        std::uniform_real_distribution<double> dist{low, high};
-        return dist(generator);
+        return low + (high - low) * thread_generator().uniform();
     }
 
     /**
@@ -58,11 +255,9 @@ namespace hub::random {
      * @return double The generated number.
      */
     inline static double Logarithm(double low, double high) {
-        static thread_local std::mt19937 generator{std::random_device{}()};
         double log_low = log10(low);
         double log_high = log10(high);
-        std::uniform_real_distribution<double> dist{log_low, log_high};
-        return pow(10, dist(generator));
+        return pow(10, Uniform(log_low, log_high));
     }
 
     /**
@@ -74,13 +269,11 @@ namespace hub::random {
      * @return double The generated number.
      */
     inline static double PowerLaw(double power, double low, double high) {
-        static thread_local std::mt19937 generator{std::random_device{}()};
         if (!math::iseq(power, -1.0)) {
             double beta = power + 1;
             double f_low = pow(low, beta);
             double f_high = pow(high, beta);
-            std::uniform_real_distribution<double> dist{f_low, f_high};
-            return pow(dist(generator), 1.0 / beta);
+            return pow(Uniform(f_low, f_high), 1.0 / beta);
         } else {
             return Logarithm(low, high);
         }
@@ -94,9 +287,7 @@ namespace hub::random {
      * @return double The generated number.
      */
     inline static double Normal(double mean = 0, double sigma = 1) {
-        static thread_local std::mt19937 generator{std::random_device{}()};
-        std::normal_distribution<double> dist{mean, sigma};
-        return dist(generator);
+        return mean + sigma * thread_generator().normal();
     }
 
     /**
@@ -109,15 +300,7 @@ namespace hub::random {
      * @return double The generated number.
      */
     inline static double TruncatedNormal(double low, double high, double mean = 0, double sigma = 1) {
-        static thread_local std::mt19937 generator{std::random_device{}()};
-        std::normal_distribution<double> dist{mean, sigma};
-        // TODO: can be optimized by using inverse transformed method.
-        for (;;) {
-            auto r = dist(generator);
-            if (low <= r && r <= high) {
-                return r;
-            }
-        }
+        return TruncatedNormalQuantile{low, high, mean, sigma}(thread_generator().uniform());
     }
 
     /**
@@ -127,11 +310,9 @@ namespace hub::random {
      * @return double The generated number.
      */
     inline static double Maxwellian(double sigma_1d) {
-        static thread_local std::mt19937 generator{std::random_device{}()};
-        std::normal_distribution<double> dist{0.0, sigma_1d};
-        double x = dist(generator);
-        double y = dist(generator);
-        double z = dist(generator);
+        double x = Normal(0.0, sigma_1d);
+        double y = Normal(0.0, sigma_1d);
+        double z = Normal(0.0, sigma_1d);
         return sqrt(x * x + y * y + z * z);
     }
 
@@ -144,18 +325,43 @@ namespace hub::random {
      * @return double The generated number.
      */
     inline static double TruncatedMaxwellian(double low, double high, double sigma_1d) {
-        static thread_local std::mt19937 generator{std::random_device{}()};
-        std::normal_distribution<double> dist{0.0, sigma_1d};
-        // TODO: can be optimized by using inverse transformed method.
-        for (;;) {
-            double x = dist(generator);
-            double y = dist(generator);
-            double z = dist(generator);
-            double r = sqrt(x * x + y * y + z * z);
-            if (low <= r && r <= high) {
-                return r;
-            }
-        }
+        return TruncatedMaxwellianQuantile{low, high, sigma_1d}(thread_generator().uniform());
+    }
+
+    /**
+     * @brief Fill an array with uniform variates from the calling thread's generator.
+     */
+    template <typename ScalarArray>
+    void fill_uniform(ScalarArray &array, double low = 0, double high = 1) {
+        thread_generator().fill_uniform(array, low, high);
+    }
+
+    /**
+     * @brief Fill an array with normal variates from the calling thread's generator.
+     */
+    template <typename ScalarArray>
+    void fill_normal(ScalarArray &array, double mean = 0, double sigma = 1) {
+        thread_generator().fill_normal(array, mean, sigma);
+    }
+
+    /**
+     * @brief Fill an array with truncated normal variates from the calling thread's generator.
+     */
+    template <typename ScalarArray>
+    void fill_truncated_normal(ScalarArray &array, double low, double high, double mean = 0, double sigma = 1) {
+        thread_generator().fill_uniform(array);
+        TruncatedNormalQuantile quantile{low, high, mean, sigma};
+        for (auto &x : array) x = quantile(x);
+    }
+
+    /**
+     * @brief Fill an array with truncated Maxwellian variates from the calling thread's generator.
+     */
+    template <typename ScalarArray>
+    void fill_truncated_maxwellian(ScalarArray &array, double low, double high, double sigma_1d) {
+        thread_generator().fill_uniform(array);
+        TruncatedMaxwellianQuantile quantile{low, high, sigma_1d};
+        for (auto &x : array) x = quantile(x);
     }
 
     inline double Fixed(double x) { return x; }
@@ -185,4 +391,266 @@ namespace hub::random {
         std::function<double()> dist_;
     };
 
+    /*---------------------------------------------------------------------------*\
+         Class Philox Implementation
+    \*---------------------------------------------------------------------------*/
+    Philox::Philox(uint64_t seed, uint64_t task_id, uint64_t draw_index) { this->seed(seed, task_id, draw_index); }
+
+    void Philox::seed(uint64_t seed, uint64_t task_id, uint64_t draw_index) {
+        key_ = {static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)};
+        task_ = task_id;
+        index_ = draw_index;
+        has_spare_ = false;
+    }
+
+    void Philox::seek(uint64_t draw_index) {
+        index_ = draw_index;
+        has_spare_ = false;
+    }
+
+    void Philox::discard(uint64_t n) { seek(index_ + n); }
+
+    Philox::Block Philox::make_counter(uint64_t task_id, uint64_t block_index) {
+        return {static_cast<uint32_t>(block_index), static_cast<uint32_t>(block_index >> 32),
+                static_cast<uint32_t>(task_id), static_cast<uint32_t>(task_id >> 32)};
+    }
+
+    Philox::Block Philox::bijection(Block ctr, Key key) {
+        constexpr uint64_t M0 = 0xD2511F53;
+        constexpr uint64_t M1 = 0xCD9E8D57;
+        constexpr uint32_t W0 = 0x9E3779B9;
+        constexpr uint32_t W1 = 0xBB67AE85;
+        for (size_t round = 0; round < 10; ++round) {
+            uint64_t const p0 = M0 * ctr[0];
+            uint64_t const p1 = M1 * ctr[2];
+            ctr = {static_cast<uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0], static_cast<uint32_t>(p1),
+                   static_cast<uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1], static_cast<uint32_t>(p0)};
+            key[0] += W0;
+            key[1] += W1;
+        }
+        return ctr;
+    }
+
+    Philox::result_type Philox::draw(uint64_t seed, uint64_t task_id, uint64_t draw_index) {
+        auto out = bijection(make_counter(task_id, draw_index >> 1),
+                             {static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)});
+        size_t const half = (draw_index & 1) << 1;
+        return (static_cast<uint64_t>(out[half + 1]) << 32) | out[half];
+    }
+
+    Philox::result_type Philox::operator()() {
+        auto out = bijection(make_counter(task_, index_ >> 1), key_);
+        size_t const half = (index_ & 1) << 1;
+        index_++;
+        return (static_cast<uint64_t>(out[half + 1]) << 32) | out[half];
+    }
+
+    double Philox::uniform() { return to_unit((*this)()); }
+
+    double Philox::normal() {
+        if (has_spare_) {
+            has_spare_ = false;
+            return spare_normal_;
+        }
+        // Box-Muller on one counter block: both halves of the block are consumed at once.
+        double u1 = 1.0 - uniform();
+        double u2 = uniform();
+        double r = sqrt(-2.0 * log(u1));
+        spare_normal_ = r * sin(2 * consts::pi * u2);
+        has_spare_ = true;
+        return r * cos(2 * consts::pi * u2);
+    }
+
+    template <typename Callback>
+    void Philox::generate(size_t n, Callback &&func) {
+        // Each counter block yields two 64-bit draws; blocks are independent so the loop has no carried dependency.
+        size_t k = 0;
+        if ((index_ & 1) && n > 0) {
+            func(k++, (*this)());
+        }
+        size_t const pairs = (n - k) / 2;
+        uint64_t const block0 = index_ >> 1;
+        for (size_t b = 0; b < pairs; ++b, k += 2) {
+            auto out = bijection(make_counter(task_, block0 + b), key_);
+            func(k, (static_cast<uint64_t>(out[1]) << 32) | out[0]);
+            func(k + 1, (static_cast<uint64_t>(out[3]) << 32) | out[2]);
+        }
+        index_ += 2 * pairs;
+        if (k < n) {
+            func(k, (*this)());
+        }
+    }
+
+    template <typename ScalarArray>
+    void Philox::fill_uniform(ScalarArray &array, double low, double high) {
+        double const width = high - low;
+        generate(array.size(), [&](size_t k, result_type x) { array[k] = low + width * to_unit(x); });
+    }
+
+    template <typename ScalarArray>
+    void Philox::fill_normal(ScalarArray &array, double mean, double sigma) {
+        size_t const n = array.size();
+        fill_uniform(array);
+        for (size_t k = 0; k + 1 < n; k += 2) {
+            double r = sqrt(-2.0 * log(1.0 - array[k]));
+            double phi = 2 * consts::pi * array[k + 1];
+            array[k] = mean + sigma * r * cos(phi);
+            array[k + 1] = mean + sigma * r * sin(phi);
+        }
+        if (n & 1) {
+            array[n - 1] = mean + sigma * normal();
+        }
+    }
+    /*---------------------------------------------------------------------------*\
+         Class TruncatedNormalQuantile Implementation
+    \*---------------------------------------------------------------------------*/
+    namespace detail {
+        inline constexpr double sqrt_2 = 1.41421356237309504880;
+        inline constexpr double log_sqrt_2pi = 0.91893853320467274178;
+        inline constexpr double sqrt_2_over_pi = 0.79788456080286535588;
+        /// Truncation of the standardized distributions where the CDF is one to double precision.
+        inline constexpr double std_cut = 40;
+
+        /**
+         * @brief Mills ratio Q(x)/phi(x) of the standard normal distribution for x >= 0.
+         */
+        inline double mills_ratio(double x) {
+            if (x < 8) {
+                return std::erfc(x / sqrt_2) * std::exp(0.5 * x * x) / sqrt_2_over_pi;
+            } else {  // Laplace continued fraction
+                double r = x;
+                for (size_t k = 40; k > 0; --k) {
+                    r = x + static_cast<double>(k) / r;
+                }
+                return 1 / r;
+            }
+        }
+
+        /**
+         * @brief log of the upper tail probability of the standard normal distribution for x >= 0.
+         */
+        inline double log_normal_survival(double x) { return -0.5 * x * x - log_sqrt_2pi + std::log(mills_ratio(x)); }
+
+        inline double normal_cdf(double x) { return 0.5 * std::erfc(-x / sqrt_2); }
+
+        /**
+         * @brief CDF of the standard Maxwellian distribution, series form is used below x = 2 to avoid cancellation.
+         */
+        inline double maxwellian_cdf(double x) {
+            if (x < 2) {
+                double term = x;
+                double sum = 0;
+                for (size_t k = 1; k < 64; ++k) {
+                    term *= x * x / static_cast<double>(2 * k + 1);
+                    sum += term;
+                    if (term < sum * math::epsilon_v<double>) break;
+                }
+                return sqrt_2_over_pi * std::exp(-0.5 * x * x) * sum;
+            } else {
+                return std::erf(x / sqrt_2) - sqrt_2_over_pi * x * std::exp(-0.5 * x * x);
+            }
+        }
+
+        /**
+         * @brief log of the upper tail probability of the standard Maxwellian distribution.
+         */
+        inline double log_maxwellian_survival(double x) {
+            return std::log(sqrt_2_over_pi * (x + mills_ratio(x))) - 0.5 * x * x;
+        }
+
+        inline double maxwellian_pdf(double x) { return sqrt_2_over_pi * x * x * std::exp(-0.5 * x * x); }
+
+        /**
+         * @brief Target log survival probability of the u-quantile in a window whose ends have log survival s_low and
+         * s_high.
+         */
+        inline double log_survival_target(double s_low, double s_high, double u) {
+            return s_low + std::log1p(u * std::expm1(s_high - s_low));
+        }
+    }  // namespace detail
+
+    TruncatedNormalQuantile::TruncatedNormalQuantile(double low, double high, double mean, double sigma)
+        : mean_{mean}, sigma_{sigma} {
+        DEBUG_MODE_ASSERT(low <= high && sigma > 0, "Invalid truncated normal distribution!");
+        double a = (low - mean) / sigma;
+        double b = (high - mean) / sigma;
+        if (b <= 0) {  // mirror the lower tail into the upper one
+            mirror_ = true;
+            std::swap(a, b);
+            a = -a, b = -b;
+        }
+        tail_ = a >= 0;
+        if (tail_) {
+            low_ = a;
+            high_ = math::min(b, a + detail::std_cut);
+            p_low_ = detail::log_normal_survival(low_);
+            p_high_ = detail::log_normal_survival(high_);
+        } else {
+            low_ = math::max(a, -detail::std_cut);
+            high_ = math::min(b, detail::std_cut);
+            p_low_ = detail::normal_cdf(low_);
+            p_high_ = detail::normal_cdf(high_);
+        }
+    }
+
+    double TruncatedNormalQuantile::operator()(double u) const {
+        double x;
+        if (tail_) {
+            double c = detail::log_survival_target(p_low_, p_high_, u);
+            x = math::root_safe_newton(
+                [=](double y) {
+                    double m = detail::mills_ratio(y);
+                    return std::make_pair(c - (-0.5 * y * y - detail::log_sqrt_2pi + std::log(m)), 1 / m);
+                },
+                low_, high_, low_);
+        } else {
+            double p = p_low_ + u * (p_high_ - p_low_);
+            x = math::root_safe_newton(
+                [=](double y) {
+                    return std::make_pair(detail::normal_cdf(y) - p,
+                                          std::exp(-0.5 * y * y - detail::log_sqrt_2pi));
+                },
+                low_, high_, 0.0);
+        }
+        return mean_ + sigma_ * (mirror_ ? -x : x);
+    }
+
+    /*---------------------------------------------------------------------------*\
+         Class TruncatedMaxwellianQuantile Implementation
+    \*---------------------------------------------------------------------------*/
+    TruncatedMaxwellianQuantile::TruncatedMaxwellianQuantile(double low, double high, double sigma_1d)
+        : sigma_{sigma_1d} {
+        DEBUG_MODE_ASSERT(low <= high && sigma_1d > 0, "Invalid truncated Maxwellian distribution!");
+        low_ = math::max(low / sigma_1d, 0.0);
+        high_ = math::min(high / sigma_1d, low_ + detail::std_cut);
+        // Beyond the median the window is inverted through the log survival function.
+        tail_ = low_ >= 1.5;
+        if (tail_) {
+            p_low_ = detail::log_maxwellian_survival(low_);
+            p_high_ = detail::log_maxwellian_survival(high_);
+        } else {
+            p_low_ = detail::maxwellian_cdf(low_);
+            p_high_ = detail::maxwellian_cdf(high_);
+        }
+    }
+
+    double TruncatedMaxwellianQuantile::operator()(double u) const {
+        double x;
+        if (tail_) {
+            double c = detail::log_survival_target(p_low_, p_high_, u);
+            x = math::root_safe_newton(
+                [=](double y) {
+                    double m = detail::mills_ratio(y);
+                    return std::make_pair(c - (std::log(detail::sqrt_2_over_pi * (y + m)) - 0.5 * y * y),
+                                          y * y / (y + m));
+                },
+                low_, high_, low_);
+        } else {
+            double p = p_low_ + u * (p_high_ - p_low_);
+            x = math::root_safe_newton(
+                [=](double y) { return std::make_pair(detail::maxwellian_cdf(y) - p, detail::maxwellian_pdf(y)); },
+                low_, high_, std::cbrt(3 * p / detail::sqrt_2_over_pi));
+        }
+        return sigma_ * x;
+    }
 }  // namespace hub::random
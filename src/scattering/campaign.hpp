@@ -0,0 +1,449 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file campaign.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "../dev-tools.hpp"
+#include "../math.hpp"
+#include "../rand-generator.hpp"
+#include "../taskflow/taskflow.hpp"
+#include "journal.hpp"
+#include "result-cache.hpp"
+
+namespace hub::scattering {
+
+    /**
+     * @brief Initial condition of one scattering run.
+     *
+     * @tparam Particle Particle type of the solver.
+     */
+    template <typename Particle>
+    struct InitialCondition {
+        std::vector<Particle> particles;
+
+        /** @brief Integration time of the run.*/
+        typename Particle::Scalar end_time{0};
+
+        /** @brief Index of the run, set by the Campaign.*/
+        size_t run{0};
+    };
+
+    /*---------------------------------------------------------------------------*\
+         Class OutcomeCounts Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Default result accumulator of a Campaign: number of runs per outcome.
+     *
+     * @tparam Outcome Ordered outcome type, e.g. an enum or a string.
+     */
+    template <typename Outcome>
+    struct OutcomeCounts {
+        std::map<Outcome, size_t> counts;
+
+        size_t runs{0};
+
+        void add(Outcome const &outcome) {
+            counts[outcome]++;
+            runs++;
+        }
+
+        void merge(OutcomeCounts const &other) {
+            for (auto const &[outcome, n] : other.counts) {
+                counts[outcome] += n;
+            }
+            runs += other.runs;
+        }
+
+        [[nodiscard]] size_t count(Outcome const &outcome) const {
+            auto it = counts.find(outcome);
+            return it == counts.end() ? 0 : it->second;
+        }
+
+        /**
+         * @brief Fraction of the runs that ended in the outcome.
+         */
+        [[nodiscard]] double fraction(Outcome const &outcome) const {
+            return runs == 0 ? 0.0 : static_cast<double>(count(outcome)) / static_cast<double>(runs);
+        }
+
+        /**
+         * @brief One sigma binomial error of fraction().
+         */
+        [[nodiscard]] double fraction_error(Outcome const &outcome) const {
+            double p = fraction(outcome);
+            return runs == 0 ? 0.0 : std::sqrt(p * (1 - p) / static_cast<double>(runs));
+        }
+    };
+
+    /*---------------------------------------------------------------------------*\
+         Class Campaign Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Run a large number of independent scatterings on all cores and collect their outcomes.
+     *
+     * Every run is scheduled on its own on a work stealing pool, so long runs at the end of a campaign do not leave
+     * the other cores idle. The thread generator is keyed to (seed, run index) before the sampler is called, so the
+     * initial conditions, and therefore the results, do not depend on the scheduling. Outcomes are added to one
+     * accumulator per worker and the accumulators are merged once all runs finished, so counting the outcomes needs no
+     * lock.
+     *
+     * With a cost predictor the runs are started in the order of decreasing predicted cost, so the expensive
+     * resonant encounters do not end up as stragglers at the tail of the campaign. The order is fixed before the first
+     * run. Only the budget is calibrated online: the finished runs give the number of steps per unit of predicted
+     * cost, a single scale that could not change the ranking anyway. With a budget, a run that takes more than
+     * `budget` times its expected step count is stopped and split out of the result. Its index is listed in
+     * overruns() and can be finished later with run(std::vector<size_t> const&), which exempts the overruns of the
+     * previous call from the budget.
+     *
+     * With a Journal, every finished run is logged with its outcome, and the runs already in the journal are skipped
+     * and counted from it, so a campaign killed halfway resumes from where it stopped with the same result. The run
+     * that fills a batch of the journal writes and fsyncs it outside of the record lock.
+     *
+     * With a ResultCache, runs equivalent to an already simulated initial condition up to a rescaling of mass, length
+     * and time are answered without integration.
+     *
+     * @code{.cpp}
+     *  scattering::Campaign<methods::BS<>, Outcome> campaign(sample, classify);
+     *  campaign.set_progress([](size_t done, size_t total) { ... });
+     *  auto result = campaign.run(1000000);
+     *  result.fraction(Outcome::exchange);
+     * @endcode
+     *
+     * @tparam Solver Simulator type.
+     * @tparam Outcome Outcome type returned by the classifier.
+     * @tparam Accumulator Result type, with add(Outcome) and merge(Accumulator) methods.
+     */
+    template <typename Solver, typename Outcome = int, typename Accumulator = OutcomeCounts<Outcome>>
+    class Campaign {
+       public:
+        // Type members
+        using Particle = typename Solver::Particle;
+
+        using Scalar = typename Solver::Scalar;
+
+        using System = typename Solver::ParticleSystem;
+
+        using RunArgs = typename Solver::RunArgs;
+
+        using IC = InitialCondition<Particle>;
+
+        /** @brief Draws the initial condition of the given run.*/
+        using Sampler = std::function<IC(size_t)>;
+
+        /** @brief Maps the final state of a run to its outcome.*/
+        using Classifier = std::function<Outcome(System const &, IC const &)>;
+
+        /** @brief Extra stop condition of the runs, in addition to the end time.*/
+        using StopCondition = std::function<bool(System &, Scalar)>;
+
+        /** @brief Called with the number of finished runs and the total number.*/
+        using Progress = std::function<void(size_t, size_t)>;
+
+        /** @brief Predicts the relative cost of a run from its initial condition, e.g. scattering::encounter_cost.*/
+        using CostPredictor = std::function<double(IC const &)>;
+
+        using Cache = ResultCache<Outcome>;
+
+        using RunJournal = Journal<Outcome>;
+
+        SPACEHUB_READ_ACCESSOR(std::vector<size_t>, overruns, overruns_);
+
+        // Constructors
+        Campaign(Sampler sampler, Classifier classifier);
+
+        // Public methods
+        /**
+         * @brief Execute the campaign.
+         *
+         * @param[in] run_num Number of runs. The runs are indexed by 0...run_num-1.
+         * @return The merged result of all runs that were not split out.
+         */
+        Accumulator run(size_t run_num);
+
+        /**
+         * @brief Execute the given runs of the campaign.
+         *
+         * The runs listed in overruns() by the previous call are run to the end regardless of the budget.
+         *
+         * @param[in] run_ids Indices of the runs, e.g. the overruns() of a previous call.
+         * @return The merged result of all runs that were not split out.
+         */
+        Accumulator run(std::vector<size_t> const &run_ids);
+
+        void set_stop_condition(StopCondition stop) { stop_ = std::move(stop); };
+
+        void set_progress(Progress progress, double interval = 1.0) {
+            progress_ = std::move(progress);
+            progress_interval_ = interval;
+        };
+
+        void set_cost_predictor(CostPredictor predictor) { predictor_ = std::move(predictor); };
+
+        /**
+         * @brief Split out the runs that take more than `budget` times their expected step count. Zero disables it.
+         */
+        void set_budget(double budget) { budget_ = budget; };
+
+        /**
+         * @brief Answer the runs whose initial condition is equivalent to a cached one from the cache.
+         *
+         * The cache is shared, e.g. by the campaigns of a sweep over mass or velocity scales. It is bypassed if the
+         * interactions of the Solver are not scale free, e.g. with post-Newtonian or tidal forces.
+         */
+        void set_cache(std::shared_ptr<Cache> cache) { cache_ = std::move(cache); };
+
+        /**
+         * @brief Log the finished runs to the journal and skip the runs it already holds for the current seed.
+         */
+        void set_journal(std::shared_ptr<RunJournal> journal) { journal_ = std::move(journal); };
+
+        void set_seed(uint64_t seed) { seed_ = seed; };
+
+        void set_thread_num(size_t thread_num) { thread_num_ = thread_num; };
+
+        void set_rtol(Scalar rtol) { rtol_ = rtol; };
+
+        void set_atol(Scalar atol) { atol_ = atol; };
+
+       private:
+        // Private methods
+        std::optional<Outcome> simulate(size_t run_id, double cost, bool budgeted, size_t &steps,
+                                        std::optional<Solver> &solver);
+
+        // Private members
+        /** @brief Accumulator and reused simulator of one worker, on its own cache line.*/
+        struct alignas(64) Slot {
+            Accumulator acc;
+            std::vector<size_t> overruns;
+            std::optional<Solver> solver;
+        };
+
+        /** @brief Number of finished runs before the steps per cost are calibrated and the budget is enforced.*/
+        static constexpr size_t calibration_runs_{16};
+
+        Sampler sampler_;
+
+        Classifier classifier_;
+
+        StopCondition stop_;
+
+        Progress progress_;
+
+        CostPredictor predictor_;
+
+        std::shared_ptr<Cache> cache_;
+
+        std::shared_ptr<RunJournal> journal_;
+
+        std::vector<size_t> overruns_;
+
+        std::atomic<size_t> calib_runs_{0};
+
+        std::atomic<size_t> calib_steps_{0};
+
+        std::atomic<double> calib_cost_{0};
+
+        double progress_interval_{1.0};
+
+        double budget_{0};
+
+        uint64_t seed_{0};
+
+        size_t thread_num_{std::thread::hardware_concurrency()};
+
+        Scalar rtol_{1e-14};
+
+        Scalar atol_{0};
+    };
+
+    /*---------------------------------------------------------------------------*\
+         Class Campaign Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename Solver, typename Outcome, typename Accumulator>
+    Campaign<Solver, Outcome, Accumulator>::Campaign(Sampler sampler, Classifier classifier)
+        : sampler_{std::move(sampler)}, classifier_{std::move(classifier)} {}
+
+    template <typename Solver, typename Outcome, typename Accumulator>
+    std::optional<Outcome> Campaign<Solver, Outcome, Accumulator>::simulate(size_t run_id, double cost, bool budgeted,
+                                                                            size_t &steps,
+                                                                            std::optional<Solver> &solver) {
+        random::seed_thread_generator(seed_, run_id);
+        IC ic = sampler_(run_id);
+        ic.run = run_id;
+
+        typename Cache::Key key;
+        if constexpr (System::Interaction::scale_free) {
+            if (cache_) {
+                key = cache_->key(ic.particles, ic.end_time);
+                if (auto outcome = cache_->find(key)) {
+                    return outcome;
+                }
+            }
+        }
+
+        size_t max_steps = math::max_value<size_t>::value;
+        if (budgeted && budget_ > 0 && calib_runs_.load(std::memory_order_relaxed) >= calibration_runs_) {
+            double steps_per_cost = static_cast<double>(calib_steps_.load(std::memory_order_relaxed)) /
+                                    calib_cost_.load(std::memory_order_relaxed);
+            max_steps = static_cast<size_t>(budget_ * steps_per_cost * cost) + 1;
+        }
+
+        // a cold reset is bit-identical to a new simulator, so reusing it keeps the results independent of the schedule
+        if (solver) {
+            solver->reset(0, ic.particles);
+        } else {
+            solver.emplace(0, ic.particles);
+        }
+        RunArgs args;
+        args.rtol = rtol_;
+        args.atol = atol_;
+        args.add_stop_condition(ic.end_time);
+
+        steps = 0;
+        args.add_stop_condition([&](System &, Scalar) { return ++steps > max_steps; });
+        if (stop_) {
+            args.add_stop_condition(stop_);
+        }
+        solver->run(args);
+
+        if (steps > max_steps) {
+            return std::nullopt;
+        }
+
+        calib_steps_.fetch_add(steps, std::memory_order_relaxed);
+        for (double c = calib_cost_.load(); !calib_cost_.compare_exchange_weak(c, c + cost);) {
+        }
+        calib_runs_.fetch_add(1, std::memory_order_relaxed);
+
+        Outcome outcome = classifier_(solver->particles(), ic);
+        if constexpr (System::Interaction::scale_free) {
+            if (cache_) {
+                cache_->insert(key, outcome);
+            }
+        }
+        return outcome;
+    }
+
+    template <typename Solver, typename Outcome, typename Accumulator>
+    Accumulator Campaign<Solver, Outcome, Accumulator>::run(size_t run_num) {
+        std::vector<size_t> run_ids(run_num);
+        std::iota(run_ids.begin(), run_ids.end(), 0);
+        return run(run_ids);
+    }
+
+    template <typename Solver, typename Outcome, typename Accumulator>
+    Accumulator Campaign<Solver, Outcome, Accumulator>::run(std::vector<size_t> const &all_run_ids) {
+        Accumulator result;
+        std::vector<size_t> run_ids;
+        run_ids.reserve(all_run_ids.size());
+        for (auto id : all_run_ids) {
+            if (auto outcome = journal_ ? journal_->find(seed_, id) : std::nullopt) {
+                result.add(*outcome);
+            } else {
+                run_ids.push_back(id);
+            }
+        }
+
+        size_t const run_num = run_ids.size();
+        size_t const done_num = all_run_ids.size() - run_num;
+        tf::Executor executor{thread_num_ > 0 ? thread_num_ : 1};
+        std::vector<Slot> slots(executor.num_workers());
+        std::atomic<size_t> finished{done_num};
+
+        calib_runs_ = 0;
+        calib_steps_ = 0;
+        calib_cost_ = 0;
+
+        // the sampler is cheap and deterministic per run, so the predictions are made from a first draw of the initial
+        // conditions and only the costs are kept
+        // the previous overruns already took more than their budget once
+        std::vector<bool> budgeted(run_num);
+        for (size_t i = 0; i < run_num; ++i) {
+            budgeted[i] = !std::binary_search(overruns_.begin(), overruns_.end(), run_ids[i]);
+        }
+
+        std::vector<double> costs(run_num, 1.0);
+        std::vector<size_t> order(run_num);
+        std::iota(order.begin(), order.end(), 0);
+        if (predictor_) {
+            tf::Taskflow predict;
+            predict.for_each_index(static_cast<size_t>(0), run_num, static_cast<size_t>(1), [&](size_t i) {
+                random::seed_thread_generator(seed_, run_ids[i]);
+                costs[i] = predictor_(sampler_(run_ids[i]));
+            });
+            executor.run(predict).wait();
+            std::stable_sort(order.begin(), order.end(), [&](size_t i, size_t j) { return costs[i] > costs[j]; });
+        }
+
+        tf::Taskflow taskflow;
+        taskflow.for_each_index_dynamic(static_cast<size_t>(0), run_num, static_cast<size_t>(1), [&](size_t k) {
+            size_t i = order[k];
+            auto &slot = slots[static_cast<size_t>(executor.this_worker_id())];
+            size_t steps = 0;
+            if (auto outcome = simulate(run_ids[i], costs[i], budgeted[i], steps, slot.solver)) {
+                slot.acc.add(*outcome);
+                if (journal_) {
+                    journal_->append(seed_, run_ids[i], *outcome, steps);
+                }
+            } else {
+                slot.overruns.push_back(run_ids[i]);
+            }
+            finished.fetch_add(1, std::memory_order_relaxed);
+        });
+
+        auto future = executor.run(taskflow);
+        auto interval = std::chrono::duration<double>(progress_interval_);
+        while (future.wait_for(interval) != std::future_status::ready) {
+            if (progress_) {
+                progress_(finished.load(std::memory_order_relaxed), all_run_ids.size());
+            }
+        }
+        if (progress_) {
+            progress_(finished.load(), all_run_ids.size());
+        }
+        if (journal_) {
+            journal_->flush();
+        }
+
+        overruns_.clear();
+        for (auto const &slot : slots) {
+            result.merge(slot.acc);
+            overruns_.insert(overruns_.end(), slot.overruns.begin(), slot.overruns.end());
+        }
+        std::sort(overruns_.begin(), overruns_.end());
+        return result;
+    }
+}  // namespace hub::scattering
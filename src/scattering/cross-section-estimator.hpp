@@ -0,0 +1,328 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file cross-section-estimator.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "../rand-generator.hpp"
+#include "campaign.hpp"
+
+namespace hub::scattering {
+
+    /**
+     * @brief Cross sections with their one sigma errors.
+     *
+     * @tparam Outcome Ordered outcome type.
+     */
+    template <typename Outcome>
+    struct CrossSections {
+        std::map<Outcome, double> sigma;
+
+        std::map<Outcome, double> variance;
+
+        size_t runs{0};
+
+        [[nodiscard]] double cross_section(Outcome const &outcome) const {
+            auto it = sigma.find(outcome);
+            return it == sigma.end() ? 0.0 : it->second;
+        }
+
+        [[nodiscard]] double error(Outcome const &outcome) const {
+            auto it = variance.find(outcome);
+            return it == variance.end() ? 0.0 : std::sqrt(it->second);
+        }
+    };
+
+    /*---------------------------------------------------------------------------*\
+         Class CrossSectionEstimator Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Estimate cross sections with runs stratified in the impact parameter.
+     *
+     * The disk b < b_max is split into annuli of equal area. After a pilot round with the same number of runs in each
+     * annulus, every round adds a batch of runs, allocated to bring the annuli towards the Neyman allocation
+     * n_h ~ A_h sqrt(sum_t p_ht(1-p_ht)/(eps_t sigma_t)^2) for the target outcomes t. The outer annuli where nothing
+     * happens therefore get very few runs, and the annuli that straddle the edge of a cross section get most of them.
+     * The estimation stops once every target reaches its relative error, or at the maximum number of runs.
+     *
+     * The runs are executed by a Campaign, which can be configured through campaign(). The run index encodes the
+     * annulus, so the estimates are reproducible for a given seed.
+     *
+     * @tparam Solver Simulator type.
+     * @tparam Outcome Outcome type returned by the classifier.
+     */
+    template <typename Solver, typename Outcome = int>
+    class CrossSectionEstimator {
+       public:
+        // Type members
+        using Scalar = typename Solver::Scalar;
+
+        using System = typename Solver::ParticleSystem;
+
+        using IC = InitialCondition<typename Solver::Particle>;
+
+        /** @brief Draws the initial condition of a run for the given impact parameter, e.g. with incident_orbit_at().*/
+        using Sampler = std::function<IC(Scalar, size_t)>;
+
+        /** @brief Maps the final state of a run to its outcome.*/
+        using Classifier = std::function<Outcome(System const &, IC const &)>;
+
+        using RunCampaign = Campaign<Solver, std::pair<size_t, Outcome>>;
+
+        // Constructors
+        /**
+         * @param[in] sampler Initial condition sampler.
+         * @param[in] classifier Outcome classifier.
+         * @param[in] b_max Maximum impact parameter.
+         * @param[in] strata_num Number of annuli.
+         */
+        CrossSectionEstimator(Sampler sampler, Classifier classifier, Scalar b_max, size_t strata_num = 16);
+
+        // Public methods
+        /**
+         * @brief Require the relative error of the cross section of the outcome.
+         */
+        void add_target(Outcome const &outcome, double rel_error) { targets_[outcome] = rel_error; };
+
+        void set_pilot_runs(size_t runs) { pilot_runs_ = runs; };
+
+        void set_batch_runs(size_t runs) { batch_runs_ = runs; };
+
+        void set_max_runs(size_t runs) { max_runs_ = runs; };
+
+        /**
+         * @brief The campaign that executes the runs, to set the seed, thread number, tolerances, stop conditions...
+         */
+        RunCampaign &campaign() { return campaign_; };
+
+        /**
+         * @brief Run until the targets are reached.
+         */
+        CrossSections<Outcome> run();
+
+        /**
+         * @brief Estimate of the runs executed so far.
+         *
+         * The variances use the smoothed fractions (k + 1/2) / (n + 1) of every annulus, so annuli where an outcome was
+         * never or always seen still contribute to its error. Targets that were never seen have a zero cross section
+         * with a finite error.
+         */
+        [[nodiscard]] CrossSections<Outcome> estimate() const;
+
+        [[nodiscard]] std::vector<size_t> const &strata_runs() const { return runs_; };
+
+       private:
+        // Private methods
+        [[nodiscard]] Scalar stratum_area() const {
+            return consts::pi * b_max_ * b_max_ / static_cast<Scalar>(strata_num_);
+        };
+
+        [[nodiscard]] double smoothed_fraction(size_t h, Outcome const &outcome) const;
+
+        [[nodiscard]] bool converged(CrossSections<Outcome> const &result) const;
+
+        std::vector<size_t> allocate(size_t batch, CrossSections<Outcome> const &result) const;
+
+        void execute(std::vector<size_t> const &alloc);
+
+        // Private members
+        Scalar b_max_;
+
+        size_t strata_num_;
+
+        Sampler sampler_;
+
+        RunCampaign campaign_;
+
+        std::map<Outcome, double> targets_;
+
+        std::vector<std::map<Outcome, size_t>> counts_;
+
+        std::vector<size_t> runs_;
+
+        std::vector<size_t> next_;
+
+        size_t pilot_runs_{32};
+
+        size_t batch_runs_{1024};
+
+        size_t max_runs_{1000000};
+    };
+
+    /*---------------------------------------------------------------------------*\
+         Class CrossSectionEstimator Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename Solver, typename Outcome>
+    CrossSectionEstimator<Solver, Outcome>::CrossSectionEstimator(Sampler sampler, Classifier classifier, Scalar b_max,
+                                                                  size_t strata_num)
+        : b_max_{b_max},
+          strata_num_{strata_num},
+          sampler_{std::move(sampler)},
+          campaign_{[this](size_t run) {
+                        size_t h = run % strata_num_;
+                        Scalar b2 = b_max_ * b_max_ / static_cast<Scalar>(strata_num_);
+                        Scalar b = sqrt(random::Uniform(b2 * h, b2 * (h + 1)));
+                        return sampler_(b, run);
+                    },
+                    [this, classify = std::move(classifier)](System const &ptc, IC const &ic) {
+                        return std::pair{ic.run % strata_num_, classify(ptc, ic)};
+                    }},
+          counts_(strata_num),
+          runs_(strata_num, 0),
+          next_(strata_num, 0) {}
+
+    template <typename Solver, typename Outcome>
+    void CrossSectionEstimator<Solver, Outcome>::execute(std::vector<size_t> const &alloc) {
+        std::vector<size_t> run_ids;
+        for (size_t h = 0; h < strata_num_; ++h) {
+            for (size_t k = 0; k < alloc[h]; ++k) {
+                run_ids.emplace_back((next_[h]++) * strata_num_ + h);
+            }
+        }
+        auto result = campaign_.run(run_ids);
+        for (auto const &[key, n] : result.counts) {
+            counts_[key.first][key.second] += n;
+            runs_[key.first] += n;
+        }
+    }
+
+    template <typename Solver, typename Outcome>
+    double CrossSectionEstimator<Solver, Outcome>::smoothed_fraction(size_t h, Outcome const &outcome) const {
+        auto it = counts_[h].find(outcome);
+        double k = it == counts_[h].end() ? 0.0 : static_cast<double>(it->second);
+        return (k + 0.5) / (static_cast<double>(runs_[h]) + 1);
+    }
+
+    template <typename Solver, typename Outcome>
+    CrossSections<Outcome> CrossSectionEstimator<Solver, Outcome>::estimate() const {
+        CrossSections<Outcome> result;
+        for (auto const &[outcome, rel_error] : targets_) {
+            result.sigma[outcome] = 0;
+        }
+        for (auto const &counts : counts_) {
+            for (auto const &[outcome, k] : counts) {
+                result.sigma[outcome] = 0;
+            }
+        }
+        double const area = stratum_area();
+        for (size_t h = 0; h < strata_num_; ++h) {
+            result.runs += runs_[h];
+            if (runs_[h] == 0) {
+                continue;
+            }
+            double n = static_cast<double>(runs_[h]);
+            for (auto &[outcome, sigma] : result.sigma) {
+                auto it = counts_[h].find(outcome);
+                sigma += it == counts_[h].end() ? 0.0 : area * static_cast<double>(it->second) / n;
+                double p = smoothed_fraction(h, outcome);
+                result.variance[outcome] += area * area * p * (1 - p) / n;
+            }
+        }
+        return result;
+    }
+
+    template <typename Solver, typename Outcome>
+    bool CrossSectionEstimator<Solver, Outcome>::converged(CrossSections<Outcome> const &result) const {
+        for (auto const &[outcome, rel_error] : targets_) {
+            double sigma = result.cross_section(outcome);
+            if (sigma == 0 || result.error(outcome) > rel_error * sigma) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename Solver, typename Outcome>
+    std::vector<size_t> CrossSectionEstimator<Solver, Outcome>::allocate(size_t batch,
+                                                                         CrossSections<Outcome> const &result) const {
+        // Neyman weights with Laplace smoothed fractions, so annuli without any event still get a few runs. A target
+        // that has not been seen yet is scaled by its smoothed cross section, an upper bound of the order of one event.
+        double const area = stratum_area();
+        std::vector<double> weight(strata_num_, 0);
+        double weight_sum = 0;
+        for (auto const &[outcome, rel_error] : targets_) {
+            double sigma = result.cross_section(outcome);
+            if (sigma == 0) {
+                for (size_t h = 0; h < strata_num_; ++h) {
+                    sigma += area * smoothed_fraction(h, outcome);
+                }
+            }
+            double scale = rel_error * sigma;
+            for (size_t h = 0; h < strata_num_; ++h) {
+                double p = smoothed_fraction(h, outcome);
+                weight[h] += p * (1 - p) / (scale * scale);
+            }
+        }
+        for (size_t h = 0; h < strata_num_; ++h) {
+            weight[h] = std::sqrt(weight[h]);
+            weight_sum += weight[h];
+        }
+
+        double total = static_cast<double>(batch + result.runs);
+        std::vector<double> deficit(strata_num_, 0);
+        double deficit_sum = 0;
+        for (size_t h = 0; h < strata_num_; ++h) {
+            deficit[h] = math::max(total * weight[h] / weight_sum - static_cast<double>(runs_[h]), 0.0);
+            deficit_sum += deficit[h];
+        }
+        if (!(deficit_sum > 0) || !std::isfinite(deficit_sum)) {
+            // degenerate weights, e.g. a zero relative error, spread the batch evenly
+            std::fill(deficit.begin(), deficit.end(), 1.0);
+            deficit_sum = static_cast<double>(strata_num_);
+        }
+
+        std::vector<size_t> alloc(strata_num_, 0);
+        size_t assigned = 0;
+        for (size_t h = 0; h < strata_num_; ++h) {
+            alloc[h] = static_cast<size_t>(static_cast<double>(batch) * deficit[h] / deficit_sum);
+            assigned += alloc[h];
+        }
+        for (size_t h = 0; assigned < batch; h = (h + 1) % strata_num_) {
+            if (deficit[h] > 0) {
+                alloc[h]++;
+                assigned++;
+            }
+        }
+        return alloc;
+    }
+
+    template <typename Solver, typename Outcome>
+    CrossSections<Outcome> CrossSectionEstimator<Solver, Outcome>::run() {
+        if (targets_.empty()) {
+            spacehub_abort("No target outcome is given to the cross section estimator!");
+        }
+        execute(std::vector<size_t>(strata_num_, pilot_runs_));
+        auto result = estimate();
+        for (; !converged(result) && result.runs < max_runs_;) {
+            execute(allocate(math::min(batch_runs_, max_runs_ - result.runs), result));
+            result = estimate();
+        }
+        return result;
+    }
+}  // namespace hub::scattering
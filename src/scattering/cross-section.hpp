@@ -72,6 +72,50 @@ namespace hub::scattering {
         return critical_vel(M_stay, M_incident, E_inner1, E_inner2);
     }
 
+    /**
+     * @brief Estimate the relative integration cost of an encounter between two clusters(can be single particle).
+     *
+     * The cost is measured in inner dynamical times of the tightest cluster, the step count of the integrators is
+     * roughly proportional to it. Close encounters below the critical velocity can form a resonant system with many
+     * hard interactions, they are charged (v_c/v_inf)^2 extra dynamical times, capped at 100. Only the ordering of the
+     * estimates is meaningful.
+     *
+     * @tparam Cluster1 std::ranges(Container) with element type has public member `mass`(Scalar), `pos`(Vector) and
+     * `vel`(Vector)./Type of single particle.
+     * @tparam Cluster2 std::ranges(Container) with element type has public member `mass`(Scalar), `pos`(Vector) and
+     * `vel`(Vector)./Type of single particle.
+     * @tparam Scalar Floating point like type.
+     * @param[in] stay_cluster The scattered cluster.
+     * @param[in] incident_cluster The incident cluster.
+     * @param[in] duration Integration time of the encounter.
+     * @return The estimated cost.
+     */
+    template <typename Cluster1, typename Cluster2, typename Scalar>
+    auto encounter_cost(Cluster1 const& stay_cluster, Cluster2 const& incident_cluster, Scalar duration) {
+        auto const M_stay = orbit::M_tot(stay_cluster);
+        auto const M_incident = orbit::M_tot(incident_cluster);
+        auto const R1 = orbit::cluster_size(stay_cluster);
+        auto const R2 = orbit::cluster_size(incident_cluster);
+
+        auto t_dyn = duration;
+        if (R1 > 0) t_dyn = math::min(t_dyn, sqrt(R1 * R1 * R1 / (consts::G * M_stay)));
+        if (R2 > 0) t_dyn = math::min(t_dyn, sqrt(R2 * R2 * R2 / (consts::G * M_incident)));
+
+        auto const u = consts::G * (M_stay + M_incident);
+        auto const dr = orbit::COM_p(stay_cluster) - orbit::COM_p(incident_cluster);
+        auto const dv = orbit::COM_v(stay_cluster) - orbit::COM_v(incident_cluster);
+        auto const [a, e] = orbit::calc_a_e(u, dr, dv);
+        auto const r_p = a * (1 - e);
+
+        Scalar resonance = 0;
+        if (r_p < 3 * (R1 + R2)) {
+            auto const v_c = critical_vel(stay_cluster, incident_cluster);
+            auto const v_inf2 = dot(dv, dv) - 2 * u / norm(dr);
+            resonance = v_inf2 > v_c * v_c * 1e-2 ? v_c * v_c / v_inf2 : static_cast<Scalar>(100);
+        }
+        return duration / t_dyn + resonance;
+    }
+
     /*template <typename Scalar>
     auto b_max(Scalar v_c, Scalar v_inf, Scalar a_max) {
       return a_max * (8 * v_c / v_inf + 3);
@@ -102,6 +146,25 @@ namespace hub::scattering {
         return b_max(M_stay + M_incident, v_inf, rp_max);
     }
 
+    /**
+     * @brief Create an incident orbit with the given impact parameter and a random orientation of the impact
+     * parameter vector.
+     *
+     * @tparam Scalar Floating point like type.
+     * @param[in] m_stay The mass of the scattered object.
+     * @param[in] m_incident The mass of the incident object.
+     * @param[in] v_inf The relative velocity at infinity between scattering objects.
+     * @param[in] b The impact parameter.
+     * @param[in] r The relative distance between the centre of mass between two objects. The incident object will
+     * launch at this distance.
+     * @return The incident hyperbolic orbit.
+     */
+    template <typename Scalar>
+    auto incident_orbit_at(Scalar m_stay, Scalar m_incident, Scalar v_inf, Scalar b, Scalar r) {
+        auto w = random::Uniform(0, 2 * consts::pi);
+        return orbit::Hyperbolic(m_stay, m_incident, v_inf, b, w, 0.0, 0.0, r, orbit::Hyper::in);
+    }
+
     /**
      * @brief Randomly create an incident orbit that its infinity incident end is uniformly distributed in a circle area
      * with radius b_max.
@@ -118,8 +181,7 @@ namespace hub::scattering {
     template <typename Scalar>
     auto incident_orbit(Scalar m_stay, Scalar m_incident, Scalar v_inf, Scalar b_max, Scalar r) {
         auto b = sqrt(random::Uniform(0, b_max * b_max));
-        auto w = random::Uniform(0, 2 * consts::pi);
-        return orbit::Hyperbolic(m_stay, m_incident, v_inf, b, w, 0.0, 0.0, r, orbit::Hyper::in);
+        return incident_orbit_at(m_stay, m_incident, v_inf, b, r);
     }
 
     /**
@@ -0,0 +1,201 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file far-field.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <algorithm>
+
+#include "../dev-tools.hpp"
+#include "../orbits/orbits.hpp"
+#include "../orbits/particle-manip.hpp"
+
+/**
+ * @namespace hub::scattering
+ * namespace for scattering
+ */
+namespace hub::scattering {
+
+    /**
+     * @brief Advance the internal motion of a cluster(can be single particle) as unperturbed Kepler orbits.
+     *
+     * A binary is advanced exactly. In larger clusters every member is advanced on its two-body orbit around the most
+     * massive member, which is accurate for planetary systems but not for strongly interacting multiples. The centre
+     * of mass of the cluster is not changed.
+     *
+     * @tparam Cluster std::ranges(Container) with element type has public member `mass`(Scalar), `pos`(Vector) and
+     * `vel`(Vector)./Type of single particle.
+     * @tparam Scalar Floating point like type.
+     * @param[in,out] cluster The cluster.
+     * @param[in] dt Time to advance.
+     */
+    template <typename Cluster, typename Scalar>
+    void advance_cluster(Cluster &cluster, Scalar dt) {
+        if constexpr (is_ranges_v<Cluster>) {
+            if (cluster.size() < 2) {
+                return;
+            }
+            auto const cm_pos = orbit::COM_p(cluster);
+            auto const cm_vel = orbit::COM_v(cluster);
+
+            auto host = std::max_element(cluster.begin(), cluster.end(),
+                                         [](auto const &x, auto const &y) { return x.mass < y.mass; });
+            for (auto &p : cluster) {
+                if (&p != &*host) {
+                    auto dr = p.pos - host->pos;
+                    auto dv = p.vel - host->vel;
+                    orbit::kepler_advance(consts::G * (host->mass + p.mass), dr, dv, dt);
+                    p.pos = host->pos + dr;
+                    p.vel = host->vel + dv;
+                }
+            }
+            orbit::move_particles(cm_pos, cm_vel, cluster);
+        }
+    }
+
+    /**
+     * @brief Propagate two clusters(can be single particle) analytically by the given time.
+     *
+     * The centres of mass move on their two-body Kepler orbit and the internal motion is advanced by advance_cluster().
+     * The tidal field between the clusters is neglected, so the clusters should be further apart than their tidal
+     * radius(see interaction_radius()).
+     *
+     * @tparam Cluster1 std::ranges(Container) with element type has public member `mass`(Scalar), `pos`(Vector) and
+     * `vel`(Vector)./Type of single particle.
+     * @tparam Cluster2 std::ranges(Container) with element type has public member `mass`(Scalar), `pos`(Vector) and
+     * `vel`(Vector)./Type of single particle.
+     * @tparam Scalar Floating point like type.
+     * @param[in,out] cluster1 The first cluster/single particle.
+     * @param[in,out] cluster2 The second cluster/single particle.
+     * @param[in] dt Time to advance.
+     */
+    template <typename Cluster1, typename Cluster2, typename Scalar>
+    void kepler_propagate(Cluster1 &cluster1, Cluster2 &cluster2, Scalar dt) {
+        auto const m1 = orbit::M_tot(cluster1);
+        auto const m2 = orbit::M_tot(cluster2);
+        auto const M = m1 + m2;
+        auto const p1 = orbit::COM_p(cluster1);
+        auto const p2 = orbit::COM_p(cluster2);
+        auto const v1 = orbit::COM_v(cluster1);
+        auto const v2 = orbit::COM_v(cluster2);
+
+        auto const cm_vel = (m1 * v1 + m2 * v2) / M;
+        auto const cm_pos = (m1 * p1 + m2 * p2) / M + cm_vel * dt;
+        auto dr = p2 - p1;
+        auto dv = v2 - v1;
+        orbit::kepler_advance(consts::G * M, dr, dv, dt);
+
+        advance_cluster(cluster1, dt);
+        advance_cluster(cluster2, dt);
+        orbit::move_particles(cm_pos - m2 / M * dr, cm_vel - m2 / M * dv, cluster1);
+        orbit::move_particles(cm_pos + m1 / M * dr, cm_vel + m1 / M * dv, cluster2);
+    }
+
+    /**
+     * @brief Separation between two clusters(can be single particle) below which their tidal factor(see
+     * orbit::tidal_factor) exceeds `tidal_tol`. Outside of it they can be propagated by kepler_propagate().
+     *
+     * @tparam Cluster1 std::ranges(Container) with element type has public member `mass`(Scalar), `pos`(Vector) and
+     * `vel`(Vector)./Type of single particle.
+     * @tparam Cluster2 std::ranges(Container) with element type has public member `mass`(Scalar), `pos`(Vector) and
+     * `vel`(Vector)./Type of single particle.
+     * @tparam Scalar Floating point like type.
+     * @param[in] cluster1 The first cluster/single particle.
+     * @param[in] cluster2 The second cluster/single particle.
+     * @param[in] tidal_tol Tolerance of the tidal factor.
+     * @return The interaction radius.
+     */
+    template <typename Cluster1, typename Cluster2, typename Scalar>
+    auto interaction_radius(Cluster1 const &cluster1, Cluster2 const &cluster2, Scalar tidal_tol) {
+        return orbit::tidal_radius(tidal_tol, orbit::M_tot(cluster1), orbit::M_tot(cluster2),
+                                   orbit::cluster_size(cluster1), orbit::cluster_size(cluster2));
+    }
+
+    /**
+     * @brief Time for two approaching clusters(can be single particle) to reach the given separation between their
+     * centres of mass.
+     *
+     * @tparam Cluster1 std::ranges(Container) with element type has public member `mass`(Scalar), `pos`(Vector) and
+     * `vel`(Vector)./Type of single particle.
+     * @tparam Cluster2 std::ranges(Container) with element type has public member `mass`(Scalar), `pos`(Vector) and
+     * `vel`(Vector)./Type of single particle.
+     * @tparam Scalar Floating point like type.
+     * @param[in] cluster1 The first cluster/single particle.
+     * @param[in] cluster2 The second cluster/single particle.
+     * @param[in] r Target separation.
+     * @return The time. If the periapsis is outside of `r`, the time to the periapsis. Zero if the clusters are
+     * already closer than `r` or receding.
+     */
+    template <typename Cluster1, typename Cluster2, typename Scalar>
+    auto time_to_radius(Cluster1 const &cluster1, Cluster2 const &cluster2, Scalar r) {
+        auto const u = consts::G * (orbit::M_tot(cluster1) + orbit::M_tot(cluster2));
+        auto const dr = orbit::COM_p(cluster2) - orbit::COM_p(cluster1);
+        auto const dv = orbit::COM_v(cluster2) - orbit::COM_v(cluster1);
+        auto const r0 = norm(dr);
+        auto const rv = dot(dr, dv);
+        if (r0 <= r || rv >= 0) {
+            return static_cast<decltype(r0)>(0);
+        }
+
+        auto const a = -u / (norm2(dv) - 2 * u / r0);
+        auto const e_cos0 = 1 - r0 / a;
+        if (a > 0) {
+            auto const e_sin0 = rv / sqrt(u * a);
+            auto const e = sqrt(e_cos0 * e_cos0 + e_sin0 * e_sin0);
+            auto const E0 = atan2(e_sin0, e_cos0);
+            auto const E1 = -acos(math::min((1 - r / a) / e, static_cast<decltype(e)>(1)));
+            return (E1 - e * sin(E1) - E0 + e_sin0) / sqrt(u / (a * a * a));
+        } else {
+            auto const e_sinh0 = rv / sqrt(-u * a);
+            auto const e = sqrt(e_cos0 * e_cos0 - e_sinh0 * e_sinh0);
+            auto const H0 = atanh(e_sinh0 / e_cos0);
+            auto const H1 = -acosh(math::max((1 - r / a) / e, static_cast<decltype(e)>(1)));
+            return (e * sinh(H1) - H1 - e_sinh0 + H0) / sqrt(-u / (a * a * a));
+        }
+    }
+
+    /**
+     * @brief Propagate two approaching clusters(can be single particle) analytically until the separation of their
+     * centres of mass is `r`, or until their periapsis if they never come that close.
+     *
+     * Use it after incident_orbit() to skip the integration of the far field approach, with `r` from
+     * interaction_radius(). The departure can be skipped in the same way by stopping the integration once the outcome
+     * is settled(see OutcomeSettled) and calling kepler_propagate() on the two outgoing clusters.
+     *
+     * @tparam Cluster1 std::ranges(Container) with element type has public member `mass`(Scalar), `pos`(Vector) and
+     * `vel`(Vector)./Type of single particle.
+     * @tparam Cluster2 std::ranges(Container) with element type has public member `mass`(Scalar), `pos`(Vector) and
+     * `vel`(Vector)./Type of single particle.
+     * @tparam Scalar Floating point like type.
+     * @param[in,out] cluster1 The first cluster/single particle.
+     * @param[in,out] cluster2 The second cluster/single particle.
+     * @param[in] r Target separation.
+     * @return The elapsed time.
+     */
+    template <typename Cluster1, typename Cluster2, typename Scalar>
+    auto approach(Cluster1 &cluster1, Cluster2 &cluster2, Scalar r) {
+        auto dt = time_to_radius(cluster1, cluster2, r);
+        kepler_propagate(cluster1, cluster2, dt);
+        return dt;
+    }
+}  // namespace hub::scattering
@@ -25,7 +25,14 @@ License
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
 
+#include "../dev-tools.hpp"
+#include "../math.hpp"
 #include "../orbits/orbits.hpp"
 #include "../vector/vector3.hpp"
 
@@ -35,122 +42,415 @@ License
  */
 namespace hub::scattering {
 
+    /**
+     * @brief Two-body interaction time: the smaller of the encounter time r/|v| and the dynamical time
+     * sqrt(R^3/(G M)), where R is the apocentre a(1+e) of a bound pair (so that a binary keeps its interaction time
+     * along the orbit) and the separation r otherwise.
+     */
     template <typename Vector>
-    class HierarchicalNode {
+    double interaction_time(double mass, Vector const &dr, Vector const &dv) {
+        double GM = consts::G * mass;
+        double r = static_cast<double>(norm(dr));
+        double v = static_cast<double>(norm(dv));
+        auto [a, e] = orbit::calc_a_e(GM, dr, dv);
+        double R = 0 < a ? static_cast<double>(a * (1 + e)) : r;
+        double t = sqrt(R * R * R / GM);
+        return v * t > r ? r / v : t;
+    }
+
+    /**
+     * @brief Partition bodies into compact subsystems that have to be integrated together.
+     *
+     * Two bodies are linked if their interaction_time() is shorter than `link_time` (close encounters, strongly
+     * interacting groups) or if they are each other's strongest partner and their interaction time is shorter than
+     * `isolation` times the interaction time of their centre of mass with any third body (isolated binaries at any
+     * scale). Subsystems are the connected components of the links.
+     *
+     * @tparam ScalarArray Type of the mass array.
+     * @tparam VectorArray Type of the position/velocity arrays.
+     * @tparam IdxArray Type of the output index array.
+     * @param[in] mass Masses of the bodies.
+     * @param[in] pos Positions of the bodies.
+     * @param[in] vel Velocities of the bodies.
+     * @param[in] link_time Interaction time below which two bodies are always linked.
+     * @param[in] isolation Ratio of inner to outer interaction time below which a pair is linked.
+     * @param[out] group Subsystem index of each body. Indices are assigned in order of the first member.
+     * @return size_t Number of subsystems (single bodies included).
+     */
+    template <typename ScalarArray, typename VectorArray, typename IdxArray>
+    size_t find_subsystems(ScalarArray const &mass, VectorArray const &pos, VectorArray const &vel, double link_time,
+                           double isolation, IdxArray &group) {
+        size_t const num = mass.size();
+        std::vector<size_t> partner(num, num);
+        std::vector<double> partner_time(num, math::max_value<double>::value);
+        group.resize(num);
+        for (size_t i = 0; i < num; ++i) {
+            group[i] = i;
+        }
+
+        auto root = [&](size_t i) {
+            while (group[i] != i) {
+                group[i] = group[group[i]];
+                i = group[i];
+            }
+            return i;
+        };
+
+        for (size_t i = 0; i < num; ++i) {
+            for (size_t j = i + 1; j < num; ++j) {
+                double t = interaction_time(static_cast<double>(mass[i] + mass[j]), pos[j] - pos[i], vel[j] - vel[i]);
+                if (t < link_time) {
+                    group[root(i)] = root(j);
+                }
+                if (t < partner_time[i]) {
+                    partner_time[i] = t;
+                    partner[i] = j;
+                }
+                if (t < partner_time[j]) {
+                    partner_time[j] = t;
+                    partner[j] = i;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < num; ++i) {
+            size_t j = partner[i];
+            if (j < i && partner[j] == i) {
+                double M = static_cast<double>(mass[i] + mass[j]);
+                auto com_pos = (mass[i] * pos[i] + mass[j] * pos[j]) / M;
+                auto com_vel = (mass[i] * vel[i] + mass[j] * vel[j]) / M;
+                double outer_time = math::max_value<double>::value;
+                for (size_t k = 0; k < num; ++k) {
+                    if (k != i && k != j) {
+                        auto dr = pos[k] - com_pos;
+                        double t = interaction_time(M + static_cast<double>(mass[k]), dr, vel[k] - com_vel);
+                        outer_time = std::min(outer_time, t);
+                    }
+                }
+                if (partner_time[i] < isolation * outer_time) {
+                    group[root(i)] = root(j);
+                }
+            }
+        }
+
+        // flatten the trees before relabelling, root() must not see the new labels
+        for (size_t i = 0; i < num; ++i) {
+            group[i] = root(i);
+        }
+        size_t group_num = 0;
+        std::vector<size_t> label(num, num);
+        for (size_t i = 0; i < num; ++i) {
+            if (label[group[i]] == num) {
+                label[group[i]] = group_num++;
+            }
+        }
+        for (size_t i = 0; i < num; ++i) {
+            group[i] = label[group[i]];
+        }
+        return group_num;
+    }
+
+    /**
+     * @brief Number of particles in a particle system or a container of particles.
+     */
+    template <typename Particles>
+    size_t particle_number(Particles const &ptc) {
+        if constexpr (is_ranges_v<Particles>) {
+            return ptc.size();
+        } else {
+            return ptc.number();
+        }
+    }
+
+    /*---------------------------------------------------------------------------*\
+         Class Hierarchy Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Hierarchical structure of a few body system.
+     *
+     * The two-body bound pair with the smallest semi-major axis is replaced by its centre of mass until no bound pair
+     * is left; the remaining objects are the top level of the hierarchy. The pair elements are computed once per pair
+     * and kept in a fixed size table, so a classification does not allocate and costs O(N^2) orbital elements.
+     *
+     * The structure is kept as a binary tree. code() encodes it as a pre-order token sequence, which is canonical:
+     * the components of every pair and the top level objects are ordered by their smallest particle index, as in the
+     * string format "((0,1),2)3". to_string() renders that string on demand.
+     *
+     * @tparam MaxNum Maximum number of particles. The tables hold (2 MaxNum)^2 pair elements, keep it small if the
+     * object lives on the stack.
+     */
+    template <size_t MaxNum = 16>
+    class Hierarchy {
+        static_assert(MaxNum <= 254, "Particle token of the hierarchy code is one byte!");
+
        public:
-        Vector pos{0};
-        Vector vel{0};
-        double mass{0};
-        size_t weight{0};
-        std::string name;
+        // Type members
+        static constexpr size_t max_number{MaxNum};
+
+        static constexpr size_t max_node_number{2 * MaxNum - 1};
+
+        /** @brief Token of code() that starts a pair, followed by its two components.*/
+        static constexpr uint8_t pair_token{254};
+
+        /** @brief Token of code() that pads the unused tail.*/
+        static constexpr uint8_t end_token{255};
+
+        using Code = std::array<uint8_t, max_node_number>;
+
+        /** @brief Node index, nodes go up to 2 MaxNum - 2.*/
+        using Index = uint16_t;
+
+        /** @brief Component index of a single particle.*/
+        static constexpr Index leaf{std::numeric_limits<Index>::max()};
+
+        struct Node {
+            Vec3<double> pos;
+            Vec3<double> vel;
+            double mass;
+
+            /** @brief Semi-major axis of the inner orbit, 0 for a single particle.*/
+            double a;
+
+            /** @brief Eccentricity of the inner orbit, 0 for a single particle.*/
+            double e;
+
+            /** @brief Smallest particle index in this node.*/
+            size_t first;
+
+            /** @brief Components of a pair, `leaf` for a single particle.*/
+            Index left;
+            Index right;
+
+            [[nodiscard]] bool is_leaf() const { return left == leaf; }
+        };
+
+        // Public methods
+        /**
+         * @brief Classify the particles.
+         *
+         * @tparam Particles Particle system or container of particles with public members `mass`, `pos` and `vel`.
+         * @param[in] ptc The particles.
+         * @return Number of the top level objects, 0 if there are more than MaxNum particles.
+         */
+        template <typename Particles>
+        size_t classify(Particles const &ptc);
+
+        /**
+         * @brief Number of the top level objects.
+         */
+        [[nodiscard]] size_t number() const { return top_num_; }
+
+        /**
+         * @brief Node index of the k-th top level object.
+         */
+        [[nodiscard]] size_t top(size_t k) const { return top_[k]; }
+
+        /**
+         * @brief Node by index. Node i < particle number is particle i, the pairs follow in the order of merging.
+         */
+        [[nodiscard]] Node const &node(size_t i) const { return nodes_[i]; }
+
+        [[nodiscard]] size_t node_number() const { return node_num_; }
+
+        SPACEHUB_READ_ACCESSOR(Code, code, code_);
+
+        [[nodiscard]] bool same_structure(Hierarchy const &other) const { return code_ == other.code_; }
+
+        /**
+         * @brief Render the structure, e.g. "((0,1),2)3".
+         */
+        [[nodiscard]] std::string to_string() const;
+
+       private:
+        // Private methods
+        template <typename Particles>
+        bool load(Particles const &ptc);
+
+        void update_pair(size_t i, size_t j);
+
+        void encode(size_t i, size_t &pos);
+
+        void write(size_t i, std::string &out) const;
+
+        // Private members
+        std::array<Node, max_node_number> nodes_;
+
+        std::array<double, max_node_number * max_node_number> pair_a_;
+
+        std::array<double, max_node_number * max_node_number> pair_e_;
+
+        std::array<Index, MaxNum> top_;
+
+        Code code_;
+
+        size_t node_num_{0};
+
+        size_t top_num_{0};
     };
-    /*template <typename Node>
-    void node_swap(Node& n1, Node& n2) {
-      std::swap(n1.mass, n2.mass);
-      std::swap(n1.name, n2.name);
-    }*/
-    CREATE_MEMBER_CHECK(m)
-
-    template <typename Particles, typename Node>
-    void create_init_list(Particles const &ptc, std::vector<Node> &vec) {
-        size_t p_num = ptc.number();
-        vec.clear();
-        vec.reserve(p_num);
-        for (size_t i = 0; i < p_num; ++i) {
-            if constexpr (HAS_MEMBER(decltype(ptc[0]), m)) {
-                vec.emplace_back(Node{ptc[i].pos, ptc[i].vel, ptc[i].m, i, std::to_string(i)});
-            } else {
-                vec.emplace_back(Node{ptc.pos()[i], ptc.vel()[i], ptc.mass()[i], i, std::to_string(i)});
+
+    /*---------------------------------------------------------------------------*\
+         Class Hierarchy Implementation
+    \*---------------------------------------------------------------------------*/
+    template <size_t MaxNum>
+    template <typename Particles>
+    bool Hierarchy<MaxNum>::load(Particles const &ptc) {
+        auto set = [&](size_t i, auto const &m, auto const &p, auto const &v) {
+            nodes_[i] = Node{Vec3<double>(p.x, p.y, p.z), Vec3<double>(v.x, v.y, v.z), static_cast<double>(m), 0, 0, i,
+                             leaf, leaf};
+            top_[i] = static_cast<Index>(i);
+        };
+        node_num_ = top_num_ = 0;
+        if (particle_number(ptc) > MaxNum) {
+            return false;
+        }
+        if constexpr (is_ranges_v<Particles>) {
+            node_num_ = ptc.size();
+            for (size_t i = 0; i < node_num_; ++i) {
+                set(i, ptc[i].mass, ptc[i].pos, ptc[i].vel);
+            }
+        } else {
+            node_num_ = ptc.number();
+            for (size_t i = 0; i < node_num_; ++i) {
+                set(i, ptc.mass()[i], ptc.pos()[i], ptc.vel()[i]);
             }
         }
+        top_num_ = node_num_;
+        return true;
     }
 
-    template <typename Nodes>
-    bool check_most_bound(Nodes const &vec, size_t idx, double amin) {
-        for (size_t i = 1; i < vec.size(); i++) {
-            if (i != idx) {
-                auto[a, e] =
-                orbit::calc_a_e(vec[idx].mass + vec[i].mass, vec[idx].pos - vec[i].pos, vec[idx].vel - vec[i].vel);
-                if (0 < a && a < amin) {
-                    return false;
+    template <size_t MaxNum>
+    void Hierarchy<MaxNum>::update_pair(size_t i, size_t j) {
+        auto const &n1 = nodes_[i];
+        auto const &n2 = nodes_[j];
+        auto [a, e] = orbit::calc_a_e(consts::G * (n1.mass + n2.mass), n1.pos - n2.pos, n1.vel - n2.vel);
+        pair_a_[i * max_node_number + j] = pair_a_[j * max_node_number + i] = a;
+        pair_e_[i * max_node_number + j] = pair_e_[j * max_node_number + i] = e;
+    }
+
+    template <size_t MaxNum>
+    template <typename Particles>
+    size_t Hierarchy<MaxNum>::classify(Particles const &ptc) {
+        if (!load(ptc)) {
+            code_.fill(end_token);
+            return 0;
+        }
+
+        for (size_t i = 0; i < top_num_; ++i) {
+            for (size_t j = i + 1; j < top_num_; ++j) {
+                update_pair(i, j);
+            }
+        }
+
+        for (;;) {
+            double a_min = math::max_value<double>::value;
+            size_t I = 0, J = 0;
+            for (size_t i = 0; i < top_num_; ++i) {
+                for (size_t j = i + 1; j < top_num_; ++j) {
+                    double a = pair_a_[top_[i] * max_node_number + top_[j]];
+                    if (0 < a && a < a_min) {
+                        a_min = a;
+                        I = i;
+                        J = j;
+                    }
+                }
+            }
+            if (a_min == math::max_value<double>::value) {
+                break;
+            }
+
+            auto const &n1 = nodes_[top_[I]];
+            auto const &n2 = nodes_[top_[J]];
+            double M = n1.mass + n2.mass;
+            bool first_lower = n1.first < n2.first;
+            nodes_[node_num_] = Node{(n1.mass * n1.pos + n2.mass * n2.pos) / M,
+                                     (n1.mass * n1.vel + n2.mass * n2.vel) / M,
+                                     M,
+                                     a_min,
+                                     pair_e_[top_[I] * max_node_number + top_[J]],
+                                     math::min(n1.first, n2.first),
+                                     first_lower ? top_[I] : top_[J],
+                                     first_lower ? top_[J] : top_[I]};
+
+            top_[I] = static_cast<Index>(node_num_);
+            top_[J] = top_[--top_num_];
+            for (size_t k = 0; k < top_num_; ++k) {
+                if (k != I) {
+                    update_pair(node_num_, top_[k]);
                 }
             }
+            node_num_++;
         }
-        return true;
+
+        std::sort(top_.begin(), top_.begin() + top_num_,
+                  [&](auto i, auto j) { return nodes_[i].first < nodes_[j].first; });
+
+        size_t pos = 0;
+        for (size_t k = 0; k < top_num_; ++k) {
+            encode(top_[k], pos);
+        }
+        std::fill(code_.begin() + pos, code_.end(), end_token);
+        return top_num_;
     }
 
-    template <typename Nodes>
-    bool check_unbound(Nodes const &vec) {
-        double pot = 0;
-        for (size_t i = 1; i < vec.size(); i++) {
-            pot = -vec[i].mass / norm(vec[0].pos - vec[i].pos);
+    template <size_t MaxNum>
+    void Hierarchy<MaxNum>::encode(size_t i, size_t &pos) {
+        auto const &n = nodes_[i];
+        if (n.is_leaf()) {
+            code_[pos++] = static_cast<uint8_t>(i);
+        } else {
+            code_[pos++] = pair_token;
+            encode(n.left, pos);
+            encode(n.right, pos);
         }
-        return 0.5 * norm2(vec[0].vel) + pot >= 0;
     }
 
-    template <typename Nodes>
-    std::string hierarchical_to_string(Nodes &vec) {
-        std::sort(vec.begin(), vec.end(), [](auto &x, auto &y) -> bool { return x.weight < y.weight; });
+    template <size_t MaxNum>
+    std::string Hierarchy<MaxNum>::to_string() const {
         std::string out;
-        for (auto const &v : vec) {
-            out += v.name;
+        for (size_t k = 0; k < top_num_; ++k) {
+            write(top_[k], out);
         }
         return out;
     }
 
+    template <size_t MaxNum>
+    void Hierarchy<MaxNum>::write(size_t i, std::string &out) const {
+        auto const &n = nodes_[i];
+        if (n.is_leaf()) {
+            out += std::to_string(i);
+        } else {
+            out += '(';
+            write(n.left, out);
+            out += ',';
+            write(n.right, out);
+            out += ')';
+        }
+    }
+
+    /**
+     * @brief Hierarchical structure of the particles in string format, e.g. "((0,1),2)3". See Hierarchy.
+     *
+     * The components of every pair and the top level objects are ordered by their smallest particle index, e.g.
+     * "(0,3)12". Earlier versions ordered them by the sum of their indices and would have returned "12(0,3)".
+     *
+     * Up to 16 particles are classified without allocation, larger systems up to 254 particles use a Hierarchy on the
+     * heap.
+     *
+     * @tparam Particles Particle system or container of particles with public members `mass`, `pos` and `vel`.
+     * @param[in] ptc The particles.
+     * @return The structure, an empty string if there are more than 254 particles.
+     */
     template <typename Particles>
     std::string get_hierarchical_struct(Particles const &ptc) {
-        using Vector = decltype(ptc[0].pos);
-        using Node = HierarchicalNode<Vector>;
-        std::vector<Node> vec{0};
-        create_init_list(ptc, vec);
-        std::vector<Node> vec_out;
-        vec_out.reserve(vec.size());
-        for (; vec.size() > 0;) {
-            Vector p0 = vec[0].pos;
-            Vector v0 = vec[0].vel;
-            double m0 = vec[0].mass;
-            double amin = 1e99;
-            size_t idx = 0;
-            for (size_t i = 1; i < vec.size(); i++) {
-                auto[a, e] = orbit::calc_a_e(m0 + vec[i].mass, p0 - vec[i].pos, v0 - vec[i].vel);
-                if (0 < a && a < amin) {
-                    idx = i;
-                    amin = a;
-                }
-            }
-
-            if (idx == 0) {
-                if (check_unbound(vec)) {
-                    vec_out.emplace_back(vec[0]);
-                    // += vec[0].name;
-                    vec.erase(vec.begin());
-                } else {
-                    std::swap(vec[0], vec[1]);
-                }
-            } else {
-                if (check_most_bound(vec, idx, amin)) {
-                    double m1 = vec[idx].mass;
-                    double mt = m1 + m0;
-                    Vector p1 = vec[idx].pos;
-                    Vector v1 = vec[idx].vel;
-                    if (vec[0].weight < vec[idx].weight) {
-                        vec.emplace_back(Node{(m0 * p0 + m1 * p1) / mt, (m0 * v0 + m1 * v1) / mt, mt,
-                                              vec[0].weight + vec[idx].weight,
-                                              "(" + vec[0].name + "," + vec[idx].name + ")"});
-                    } else {
-                        vec.emplace_back(Node{(m0 * p0 + m1 * p1) / mt, (m0 * v0 + m1 * v1) / mt, mt,
-                                              vec[0].weight + vec[idx].weight,
-                                              "(" + vec[idx].name + "," + vec[0].name + ")"});
-                    }
-                    vec.erase(vec.begin() + idx);
-                    vec.erase(vec.begin());
-                } else {
-                    std::swap(vec[0], vec[idx]);
-                }
-            }
+        if (particle_number(ptc) <= Hierarchy<>::max_number) {
+            Hierarchy<> hierarchy;
+            hierarchy.classify(ptc);
+            return hierarchy.to_string();
+        } else {
+            auto hierarchy = std::make_unique<Hierarchy<254>>();
+            hierarchy->classify(ptc);
+            return hierarchy->to_string();
         }
-        return hierarchical_to_string(vec_out);
     }
 
 }  // namespace hub::scattering
@@ -0,0 +1,281 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file journal.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#endif
+
+#include "../dev-tools.hpp"
+
+namespace hub::scattering {
+
+    namespace detail {
+        template <typename T>
+        struct Packed {
+            static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "The outcome cannot be written to a journal!");
+
+            static constexpr size_t size{sizeof(T)};
+
+            static void write(char *buf, T const &value) { std::memcpy(buf, &value, sizeof(T)); }
+
+            static void read(char const *buf, T &value) { std::memcpy(&value, buf, sizeof(T)); }
+        };
+
+        template <typename T, typename U>
+        struct Packed<std::pair<T, U>> {
+            static constexpr size_t size{Packed<T>::size + Packed<U>::size};
+
+            static void write(char *buf, std::pair<T, U> const &value) {
+                Packed<T>::write(buf, value.first);
+                Packed<U>::write(buf + Packed<T>::size, value.second);
+            }
+
+            static void read(char const *buf, std::pair<T, U> &value) {
+                Packed<T>::read(buf, value.first);
+                Packed<U>::read(buf + Packed<T>::size, value.second);
+            }
+        };
+    }  // namespace detail
+
+    /*---------------------------------------------------------------------------*\
+         Class Journal Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Append-only binary log of the finished runs of a campaign.
+     *
+     * Every record holds (run index, campaign seed, outcome, step count) in a fixed size. Records are buffered and
+     * written, flushed and fsynced in batches, so a crash loses at most the last batch; a record torn by the crash is
+     * dropped when the journal is opened again. Since a Campaign keys the generator to (seed, run index), the runs
+     * that are not in the journal are reproduced exactly after a restart.
+     *
+     * A full batch is swapped out of the buffer under the record lock and written by the thread that filled it, so
+     * the other threads keep appending while it waits for the disk.
+     *
+     * @tparam Outcome Arithmetic or enum outcome type, or a std::pair of them.
+     */
+    template <typename Outcome>
+    class Journal {
+       public:
+        // Constructors
+        /**
+         * @param[in] path File of the journal. Existing records are loaded.
+         * @param[in] batch Number of records written per fsync.
+         */
+        explicit Journal(std::string const &path, size_t batch = 64);
+
+        Journal(Journal const &) = delete;
+
+        Journal &operator=(Journal const &) = delete;
+
+        ~Journal();
+
+        // Public methods
+        /**
+         * @brief Outcome of a finished run of the campaign with the given seed.
+         */
+        [[nodiscard]] std::optional<Outcome> find(uint64_t seed, size_t run) const;
+
+        /**
+         * @brief Step count of a finished run of the campaign with the given seed, 0 if it was not simulated.
+         */
+        [[nodiscard]] size_t steps(uint64_t seed, size_t run) const;
+
+        void append(uint64_t seed, size_t run, Outcome const &outcome, size_t steps);
+
+        /**
+         * @brief Write, flush and fsync the buffered records.
+         */
+        void flush();
+
+        [[nodiscard]] size_t size() const {
+            std::lock_guard lock{mutex_};
+            return records_.size();
+        }
+
+       private:
+        // Private methods
+        void write(std::vector<char> const &batch);
+
+        // Private members
+        static constexpr char magic_[8] = {'S', 'H', 'J', 'O', 'U', 'R', 'N', 'L'};
+
+        static constexpr size_t record_size_{2 * sizeof(uint64_t) + detail::Packed<Outcome>::size + sizeof(uint64_t)};
+
+        std::map<std::pair<uint64_t, size_t>, std::pair<Outcome, size_t>> records_;
+
+        std::vector<char> buffer_;
+
+        std::FILE *file_{nullptr};
+
+        mutable std::mutex mutex_;
+
+        std::mutex file_mutex_;
+
+        size_t batch_;
+    };
+
+    /*---------------------------------------------------------------------------*\
+         Class Journal Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename Outcome>
+    Journal<Outcome>::Journal(std::string const &path, size_t batch) : batch_{batch > 0 ? batch : 1} {
+        uint64_t const header_size = record_size_;
+        std::vector<char> data;
+        if (std::FILE *in = std::fopen(path.c_str(), "rb")) {
+            char chunk[4096];
+            for (size_t n; (n = std::fread(chunk, 1, sizeof(chunk), in)) > 0;) {
+                data.insert(data.end(), chunk, chunk + n);
+            }
+            std::fclose(in);
+        }
+
+        size_t valid = 0;
+        if (data.size() >= sizeof(magic_) + sizeof(uint64_t)) {
+            uint64_t size;
+            std::memcpy(&size, data.data() + sizeof(magic_), sizeof(size));
+            if (std::memcmp(data.data(), magic_, sizeof(magic_)) != 0 || size != header_size) {
+                spacehub_abort("The journal ", path, " was not written by a campaign with the same outcome type!");
+            }
+            valid = sizeof(magic_) + sizeof(uint64_t);
+            for (; valid + record_size_ <= data.size(); valid += record_size_) {
+                char const *p = data.data() + valid;
+                uint64_t run, seed, steps;
+                Outcome outcome;
+                std::memcpy(&run, p, sizeof(run));
+                std::memcpy(&seed, p + sizeof(run), sizeof(seed));
+                detail::Packed<Outcome>::read(p + 2 * sizeof(uint64_t), outcome);
+                std::memcpy(&steps, p + 2 * sizeof(uint64_t) + detail::Packed<Outcome>::size, sizeof(steps));
+                records_[{seed, static_cast<size_t>(run)}] = {outcome, static_cast<size_t>(steps)};
+            }
+        }
+
+        if (valid == 0) {
+            // new journal, or a header torn by a crash, nothing to keep
+            file_ = std::fopen(path.c_str(), "wb");
+            if (file_) {
+                std::fwrite(magic_, 1, sizeof(magic_), file_);
+                std::fwrite(&header_size, sizeof(header_size), 1, file_);
+            }
+        } else {
+            if (valid < data.size()) {
+                // cut off the record torn by a crash in place, so the valid records are never rewritten
+                std::error_code err;
+                std::filesystem::resize_file(path, valid, err);
+                if (err) {
+                    spacehub_abort("Fail to truncate the journal ", path, ": ", err.message());
+                }
+            }
+            file_ = std::fopen(path.c_str(), "ab");
+        }
+        if (!file_) {
+            spacehub_abort("Fail to open the journal ", path, "!");
+        }
+        flush();
+    }
+
+    template <typename Outcome>
+    Journal<Outcome>::~Journal() {
+        flush();
+        std::fclose(file_);
+    }
+
+    template <typename Outcome>
+    std::optional<Outcome> Journal<Outcome>::find(uint64_t seed, size_t run) const {
+        std::lock_guard lock{mutex_};
+        if (auto it = records_.find({seed, run}); it != records_.end()) {
+            return it->second.first;
+        }
+        return std::nullopt;
+    }
+
+    template <typename Outcome>
+    size_t Journal<Outcome>::steps(uint64_t seed, size_t run) const {
+        std::lock_guard lock{mutex_};
+        auto it = records_.find({seed, run});
+        return it == records_.end() ? 0 : it->second.second;
+    }
+
+    template <typename Outcome>
+    void Journal<Outcome>::append(uint64_t seed, size_t run, Outcome const &outcome, size_t steps) {
+        std::vector<char> batch;
+        {
+            std::lock_guard lock{mutex_};
+            records_[{seed, run}] = {outcome, steps};
+
+            size_t pos = buffer_.size();
+            buffer_.resize(pos + record_size_);
+            char *p = buffer_.data() + pos;
+            uint64_t const fields[2] = {static_cast<uint64_t>(run), seed};
+            uint64_t const cost = steps;
+            std::memcpy(p, fields, sizeof(fields));
+            detail::Packed<Outcome>::write(p + sizeof(fields), outcome);
+            std::memcpy(p + sizeof(fields) + detail::Packed<Outcome>::size, &cost, sizeof(cost));
+
+            if (buffer_.size() < batch_ * record_size_) {
+                return;
+            }
+            batch.swap(buffer_);
+            buffer_.reserve(batch_ * record_size_);
+        }
+        write(batch);
+    }
+
+    template <typename Outcome>
+    void Journal<Outcome>::flush() {
+        std::vector<char> batch;
+        {
+            std::lock_guard lock{mutex_};
+            batch.swap(buffer_);
+        }
+        write(batch);
+    }
+
+    template <typename Outcome>
+    void Journal<Outcome>::write(std::vector<char> const &batch) {
+        // batches may reach the file out of order, the records are keyed by (seed, run) anyway
+        std::lock_guard lock{file_mutex_};
+        if (!batch.empty()) {
+            std::fwrite(batch.data(), 1, batch.size(), file_);
+        }
+        std::fflush(file_);
+#ifdef _POSIX_VERSION
+        fsync(fileno(file_));
+#endif
+    }
+}  // namespace hub::scattering
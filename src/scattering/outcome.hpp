@@ -0,0 +1,198 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file outcome.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <cmath>
+#include <string>
+
+#include "../dev-tools.hpp"
+#include "../math.hpp"
+#include "../orbits/orbits.hpp"
+#include "../vector/vector3.hpp"
+#include "hierarchical.hpp"
+
+namespace hub::scattering {
+
+    /*---------------------------------------------------------------------------*\
+         Class SettleCheck Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Decide if the outcome of a scattering is dynamically settled.
+     *
+     * The particles are classified by Hierarchy. The outcome is settled if
+     *  - every pair with an inner orbit satisfies the Mardling & Aarseth (2001) stability criterion,
+     *  - there are at least two top level objects, all of them receding from each other,
+     *  - the tidal factor (see orbit::tidal_factor) between any two top level objects is below `tidal_tol`, and so is
+     *    the tidal perturbation of any third object on their relative orbit.
+     * Top level objects are mutually unbound by construction, so a settled system will not interact again. Systems with
+     * more than Structure::max_number particles are never settled.
+     */
+    class SettleCheck {
+       public:
+        // Type members
+        using Structure = Hierarchy<>;
+
+        // Constructors
+        explicit SettleCheck(double tidal_tol = 1e-3) : tidal_tol_{tidal_tol} {}
+
+        // Public methods
+        /**
+         * @brief Check the particle system.
+         *
+         * @tparam ParticleSys Any implementation of ParticleSystem.
+         * @param[in] ptc Particle system.
+         * @return true The outcome is settled.
+         */
+        template <typename ParticleSys>
+        bool operator()(ParticleSys const &ptc);
+
+        /**
+         * @brief The hierarchical structure found by the last check.
+         */
+        SPACEHUB_READ_ACCESSOR(Structure, hierarchy, hierarchy_);
+
+        [[nodiscard]] std::string structure() const { return hierarchy_.to_string(); }
+
+       private:
+        bool is_stable() const;
+
+        Structure hierarchy_;
+
+        double tidal_tol_{1e-3};
+    };
+
+    /*---------------------------------------------------------------------------*\
+         Class OutcomeSettled Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Stop condition that ends a scattering as soon as its outcome is settled(see SettleCheck).
+     *
+     * The check runs every `check_interval` steps. Capture the object by reference to read the outcome afterwards:
+     * @code{.cpp}
+     *  scattering::OutcomeSettled settled;
+     *  args.add_stop_condition([&](auto &ptc, auto h) { return settled(ptc, h); });
+     *  solver.run(args);
+     *  settled.is_settled(); settled.outcome();
+     * @endcode
+     */
+    class OutcomeSettled {
+       public:
+        // Constructors
+        explicit OutcomeSettled(size_t check_interval = 16, double tidal_tol = 1e-3)
+            : check_{tidal_tol}, check_interval_{check_interval} {}
+
+        // Public methods
+        /**
+         * @brief Callable interface of the stop condition.
+         *
+         * @tparam ParticleSys Any implementation of ParticleSystem.
+         * @param[in] ptc Particle system.
+         * @param[in] step_size The step size of the integration.
+         * @return true The outcome is settled.
+         */
+        template <typename ParticleSys>
+        bool operator()(ParticleSys const &ptc, typename ParticleSys::Scalar step_size) {
+            if (++step_ < check_interval_) {
+                return false;
+            }
+            step_ = 0;
+            settled_ = check_(ptc);
+            return settled_;
+        }
+
+        /**
+         * @brief The hierarchical structure at the last check.
+         */
+        [[nodiscard]] std::string outcome() const { return check_.structure(); }
+
+        [[nodiscard]] bool is_settled() const { return settled_; }
+
+       private:
+        SettleCheck check_;
+        size_t check_interval_{16};
+        size_t step_{0};
+        bool settled_{false};
+    };
+
+    /*---------------------------------------------------------------------------*\
+         Class SettleCheck Implementation
+    \*---------------------------------------------------------------------------*/
+    inline bool SettleCheck::is_stable() const {
+        for (size_t i = 0; i < hierarchy_.node_number(); ++i) {
+            auto const &out = hierarchy_.node(i);
+            if (out.is_leaf()) {
+                continue;
+            }
+            // Mardling & Aarseth (2001) stability of each inner orbit against the outer orbit
+            double e_out = math::min(out.e, 1 - 1e-12);
+            double r_p = out.a * (1 - e_out);
+            for (auto [in, other] : {std::pair{out.left, out.right}, std::pair{out.right, out.left}}) {
+                auto const &inner = hierarchy_.node(in);
+                double q = hierarchy_.node(other).mass / inner.mass;
+                if (!inner.is_leaf() &&
+                    r_p < 2.8 * inner.a * std::pow((1 + q) * (1 + e_out), 0.4) / std::pow(1 - e_out, 0.2)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    template <typename ParticleSys>
+    bool SettleCheck::operator()(ParticleSys const &ptc) {
+        size_t const top_num = hierarchy_.classify(ptc);
+        if (top_num < 2 || !is_stable()) {
+            return false;
+        }
+
+        auto size = [](auto const &n) { return n.a * (1 + n.e); };
+        for (size_t i = 0; i < top_num; ++i) {
+            for (size_t j = i + 1; j < top_num; ++j) {
+                auto const &n1 = hierarchy_.node(hierarchy_.top(i));
+                auto const &n2 = hierarchy_.node(hierarchy_.top(j));
+                auto dr = n1.pos - n2.pos;
+                if (dot(dr, n1.vel - n2.vel) <= 0) {
+                    return false;
+                }
+                double r = norm(dr);
+                auto [f1, f2] = orbit::tidal_factor(r, n1.mass, n2.mass, size(n1), size(n2));
+                if (f1 > tidal_tol_ || f2 > tidal_tol_) {
+                    return false;
+                }
+                // the pair must also be free of the tidal field of every other object
+                for (size_t k = 0; k < top_num; ++k) {
+                    if (k != i && k != j) {
+                        auto const &n3 = hierarchy_.node(hierarchy_.top(k));
+                        double d = math::min(norm(n3.pos - n1.pos), norm(n3.pos - n2.pos));
+                        if (n3.mass / (n1.mass + n2.mass) * r * r * r > tidal_tol_ * d * d * d) {
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+        return true;
+    }
+}  // namespace hub::scattering
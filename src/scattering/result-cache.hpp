@@ -0,0 +1,256 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file result-cache.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../dev-tools.hpp"
+#include "../macros.hpp"
+
+namespace hub::scattering {
+
+    namespace detail {
+        template <typename T, typename = void>
+        struct has_radius : std::false_type {};
+
+        template <typename T>
+        struct has_radius<T, std::void_t<decltype(std::declval<T>().radius)>> : std::true_type {};
+
+        template <typename T>
+        void write_outcome(std::ostream &os, T const &outcome) {
+            if constexpr (std::is_enum_v<T>) {
+                os << ' ' << static_cast<std::underlying_type_t<T>>(outcome);
+            } else {
+                os << ' ' << outcome;
+            }
+        }
+
+        template <typename T, typename U>
+        void write_outcome(std::ostream &os, std::pair<T, U> const &outcome) {
+            write_outcome(os, outcome.first);
+            write_outcome(os, outcome.second);
+        }
+
+        template <typename T>
+        void read_outcome(std::istream &is, T &outcome) {
+            if constexpr (std::is_enum_v<T>) {
+                std::underlying_type_t<T> value;
+                is >> value;
+                outcome = static_cast<T>(value);
+            } else {
+                is >> outcome;
+            }
+        }
+
+        template <typename T, typename U>
+        void read_outcome(std::istream &is, std::pair<T, U> &outcome) {
+            read_outcome(is, outcome.first);
+            read_outcome(is, outcome.second);
+        }
+    }  // namespace detail
+
+    /*---------------------------------------------------------------------------*\
+         Class ResultCache Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Persistent cache of scattering outcomes, keyed by the initial condition in N-body units.
+     *
+     * Under pure Newtonian gravity the outcome of a scattering does not change if masses, lengths and times are
+     * rescaled with G M T^2 / L^3 fixed. The key of an initial condition is therefore computed in the frame of the
+     * centre of mass and in units of the total mass M, the mass weighted rms radius L and G = 1, with every component
+     * quantized to the given resolution. The same configuration in (Ms, AU, km/s) or in (Mj, R_sun, ...) gets the same
+     * key, up to the round-off on the quantization boundaries.
+     *
+     * Outcomes are appended to the file as soon as they are inserted, so the cache survives a crash. The cache does
+     * not know the classifier, the stop conditions or the tolerances of the runs; use one file per setup.
+     *
+     * @tparam Outcome Arithmetic or enum outcome type, or a std::pair of them.
+     */
+    template <typename Outcome>
+    class ResultCache {
+       public:
+        // Type members
+        using Key = std::vector<int64_t>;
+
+        // Constructors
+        /**
+         * @param[in] path File of the cache. Existing entries are loaded. Empty for an in-memory cache.
+         * @param[in] resolution Quantization of the dimensionless initial condition.
+         */
+        explicit ResultCache(std::string const &path = "", double resolution = 1e-9);
+
+        // Public methods
+        /**
+         * @brief Dimensionless key of an initial condition.
+         *
+         * @param[in] particles Container of the particles.
+         * @param[in] end_time Integration time.
+         */
+        template <typename Particles>
+        [[nodiscard]] Key key(Particles const &particles, double end_time) const;
+
+        [[nodiscard]] std::optional<Outcome> find(Key const &key);
+
+        void insert(Key const &key, Outcome const &outcome);
+
+        [[nodiscard]] size_t size() const {
+            std::lock_guard lock{mutex_};
+            return table_.size();
+        }
+
+        [[nodiscard]] size_t hits() const {
+            std::lock_guard lock{mutex_};
+            return hits_;
+        }
+
+        [[nodiscard]] size_t misses() const {
+            std::lock_guard lock{mutex_};
+            return misses_;
+        }
+
+       private:
+        // Private members
+        std::map<Key, Outcome> table_;
+
+        std::ofstream file_;
+
+        mutable std::mutex mutex_;
+
+        double resolution_;
+
+        size_t hits_{0};
+
+        size_t misses_{0};
+    };
+
+    /*---------------------------------------------------------------------------*\
+         Class ResultCache Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename Outcome>
+    ResultCache<Outcome>::ResultCache(std::string const &path, double resolution) : resolution_{resolution} {
+        if (path.empty()) {
+            return;
+        }
+        std::ifstream in{path};
+        for (std::string line; std::getline(in, line);) {
+            std::istringstream is{line};
+            size_t n = 0;
+            Key key;
+            Outcome outcome;
+            if (is >> n) {
+                key.resize(n);
+                for (auto &k : key) {
+                    is >> k;
+                }
+                detail::read_outcome(is, outcome);
+                if (is) {
+                    table_[std::move(key)] = outcome;
+                }
+            }
+        }
+        in.close();
+        file_.open(path, std::ios::app);
+        if (!file_) {
+            spacehub_abort("Fail to open the result cache file ", path, "!");
+        }
+    }
+
+    template <typename Outcome>
+    template <typename Particles>
+    auto ResultCache<Outcome>::key(Particles const &particles, double end_time) const -> Key {
+        using Vector = std::decay_t<decltype(particles.begin()->pos)>;
+
+        double mass = 0;
+        Vector com_pos{0, 0, 0};
+        Vector com_vel{0, 0, 0};
+        for (auto const &p : particles) {
+            mass += p.mass;
+            com_pos += p.mass * p.pos;
+            com_vel += p.mass * p.vel;
+        }
+        com_pos /= mass;
+        com_vel /= mass;
+
+        double inertia = 0;
+        for (auto const &p : particles) {
+            inertia += p.mass * norm2(p.pos - com_pos);
+        }
+        double L = std::sqrt(inertia / mass);
+        double V = std::sqrt(consts::G * mass / L);
+
+        Key key;
+        auto push = [&](double x) { key.emplace_back(static_cast<int64_t>(std::llround(x / resolution_))); };
+        push(end_time * V / L);
+        for (auto const &p : particles) {
+            push(p.mass / mass);
+            if constexpr (detail::has_radius<std::decay_t<decltype(p)>>::value) {
+                push(p.radius / L);
+            }
+            auto dr = (p.pos - com_pos) / L;
+            auto dv = (p.vel - com_vel) / V;
+            for (double x : {dr.x, dr.y, dr.z, dv.x, dv.y, dv.z}) {
+                push(x);
+            }
+        }
+        return key;
+    }
+
+    template <typename Outcome>
+    std::optional<Outcome> ResultCache<Outcome>::find(Key const &key) {
+        std::lock_guard lock{mutex_};
+        if (auto it = table_.find(key); it != table_.end()) {
+            hits_++;
+            return it->second;
+        }
+        misses_++;
+        return std::nullopt;
+    }
+
+    template <typename Outcome>
+    void ResultCache<Outcome>::insert(Key const &key, Outcome const &outcome) {
+        std::lock_guard lock{mutex_};
+        if (!table_.emplace(key, outcome).second) {
+            return;
+        }
+        if (file_.is_open()) {
+            file_ << key.size();
+            for (auto k : key) {
+                file_ << ' ' << k;
+            }
+            detail::write_outcome(file_, outcome);
+            file_ << std::endl;
+        }
+    }
+}  // namespace hub::scattering
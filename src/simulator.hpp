@@ -92,6 +92,12 @@ namespace hub {
          */
         Scalar rtol{1e-14};
 
+        /**
+         * The relative perturbation below which the KS pair of a KS system is propagated analytically as an
+         * unperturbed Kepler orbit. Zero (the default) turns it off. Ignored by the other systems.
+         */
+        Scalar unperturbed_tol{0};
+
         // public methods
         /**
          * Call the all registered operation functions by sequence.
@@ -263,6 +269,21 @@ namespace hub {
          */
         void run(RunArgs const &run_args);
 
+        /**
+         * Reinitialize the Simulator with a new particle set for the next run.
+         *
+         * The particle system and the ode iterator are reset in place if they support it, keeping their allocated
+         * arrays and precomputed tables; otherwise they are rebuilt. A cold reset gives bit-identical results to a
+         * newly constructed Simulator.
+         *
+         * @tparam STL Iterable Particle Container.
+         * @param[in] time Initial time of the particle system.
+         * @param[in] particles_set Particle container.
+         * @param[in] warm_start Keep the adaptive state of the ode iterator learned in the previous run.
+         */
+        template <CONCEPT_PARTICLE_CONTAINER STL>
+        void reset(Scalar time, STL const &particles_set, bool warm_start = false);
+
         virtual ~Simulator() = default;
 
        private:
@@ -282,6 +303,10 @@ namespace hub {
         CREATE_METHOD_CHECK(set_atol);
 
         CREATE_METHOD_CHECK(set_rtol);
+
+        CREATE_METHOD_CHECK(set_unperturbed_tol);
+
+        CREATE_METHOD_CHECK(reset);
     };
 
     /*---------------------------------------------------------------------------*\
@@ -362,6 +387,23 @@ namespace hub {
         static_assert(calc::all(std::is_same_v<T, Particle>...), "Wrong particles type!");
     }
 
+    template <typename ParticleSys, typename OdeIterator>
+    template <CONCEPT_PARTICLE_CONTAINER STL>
+    void Simulator<ParticleSys, OdeIterator>::reset(Scalar time, const STL &particle_set, bool warm_start) {
+        if constexpr (HAS_METHOD(ParticleSys, reset, Scalar, STL const &)) {
+            particles_.reset(time, particle_set);
+        } else {
+            particles_ = ParticleSys(time, particle_set);
+        }
+
+        if constexpr (HAS_METHOD(OdeIterator, reset, bool)) {
+            iterator_.reset(warm_start);
+        } else {
+            iterator_ = OdeIterator{};
+        }
+        step_size_ = 0.0;
+    }
+
     template <typename ParticleSys, typename OdeIterator>
     void Simulator<ParticleSys, OdeIterator>::run(RunArgs const &run_args) {
         if (!run_args.is_stop_condition_set() && !run_args.is_end_time_set()) {
@@ -398,6 +440,18 @@ namespace hub {
             iterator_.set_rtol(run_args.rtol);
         }
 
+        if constexpr (HAS_METHOD(ParticleSys, set_atol, Scalar)) {
+            particles_.set_atol(run_args.atol);
+        }
+
+        if constexpr (HAS_METHOD(ParticleSys, set_rtol, Scalar)) {
+            particles_.set_rtol(run_args.rtol);
+        }
+
+        if constexpr (HAS_METHOD(ParticleSys, set_unperturbed_tol, Scalar)) {
+            particles_.set_unperturbed_tol(run_args.unperturbed_tol);
+        }
+
         run_args.start_operations(particles_, step_size_);
         for (; particles_.time() < end_time && !run_args.check_stops(particles_, step_size_);) {
             Scalar rest_step = (end_time - particles_.time()) * particles_.step_scale();
@@ -48,7 +48,9 @@ License
 #endif
 
 #include "args-callback/callbacks.hpp"
+#include "ensemble-simulator.hpp"
 #include "integrator/Gauss-Radau.hpp"
+#include "integrator/Hermite.hpp"
 #include "integrator/symplectic/symplectic-integrator.hpp"
 #include "interaction/newtonian.hpp"
 #include "interaction/post-newtonian.hpp"
@@ -58,11 +60,15 @@ License
 #include "multi-thread/multi-thread.hpp"
 #include "ode-iterator/Bulirsch-Stoer.hpp"
 #include "ode-iterator/IAS15.hpp"
+#include "ode-iterator/block-step.hpp"
 #include "ode-iterator/const-iterator.hpp"
+#include "ode-iterator/ensemble-iterator.hpp"
 #include "ode-iterator/error-checker/RMS.hpp"
 #include "ode-iterator/error-checker/max-ratio-error.hpp"
 #include "ode-iterator/error-checker/worst-offender.hpp"
 #include "ode-iterator/sequent-iterator.hpp"
+#include "ode-iterator/shared-step.hpp"
+#include "ode-iterator/step-controller/Aarseth-controller.hpp"
 #include "ode-iterator/step-controller/PID-controller.hpp"
 #include "ode-iterator/step-controller/const-controller.hpp"
 #include "orbits/orbits.hpp"
@@ -70,16 +76,26 @@ License
 #include "particle-system/archain.hpp"
 #include "particle-system/base-system.hpp"
 #include "particle-system/chain-system.hpp"
+#include "particle-system/ensemble-system.hpp"
+#include "particle-system/hierarchical-system.hpp"
+#include "particle-system/ks-system.hpp"
 #include "particle-system/regu-system.hpp"
 #include "particles/finite-size.hpp"
 #include "particles/point-particles.hpp"
 #include "particles/tide-particles.hpp"
+#include "scattering/campaign.hpp"
+#include "scattering/cross-section-estimator.hpp"
 #include "scattering/cross-section.hpp"
+#include "scattering/far-field.hpp"
 #include "scattering/hierarchical.hpp"
+#include "scattering/journal.hpp"
+#include "scattering/outcome.hpp"
+#include "scattering/result-cache.hpp"
 #include "simulator.hpp"
 #include "stellar/stellar.hpp"
 #include "tools/auto-name.hpp"
 #include "tools/config-reader.hpp"
+#include "tools/sweep.hpp"
 #include "tools/timer.hpp"
 #include "type-class.hpp"
 
@@ -166,6 +182,11 @@ namespace hub {
             using sym8 = SequentOdeIterator<Symplectic8th<normal_type>, worst_offender_err, adaptive_step_ctrl>;
             using sym10 = SequentOdeIterator<Symplectic10th<normal_type>, worst_offender_err, adaptive_step_ctrl>;
             using Radau = IAS15<GaussRadau<normal_type>, MaxRatioError<normal_type>, adaptive_step_ctrl>;
+            using block = BlockStepIterator<integrator::Hermite2<normal_type>, AarsethController<normal_type>>;
+            using hermite4 = SharedStepIterator<integrator::Hermite4<normal_type>, AarsethController<normal_type>>;
+            using hermite6 = SharedStepIterator<integrator::Hermite6<normal_type>, AarsethController<normal_type>>;
+            using block_hermite4 = BlockStepIterator<integrator::Hermite4<normal_type>, AarsethController<normal_type>>;
+            using block_hermite6 = BlockStepIterator<integrator::Hermite6<normal_type>, AarsethController<normal_type>>;
 
             using BS_ext = BulirschStoer<LeapFrogDKD<extended_type>, worst_offender_err_ext, adaptive_step_ctrl_ext>;
             using sym2_ext =
@@ -179,6 +200,15 @@ namespace hub {
             using sym10_ext =
                 SequentOdeIterator<Symplectic10th<extended_type>, worst_offender_err_ext, adaptive_step_ctrl_ext>;
             using Radau_ext = IAS15<GaussRadau<extended_type>, MaxRatioError<extended_type>, adaptive_step_ctrl_ext>;
+            using block_ext = BlockStepIterator<integrator::Hermite2<extended_type>, AarsethController<extended_type>>;
+            using hermite4_ext =
+                SharedStepIterator<integrator::Hermite4<extended_type>, AarsethController<extended_type>>;
+            using hermite6_ext =
+                SharedStepIterator<integrator::Hermite6<extended_type>, AarsethController<extended_type>>;
+            using block_hermite4_ext =
+                BlockStepIterator<integrator::Hermite4<extended_type>, AarsethController<extended_type>>;
+            using block_hermite6_ext =
+                BlockStepIterator<integrator::Hermite6<extended_type>, AarsethController<extended_type>>;
 
             using BS_plus = BulirschStoer<LeapFrogDKD<precise_type>, worst_offender_err, adaptive_step_ctrl>;
             using sym2_plus = SequentOdeIterator<Symplectic2nd<precise_type>, worst_offender_err, adaptive_step_ctrl>;
@@ -187,6 +217,15 @@ namespace hub {
             using sym8_plus = SequentOdeIterator<Symplectic8th<precise_type>, worst_offender_err, adaptive_step_ctrl>;
             using sym10_plus = SequentOdeIterator<Symplectic10th<precise_type>, worst_offender_err, adaptive_step_ctrl>;
             using Radau_plus = IAS15<GaussRadau<precise_type>, MaxRatioError<normal_type>, adaptive_step_ctrl>;
+            using block_plus = BlockStepIterator<integrator::Hermite2<precise_type>, AarsethController<precise_type>>;
+            using hermite4_plus =
+                SharedStepIterator<integrator::Hermite4<precise_type>, AarsethController<precise_type>>;
+            using hermite6_plus =
+                SharedStepIterator<integrator::Hermite6<precise_type>, AarsethController<precise_type>>;
+            using block_hermite4_plus =
+                BlockStepIterator<integrator::Hermite4<precise_type>, AarsethController<precise_type>>;
+            using block_hermite6_plus =
+                BlockStepIterator<integrator::Hermite6<precise_type>, AarsethController<precise_type>>;
 
             using BS_extplus =
                 BulirschStoer<LeapFrogDKD<extended_precise_type>, worst_offender_err_ext, adaptive_step_ctrl_ext>;
@@ -202,6 +241,27 @@ namespace hub {
                                                      adaptive_step_ctrl_ext>;
             using Radau_extplus =
                 IAS15<GaussRadau<extended_precise_type>, MaxRatioError<extended_type>, adaptive_step_ctrl_ext>;
+            using block_extplus =
+                BlockStepIterator<integrator::Hermite2<extended_precise_type>,
+                                  AarsethController<extended_precise_type>>;
+            using hermite4_extplus =
+                SharedStepIterator<integrator::Hermite4<extended_precise_type>,
+                                   AarsethController<extended_precise_type>>;
+            using hermite6_extplus =
+                SharedStepIterator<integrator::Hermite6<extended_precise_type>,
+                                   AarsethController<extended_precise_type>>;
+            using block_hermite4_extplus =
+                BlockStepIterator<integrator::Hermite4<extended_precise_type>,
+                                  AarsethController<extended_precise_type>>;
+            using block_hermite6_extplus =
+                BlockStepIterator<integrator::Hermite6<extended_precise_type>,
+                                  AarsethController<extended_precise_type>>;
+
+            template <size_t N, size_t Lanes>
+            using ensemble = system::EnsembleSystem<normal_type, N, Lanes>;
+            using ensemble_sym2 = EnsembleConstIterator<Symplectic2nd<normal_type>>;
+            using ensemble_sym4 = EnsembleConstIterator<Symplectic4th<normal_type>>;
+            using ensemble_sym6 = EnsembleConstIterator<Symplectic6th<normal_type>>;
 #ifdef MPFR_VERSION_MAJOR
             using ABits = BulirschStoer<LeapFrogDKD<any_bits_type>, ode::WorstOffender<any_bits_type>,
                                         PIDController<any_bits_type>, 32>;
@@ -298,6 +358,20 @@ namespace hub {
         DEFINE_ADAPTIVE_INTEGRATION_METHOD(Chain_BS, ChainSystem, BS)
 
         DEFINE_ADAPTIVE_INTEGRATION_METHOD(AR_Chain, ARchainSystem, BS)
+
+        DEFINE_ADAPTIVE_INTEGRATION_METHOD(KS_BS, KSRegularizedSystem, BS)
+
+        DEFINE_ADAPTIVE_INTEGRATION_METHOD(SD_KS_BS, SlowDownKSSystem, BS)
+
+        DEFINE_ADAPTIVE_INTEGRATION_METHOD(BlockStep, SimpleSystem, block)
+
+        DEFINE_ADAPTIVE_INTEGRATION_METHOD(Hermite4, SimpleSystem, hermite4)
+
+        DEFINE_ADAPTIVE_INTEGRATION_METHOD(Hermite6, SimpleSystem, hermite6)
+
+        DEFINE_ADAPTIVE_INTEGRATION_METHOD(Block_Hermite4, SimpleSystem, block_hermite4)
+
+        DEFINE_ADAPTIVE_INTEGRATION_METHOD(Block_Hermite6, SimpleSystem, block_hermite6)
 #ifdef MPFR_VERSION_MAJOR
         DEFINE_ADAPTIVE_ARBITRARY_BIT_METHOD(ABITS, SimpleSystem, ABits)
 
@@ -311,6 +385,8 @@ namespace hub {
 
         DEFINE_INTEGRATION_METHOD(AR_Sym2_Chain, ARchainSystem, sym2)
 
+        DEFINE_INTEGRATION_METHOD(Hierarchical_Sym2, HierarchicalSystem, sym2)
+
         DEFINE_INTEGRATION_METHOD(Sym4, SimpleSystem, sym4)
 
         DEFINE_INTEGRATION_METHOD(AR_Sym4, RegularizedSystem, sym4)
@@ -351,6 +427,19 @@ namespace hub {
 
         DEFINE_INTEGRATION_METHOD(AR_Radau_Chain, ARchainSystem, Radau)
 
+        template <size_t N, size_t Lanes = 4>
+        using Ensemble_BS =
+            EnsembleSimulator<details::ensemble<N, Lanes>, ode::EnsembleBulirschStoer<details::ensemble<N, Lanes>>>;
+
+        template <size_t N, size_t Lanes = 4>
+        using Ensemble_Sym2 = EnsembleSimulator<details::ensemble<N, Lanes>, details::ensemble_sym2>;
+
+        template <size_t N, size_t Lanes = 4>
+        using Ensemble_Sym4 = EnsembleSimulator<details::ensemble<N, Lanes>, details::ensemble_sym4>;
+
+        template <size_t N, size_t Lanes = 4>
+        using Ensemble_Sym6 = EnsembleSimulator<details::ensemble<N, Lanes>, details::ensemble_sym6>;
+
         template <typename interactions = DefaultForce, template <typename> typename particle = DefaultParticles>
         using DefaultMethod = methods::AR_Chain_Plus<interactions, particle>;
     }  // namespace methods
@@ -11,7 +11,7 @@
 
 namespace hub::tools {
 
-    std::string auto_name(std::string const &prefix = "space_") {
+    inline std::string auto_name(std::string const &prefix = "space_") {
         static int duplicate = 1;
         static std::string last_name;
 
@@ -58,6 +58,8 @@ namespace hub::tools {
         template <typename T>
         T get(std::string const &key);
 
+        SPACEHUB_READ_ACCESSOR(auto, items, map_);
+
        private:
         std::unordered_map<std::string, std::string> map_;
     };
@@ -65,7 +67,7 @@ namespace hub::tools {
     /*---------------------------------------------------------------------------*\
           Class ConfigReader Implementation
     \*---------------------------------------------------------------------------*/
-    ConfigReader::ConfigReader(std::string const &file_name, char divider, char commenter) {
+    inline ConfigReader::ConfigReader(std::string const &file_name, char divider, char commenter) {
         std::fstream file(file_name);
         if (file.is_open()) {
             std::string line;
@@ -84,7 +86,7 @@ namespace hub::tools {
         }
     }
 
-    ConfigReader::ConfigReader(char const *file_name, char divider, char commenter)
+    inline ConfigReader::ConfigReader(char const *file_name, char divider, char commenter)
         : ConfigReader(std::string(file_name), divider, commenter) {}
 
     template <typename T>
@@ -0,0 +1,370 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file sweep.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <typeinfo>
+#include <vector>
+
+#include "../dev-tools.hpp"
+#include "../rand-generator.hpp"
+#include "../taskflow/taskflow.hpp"
+#include "config-reader.hpp"
+
+namespace hub::tools {
+
+    /*---------------------------------------------------------------------------*\
+          Class Parameters Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief One point of a parameter sweep, i.e. a set of named values.
+     */
+    class Parameters {
+       public:
+        template <typename T>
+        [[nodiscard]] T get(std::string const &key) const;
+
+        void set(std::string const &key, std::string const &value) { values_[key] = value; }
+
+        void set(std::string const &key, double value);
+
+        /**
+         * @brief Canonical text of the point, `key=value` sorted by key and separated by ','.
+         */
+        [[nodiscard]] std::string str() const;
+
+        SPACEHUB_READ_ACCESSOR(auto, values, values_);
+
+       private:
+        std::map<std::string, std::string> values_;
+    };
+
+    /*---------------------------------------------------------------------------*\
+          Class Sweep Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Expand the axes of a config file into the points of a parameter sweep.
+     *
+     * Every key of the config is an axis. The value can be
+     *
+     *  - a plain value, e.g. `mass = 1.0`, which is the same for all points;
+     *  - a list, e.g. `v_inf = [0.1, 0.3, 1]`;
+     *  - `linspace(low, high, n)` or `logspace(low, high, n)`, n evenly or log evenly spaced values;
+     *  - `lhs(low, high)`, a Latin hypercube axis.
+     *
+     * The points are the Cartesian product of the list and space axes. If there are Latin hypercube axes, each grid
+     * point is combined with a design of `sweep.samples` points over them, drawn with `sweep.seed`. Keys starting
+     * with `sweep.` are settings of the sweep and not parameters.
+     */
+    class Sweep {
+       public:
+        explicit Sweep(ConfigReader const &config);
+
+        explicit Sweep(std::string const &file_name) : Sweep(ConfigReader{file_name}) {}
+
+        SPACEHUB_READ_ACCESSOR(std::vector<Parameters>, points, points_);
+
+       private:
+        std::vector<Parameters> points_;
+    };
+
+    /*---------------------------------------------------------------------------*\
+          Class SweepRunner Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Run the points of a sweep on a thread pool and memoize their results in a local store.
+     *
+     * Results are keyed by a hash of the canonical parameters, the Solver type and a version string, and are appended
+     * to the store as soon as a point finishes. Running a sweep again, e.g. after an axis was extended, only computes
+     * the points that are not in the store. Change the version whenever the task or the code it calls changes.
+     *
+     * @code{.cpp}
+     *  tools::SweepRunner<methods::BS<>, double> runner("sweep.store", "v1");
+     *  auto results = runner.run(tools::Sweep("sweep.cfg").points(), [](tools::Parameters const &p) {
+     *      methods::BS<> sim{0, make_system(p.get<double>("v_inf"))};
+     *      ...
+     *  });
+     * @endcode
+     *
+     * @tparam Solver Simulator type used by the task.
+     * @tparam Result Result type of a point, readable and writable with >> and << as one token.
+     */
+    template <typename Solver, typename Result>
+    class SweepRunner {
+       public:
+        using Task = std::function<Result(Parameters const &)>;
+
+        /**
+         * @param[in] store File of the result store. Existing results are loaded. Empty for no persistence.
+         * @param[in] version Version of the task, part of the key.
+         */
+        explicit SweepRunner(std::string const &store = "", std::string version = "");
+
+        /**
+         * @brief Results of the points, in the order of the points.
+         */
+        std::vector<Result> run(std::vector<Parameters> const &points, Task const &task);
+
+        void set_thread_num(size_t thread_num) { thread_num_ = thread_num; };
+
+        /**
+         * @brief Key of the point in the store.
+         */
+        [[nodiscard]] std::string key(Parameters const &point) const;
+
+        SPACEHUB_READ_ACCESSOR(size_t, computed, computed_);
+
+       private:
+        std::map<std::string, Result> results_;
+
+        std::ofstream file_;
+
+        std::mutex mutex_;
+
+        std::string version_;
+
+        size_t thread_num_{std::thread::hardware_concurrency()};
+
+        size_t computed_{0};
+    };
+
+    /*---------------------------------------------------------------------------*\
+          Class Parameters Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename T>
+    T Parameters::get(std::string const &key) const {
+        auto it = values_.find(key);
+        if (it == values_.end()) {
+            spacehub_abort("Invalid key ", key, " for the sweep point!");
+        }
+        std::stringstream ss(it->second);
+        T value;
+        ss >> value;
+        return value;
+    }
+
+    inline void Parameters::set(std::string const &key, double value) {
+        std::ostringstream os;
+        os << std::setprecision(17) << value;
+        values_[key] = os.str();
+    }
+
+    inline std::string Parameters::str() const {
+        std::string text;
+        for (auto const &[key, value] : values_) {
+            text += (text.empty() ? "" : ",") + key + '=' + value;
+        }
+        return text;
+    }
+
+    /*---------------------------------------------------------------------------*\
+          Class Sweep Implementation
+    \*---------------------------------------------------------------------------*/
+    namespace detail {
+        /** @brief Split the arguments of `name(a,b,c)` or `[a,b,c]`.*/
+        inline std::vector<std::string> split_args(std::string const &value, size_t begin) {
+            std::vector<std::string> args;
+            std::stringstream ss(value.substr(begin, value.size() - begin - 1));
+            for (std::string arg; std::getline(ss, arg, ',');) {
+                args.push_back(arg);
+            }
+            return args;
+        }
+
+        inline bool starts_with(std::string const &str, std::string const &prefix) {
+            return str.compare(0, prefix.size(), prefix) == 0;
+        }
+    }  // namespace detail
+
+    inline Sweep::Sweep(ConfigReader const &config) {
+        std::map<std::string, std::string> fixed;
+        std::map<std::string, std::vector<std::string>> grid;
+        std::map<std::string, std::pair<double, double>> lhs;
+        size_t samples = 1;
+        uint64_t seed = 0;
+
+        // iterate in key order rather than in the hash order of the config
+        std::map<std::string, std::string> const items(config.items().begin(), config.items().end());
+        for (auto const &[key, value] : items) {
+            if (key == "sweep.samples") {
+                samples = std::stoul(value);
+            } else if (key == "sweep.seed") {
+                seed = std::stoull(value);
+            } else if (detail::starts_with(key, "sweep.")) {
+                spacehub_abort("Unknown sweep setting ", key, "!");
+            } else if (detail::starts_with(value, "[") && value.back() == ']') {
+                grid[key] = detail::split_args(value, 1);
+            } else if ((detail::starts_with(value, "linspace(") || detail::starts_with(value, "logspace(")) &&
+                       value.back() == ')') {
+                auto args = detail::split_args(value, 9);
+                if (args.size() != 3) {
+                    spacehub_abort("Expect (low, high, n) for the axis ", key, "!");
+                }
+                double low = std::stod(args[0]), high = std::stod(args[1]);
+                size_t n = std::stoul(args[2]);
+                bool log = value[1] == 'o';
+                if (log) {
+                    low = std::log10(low);
+                    high = std::log10(high);
+                }
+                Parameters formatter;
+                for (size_t i = 0; i < n; ++i) {
+                    double x = n > 1 ? low + (high - low) * static_cast<double>(i) / static_cast<double>(n - 1) : low;
+                    formatter.set(key, log ? std::pow(10.0, x) : x);
+                    grid[key].push_back(formatter.values().at(key));
+                }
+            } else if (detail::starts_with(value, "lhs(") && value.back() == ')') {
+                auto args = detail::split_args(value, 4);
+                if (args.size() != 2) {
+                    spacehub_abort("Expect (low, high) for the axis ", key, "!");
+                }
+                lhs[key] = {std::stod(args[0]), std::stod(args[1])};
+            } else {
+                fixed[key] = value;
+            }
+        }
+
+        // Latin hypercube design: every axis is cut into `samples` strata, each stratum is used exactly once
+        std::vector<Parameters> design(lhs.empty() ? 1 : samples);
+        uint64_t axis = 0;
+        for (auto const &[key, range] : lhs) {
+            random::Philox gen{seed, axis++};
+            std::vector<size_t> strata(samples);
+            std::iota(strata.begin(), strata.end(), 0);
+            std::shuffle(strata.begin(), strata.end(), gen);
+            for (size_t i = 0; i < samples; ++i) {
+                double u = (static_cast<double>(strata[i]) + gen.uniform()) / static_cast<double>(samples);
+                design[i].set(key, range.first + (range.second - range.first) * u);
+            }
+        }
+
+        std::vector<Parameters> points{Parameters{}};
+        for (auto const &[key, values] : grid) {
+            std::vector<Parameters> expanded;
+            expanded.reserve(points.size() * values.size());
+            for (auto const &point : points) {
+                for (auto const &value : values) {
+                    expanded.push_back(point);
+                    expanded.back().set(key, value);
+                }
+            }
+            points = std::move(expanded);
+        }
+
+        points_.reserve(points.size() * design.size());
+        for (auto const &point : points) {
+            for (auto const &sample : design) {
+                Parameters p = point;
+                for (auto const &[key, value] : fixed) {
+                    p.set(key, value);
+                }
+                for (auto const &[key, value] : sample.values()) {
+                    p.set(key, value);
+                }
+                points_.push_back(std::move(p));
+            }
+        }
+    }
+
+    /*---------------------------------------------------------------------------*\
+          Class SweepRunner Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename Solver, typename Result>
+    SweepRunner<Solver, Result>::SweepRunner(std::string const &store, std::string version)
+        : version_{std::move(version)} {
+        if (store.empty()) {
+            return;
+        }
+        std::ifstream in{store};
+        for (std::string line; std::getline(in, line);) {
+            std::istringstream is{line};
+            std::string key;
+            Result result;
+            if (is >> key >> result) {
+                results_[key] = result;
+            }
+        }
+        in.close();
+        file_.open(store, std::ios::app);
+        if (!file_) {
+            spacehub_abort("Fail to open the sweep store ", store, "!");
+        }
+    }
+
+    template <typename Solver, typename Result>
+    std::string SweepRunner<Solver, Result>::key(Parameters const &point) const {
+        // 64 bit FNV-1a
+        uint64_t hash = 14695981039346656037ULL;
+        for (auto const &text : {point.str(), std::string(typeid(Solver).name()), version_}) {
+            for (char c : text + '\n') {
+                hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+            }
+        }
+        std::ostringstream os;
+        os << std::hex << std::setw(16) << std::setfill('0') << hash;
+        return os.str();
+    }
+
+    template <typename Solver, typename Result>
+    std::vector<Result> SweepRunner<Solver, Result>::run(std::vector<Parameters> const &points, Task const &task) {
+        std::vector<Result> results(points.size());
+        std::vector<size_t> pending;
+        for (size_t i = 0; i < points.size(); ++i) {
+            if (auto it = results_.find(key(points[i])); it != results_.end()) {
+                results[i] = it->second;
+            } else {
+                pending.push_back(i);
+            }
+        }
+
+        tf::Executor executor{thread_num_ > 0 ? thread_num_ : 1};
+        tf::Taskflow taskflow;
+        taskflow.for_each_index_dynamic(static_cast<size_t>(0), pending.size(), static_cast<size_t>(1), [&](size_t k) {
+            size_t i = pending[k];
+            results[i] = task(points[i]);
+
+            std::lock_guard lock{mutex_};
+            auto const id = key(points[i]);
+            results_[id] = results[i];
+            if (file_.is_open()) {
+                file_ << id << ' ' << std::setprecision(17) << results[i] << '\t' << points[i].str() << std::endl;
+            }
+        });
+        executor.run(taskflow).wait();
+        computed_ = pending.size();
+        return results;
+    }
+}  // namespace hub::tools
@@ -66,12 +66,12 @@ namespace hub::tools {
     /*---------------------------------------------------------------------------*\
           Class Timer Implementation
     \*---------------------------------------------------------------------------*/
-    void Timer::start() {
+    inline void Timer::start() {
         active_ = true;
         start_ = std::chrono::steady_clock::now();
     }
 
-    double Timer::get_time() {
+    inline double Timer::get_time() {
         if (active_) {
             auto now = std::chrono::steady_clock::now();
             auto len = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start_);
@@ -81,12 +81,12 @@ namespace hub::tools {
             return duration_;
     }
 
-    void Timer::pause() {
+    inline void Timer::pause() {
         duration_ = get_time();
         active_ = false;
     }
 
-    void Timer::reset() {
+    inline void Timer::reset() {
         active_ = false;
         duration_ = 0;
     }
@@ -0,0 +1,99 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include <iomanip>
+#include <iostream>
+
+#include "../../src/spaceHub.hpp"
+#include "../../src/tools/timer.hpp"
+
+using namespace hub;
+using namespace unit;
+using namespace orbit;
+
+using Solver = methods::BS<>;
+using Particle = Solver::Particle;
+using Job = EnsembleJob<Particle>;
+
+template <typename Callable>
+double benchmark(Callable &&func) {
+    tools::Timer timer;
+    timer.start();
+    func();
+    return timer.get_time();
+}
+
+template <size_t Lanes>
+double run_ensemble(std::vector<Job> const &jobs, double rtol, size_t &iterations, double &utilization) {
+    methods::Ensemble_BS<3, Lanes> sim;
+    sim.set_rtol(rtol);
+    size_t next = 0;
+    double t = benchmark([&] {
+        sim.run(
+            [&](Job &job) {
+                if (next == jobs.size()) return false;
+                job = jobs[next++];
+                return true;
+            },
+            [](Job &) {});
+    });
+    iterations = sim.iteration_count();
+    utilization = static_cast<double>(sim.lane_step_count()) / static_cast<double>(Lanes * iterations);
+    return t;
+}
+
+int main(int argc, char **argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 2000;
+    double rtol = 1e-12;
+
+    // binary-single scattering as in tutorial/4_3single-binary-scattering.cpp, in N-body units
+    std::vector<Job> jobs(n);
+    for (size_t k = 0; k < n; ++k) {
+        Particle p1{1}, p2{1}, p3{1};
+        move_particles(Elliptic(p1.mass, p2.mass, 1.0, 0.0, isotherm, isotherm, isotherm, isotherm), p2);
+        move_to_COM_frame(p1, p2);
+        auto orb = scattering::incident_orbit(M_tot(p1, p2), p3.mass, 0.5, 2.0, 20.0);
+        move_particles(orb, p3);
+        move_to_COM_frame(p1, p2, p3);
+        jobs[k].id = k;
+        jobs[k].end_time = 2 * time_to_periapsis(group(p1, p2), p3);
+        jobs[k].particles = {p1, p2, p3};
+    }
+
+    double t_scalar = benchmark([&] {
+        for (auto const &job : jobs) {
+            Solver solver{0, job.particles};
+            Solver::RunArgs args;
+            args.rtol = rtol;
+            args.add_stop_condition(job.end_time);
+            solver.run(args);
+        }
+    });
+
+    size_t it4, it8;
+    double u4, u8;
+    double t4 = run_ensemble<4>(jobs, rtol, it4, u4);
+    double t8 = run_ensemble<8>(jobs, rtol, it8, u8);
+
+    std::cout << std::setprecision(4) << "systems: " << n << ", rtol: " << rtol << '\n'
+              << "BS, one Simulator per system  : " << t_scalar << " s\n"
+              << "ensemble BS, 4 lanes          : " << t4 << " s, lane utilization " << u4 << '\n'
+              << "ensemble BS, 8 lanes          : " << t8 << " s, lane utilization " << u8 << '\n';
+    return 0;
+}
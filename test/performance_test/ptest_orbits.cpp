@@ -0,0 +1,76 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include <iomanip>
+#include <iostream>
+
+#include "../../src/orbits/batch-orbits.hpp"
+#include "../../src/orbits/orbits.hpp"
+#include "../../src/tools/timer.hpp"
+
+using namespace hub;
+
+template <typename Callable>
+double benchmark(Callable &&func, size_t repeat = 5) {
+    tools::Timer timer;
+    double best = math::max_value_v<double>;
+    for (size_t r = 0; r < repeat; ++r) {
+        timer.reset();
+        timer.start();
+        func();
+        best = math::min(best, timer.get_time());
+    }
+    return best;
+}
+
+int main(int argc, char **argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+    orbit::OrbitArray<> orbits;
+    orbits.reserve(n);
+    for (size_t k = 0; k < n; ++k) {
+        orbits.emplace_back(orbit::Elliptic(random::Uniform(0.1, 10), random::Uniform(0.1, 10),
+                                            random::Uniform(0.1, 100), random::Uniform(0, 0.99), orbit::isotherm,
+                                            orbit::isotherm, orbit::isotherm, orbit::isotherm));
+    }
+
+    orbit::CoordArray<> coords;
+    coords.resize(n);
+    orbit::OrbitArray<> back;
+
+    double t_scalar = benchmark([&] {
+        for (size_t k = 0; k < n; ++k) {
+            auto [pos, vel] = orbit::orbit_to_coord<Vec3<double>>(orbits[k]);
+            coords.x[k] = pos.x, coords.y[k] = pos.y, coords.z[k] = pos.z;
+            coords.vx[k] = vel.x, coords.vy[k] = vel.y, coords.vz[k] = vel.z;
+        }
+    });
+    double t_batch_1 = benchmark([&] { orbit::orbit_to_coord(orbits, coords, 1); });
+    double t_batch = benchmark([&] { orbit::orbit_to_coord(orbits, coords); });
+    double t_inv_1 = benchmark([&] { orbit::coord_to_orbit(orbits.m1, orbits.m2, coords, back, 1); });
+    double t_inv = benchmark([&] { orbit::coord_to_orbit(orbits.m1, orbits.m2, coords, back); });
+
+    std::cout << std::setprecision(4) << "orbits: " << n << ", threads: " << multi_thread::auto_thread << '\n'
+              << "orbit_to_coord scalar loop   : " << t_scalar << " s\n"
+              << "orbit_to_coord batched (1 th): " << t_batch_1 << " s\n"
+              << "orbit_to_coord batched       : " << t_batch << " s\n"
+              << "coord_to_orbit batched (1 th): " << t_inv_1 << " s\n"
+              << "coord_to_orbit batched       : " << t_inv << " s\n";
+    return 0;
+}
@@ -105,6 +105,7 @@ void fast_test_methods(std::string const &sys_name, System const &system, double
     basic_error_test<methods::Chain_BS<>>(sys_name + "-Chain", t_end, rtol, system);
     basic_error_test<methods::AR_Chain<>>(sys_name + "-AR-chain", t_end, rtol, system);
     basic_error_test<methods::AR_Chain_Plus<>>(sys_name + "-AR-chain+", t_end, rtol, system);
+    basic_error_test<methods::KS_BS<>>(sys_name + "-KS", t_end, rtol, system);
     basic_error_test<methods::Radau_Plus<>>(sys_name + "-Radau+", t_end, rtol, system);
     basic_error_test<methods::Chain_Radau_Plus<>>(sys_name + "-Radau-chain+", t_end, rtol, system);
     basic_error_test<methods::AR_Radau_Plus<>>(sys_name + "-AR-Radau+", t_end, rtol, system);
@@ -146,7 +147,7 @@ void bench_mark_methods(std::string const &sys_name, System const &system, doubl
     std::vector<std::string> names{
         "BS",           "AR",        "Chain",           "AR-chain",       "AR-chain+", "Radau+",
         "Radau-chain+", "AR-Radau+", "AR-Radau-chain+", "AR-sym6-chain+", "AR-sym6+",  "AR-sym8-chain+",
-        "AR-sym8+",     "AR-ABITS"};
+        "AR-sym8+",     "KS",        "AR-ABITS"};
 
     // std::vector<std::string> names{"BS", "AR-chain", "AR-chain+", "AR-Radau+", "AR-sym6+", "AR-ABITS"};
 
@@ -166,6 +167,7 @@ void bench_mark_methods(std::string const &sys_name, System const &system, doubl
     cpu_t.push_back(bench_mark<methods::AR_Sym6_Plus<>>(sys_name + "-AR-sym6+", t_end, rtol, system));
     cpu_t.push_back(bench_mark<methods::AR_Sym8_Chain_Plus<>>(sys_name + "-AR-sym8-chain+", t_end, rtol, system));
     cpu_t.push_back(bench_mark<methods::AR_Sym8_Plus<>>(sys_name + "-AR-sym8+", t_end, rtol, system));
+    cpu_t.push_back(bench_mark<methods::KS_BS<>>(sys_name + "-KS", t_end, rtol, system));
 #ifdef MPFR_VERSION_MAJOR
     cpu_t.push_back(bench_mark<methods::AR_ABITS<>>(sys_name + "-AR-ABITS", t_end, rtol, system));
 #else
@@ -17,14 +17,102 @@ License
     for more details. You should have received a copy of the GPL-3.0 License along
     with SpaceHub.
 \*---------------------------------------------------------------------------*/
+#include <vector>
+
+#include "../../src/interaction/interaction.hpp"
+#include "../../src/interaction/newtonian.hpp"
+#include "../../src/particle-system/archain.hpp"
+#include "../../src/particle-system/base-system.hpp"
+#include "../../src/particle-system/regu-system.hpp"
+#include "../../src/particles/point-particles.hpp"
 #include "../catch.hpp"
 #include "utest.hpp"
-#include "../../src/particle-system/base-system.hpp"
 
 TEST_CASE("Base system") {
     using namespace hub;
     using namespace hub::system;
 
+    using Type = Types<utest_scalar>;
+    using Particles = particles::PointParticles<Type>;
+    using Particle = typename Particles::Particle;
+    using Force = force::Interactions<force::NewtonianGrav>;
+
+    std::vector<Particle> ptcs;
+    for (size_t i = 0; i < 8; ++i) {
+        ptcs.emplace_back(1 + 0.5 * UTEST_RAND, 10 * UTEST_RAND, 10 * UTEST_RAND, 10 * UTEST_RAND, UTEST_RAND,
+                          UTEST_RAND, UTEST_RAND);
+    }
+
+    auto check_diagnostics = [](auto const &sys) {
+        auto const &diag = sys.diagnostics();
+        auto U = calc::calc_potential_energy(sys);
+        auto T = calc::calc_kinetic_energy(sys);
+        REQUIRE(diag.potential_energy() == Approx(U).epsilon(1e-12));
+        REQUIRE(diag.kinetic_energy() == Approx(T).epsilon(1e-12));
+        REQUIRE(diag.total_energy() == Approx(U + T).epsilon(1e-12));
+        typename std::decay_t<decltype(sys)>::Vector L{0, 0, 0};
+        for (size_t i = 0; i < sys.number(); ++i) {
+            L += sys.mass(i) * cross(sys.pos(i), sys.vel(i));
+        }
+        REQUIRE(diag.angular_momentum().x == Approx(L.x).epsilon(1e-12));
+        REQUIRE(diag.angular_momentum().y == Approx(L.y).epsilon(1e-12));
+        REQUIRE(diag.angular_momentum().z == Approx(L.z).epsilon(1e-12));
+    };
+
+    SECTION("partial acceleration of the active particles") {
+        SimpleSystem<Particles, Force> sys(0, ptcs);
+        typename Particles::VectorArray full(ptcs.size());
+        typename Particles::VectorArray part(ptcs.size());
+        sys.evaluate_acc(full);
+        typename Particles::IdxArray active{1, 4, 7};
+        sys.evaluate_acc(active, part);
+        for (size_t i : active) {
+            REQUIRE(norm(part[i] - full[i]) == Approx(0).margin(1e-12 * norm(full[i])));
+        }
+    }
+
+    SECTION("diagnostics follow drift and kick") {
+        SimpleSystem<Particles, Force> sys(0, ptcs);
+        REQUIRE(sys.diagnostics().initial_energy() == sys.diagnostics().total_energy());
+        check_diagnostics(sys);
+        sys.kick(0.01);
+        check_diagnostics(sys);
+        sys.drift(0.01);
+        check_diagnostics(sys);
+        sys.pos(0) += Vec3<utest_scalar>{1, 0, 0};
+        sys.invalidate_diagnostics();
+        check_diagnostics(sys);
+    }
+
+    SECTION("initial energy of a system that moved before the first query") {
+        SimpleSystem<Particles, Force> sys(0, ptcs);
+        SimpleSystem<Particles, Force> ref(0, ptcs);
+        sys.drift(0.01);
+        sys.kick(0.01);
+        REQUIRE(sys.diagnostics().initial_energy() == Approx(ref.diagnostics().total_energy()));
+    }
 
+    SECTION("regularized diagnostics reuse the kick potential") {
+        RegularizedSystem<Particles, Force, ReguType::LogH> sys(0, ptcs);
+        auto E0 = sys.diagnostics().initial_energy();
+        for (size_t i = 0; i < 10; ++i) {
+            sys.drift(0.005);
+            sys.kick(0.01);
+            check_diagnostics(sys);
+            sys.drift(0.005);
+        }
+        check_diagnostics(sys);
+        REQUIRE(sys.diagnostics().initial_energy() == E0);
+    }
 
-}
\ No newline at end of file
+    SECTION("chain diagnostics") {
+        ARchainSystem<Particles, Force, ReguType::LogH> sys(0, ptcs);
+        for (size_t i = 0; i < 10; ++i) {
+            sys.drift(0.005);
+            sys.kick(0.01);
+            sys.drift(0.005);
+            sys.post_iter_process();
+            check_diagnostics(sys);
+        }
+    }
+}
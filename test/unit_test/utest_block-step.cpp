@@ -0,0 +1,58 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include <algorithm>
+#include <vector>
+
+#include "../../src/integrator/Hermite.hpp"
+#include "../../src/interaction/interaction.hpp"
+#include "../../src/interaction/newtonian.hpp"
+#include "../../src/ode-iterator/block-step.hpp"
+#include "../../src/ode-iterator/step-controller/Aarseth-controller.hpp"
+#include "../../src/particle-system/base-system.hpp"
+#include "../../src/particles/point-particles.hpp"
+#include "../catch.hpp"
+#include "utest.hpp"
+
+TEST_CASE("Block time steps") {
+    using namespace hub;
+    using namespace hub::system;
+
+    using Type = Types<utest_scalar>;
+    using Particles = particles::PointParticles<Type>;
+    using Particle = typename Particles::Particle;
+    using Force = force::Interactions<force::NewtonianGrav>;
+    using System = SimpleSystem<Particles, Force>;
+
+    std::vector<Particle> triple{Particle{1, -0.5, 0, 0, 0, -0.5, 0}, Particle{1, 0.5, 0, 0, 0, 0.5, 0},
+                                 Particle{1e-3, 50, 0, 0, 0, 0.2, 0}};
+
+    System sys(0, triple);
+    ode::BlockStepIterator<integrator::Hermite2<Type>, ode::AarsethController<Type>> iter;
+    auto E0 = calc::calc_total_energy(sys);
+    iter.set_rtol(1e-9);
+    for (utest_scalar h = 1; sys.time() < 20;) {
+        h = iter.iterate(sys, std::min(h, 20 - sys.time()));
+    }
+
+    REQUIRE(sys.time() == Approx(20));
+    REQUIRE(calc::calc_total_energy(sys) == Approx(E0).epsilon(1e-5));
+    // the binary is active at every block time, the distant body stays on a long step
+    REQUIRE(iter.eval_count() < 2.01 * iter.block_count());
+}
@@ -18,13 +18,15 @@ License
     with SpaceHub.
 \*---------------------------------------------------------------------------*/
 
+#include <algorithm>
 #include <iomanip>
+#include <list>
+#include <tuple>
 
 #include "../../src/particle-system/chain.hpp"
 #include "../../src/type-class.hpp"
 #include "../catch.hpp"
 #include "utest.hpp"
-// TODO test update_chain()
 TEST_CASE("particle system chain xy") {
     using type_sys = hub::Types<utest_scalar>;
     using VectorArray = typename type_sys::VectorArray;
@@ -179,4 +181,123 @@ TEST_CASE("particle system chain yz") {
             REQUIRE(pos[i].z == APPROX(cartesian_pos[i].z));
         }
     }
-}
\ No newline at end of file
+}
+
+template <typename VectorArray>
+auto reference_chain_index(VectorArray const &pos) {
+    // Greedy chain over the sorted pair list, as the chain was originally defined.
+    std::vector<std::tuple<double, size_t, size_t>> pairs;
+    for (size_t i = 0; i < pos.size(); ++i) {
+        for (size_t j = i + 1; j < pos.size(); ++j) {
+            pairs.emplace_back(norm2(pos[j] - pos[i]), i, j);
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    std::list<size_t> chain{std::get<1>(pairs[0]), std::get<2>(pairs[0])};
+    auto in_chain = [&](size_t k) { return std::find(chain.begin(), chain.end(), k) != chain.end(); };
+    while (chain.size() < pos.size()) {
+        for (auto [r, i, j] : pairs) {
+            if (chain.front() == i && !in_chain(j)) {
+                chain.push_front(j);
+                break;
+            } else if (chain.front() == j && !in_chain(i)) {
+                chain.push_front(i);
+                break;
+            } else if (chain.back() == i && !in_chain(j)) {
+                chain.push_back(j);
+                break;
+            } else if (chain.back() == j && !in_chain(i)) {
+                chain.push_back(i);
+                break;
+            }
+        }
+    }
+    return std::vector<size_t>{chain.begin(), chain.end()};
+}
+
+TEST_CASE("particle system chain random") {
+    using type_sys = hub::Types<utest_scalar>;
+    using VectorArray = typename type_sys::VectorArray;
+    using IdxArray = typename type_sys::IdxArray;
+
+    SECTION("create index") {
+        for (size_t n : {2, 3, 5, 20, 50}) {
+            for (size_t trial = 0; trial < 20; ++trial) {
+                VectorArray pos;
+                for (size_t i = 0; i < n; ++i) {
+                    pos.emplace_back(UTEST_RAND, UTEST_RAND, UTEST_RAND);
+                }
+                IdxArray idx;
+                hub::Chain::calc_chain_index(pos, idx);
+                auto expected = reference_chain_index(pos);
+                REQUIRE(std::equal(idx.begin(), idx.end(), expected.begin(), expected.end()));
+            }
+        }
+    }
+
+    SECTION("repair index") {
+        VectorArray pos;
+        for (size_t i = 0; i < 10; ++i) {
+            pos.emplace_back(i, 0.1 * UTEST_RAND, 0);
+        }
+        IdxArray idx{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+        REQUIRE_FALSE(hub::Chain::repair_chain_index(pos, idx));
+
+        std::swap(idx[3], idx[4]);
+        std::swap(idx[7], idx[8]);
+        REQUIRE(hub::Chain::repair_chain_index(pos, idx));
+        REQUIRE(idx == IdxArray{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+    }
+}
+
+TEST_CASE("particle system chain update") {
+    using type_sys = hub::Types<utest_scalar>;
+    using VectorArray = typename type_sys::VectorArray;
+    using IdxArray = typename type_sys::IdxArray;
+
+    constexpr size_t n = 12;
+    VectorArray pos;
+    for (size_t i = 0; i < n; ++i) {
+        pos.emplace_back(UTEST_RAND, UTEST_RAND, UTEST_RAND);
+    }
+    IdxArray idx;
+    hub::Chain::calc_chain_index(pos, idx);
+    VectorArray chain{n};
+    hub::Chain::calc_chain(pos, chain, idx);
+
+    SECTION("update chain") {
+        IdxArray new_idx = idx;
+        std::swap(new_idx[2], new_idx[3]);
+        std::swap(new_idx[0], new_idx[n - 1]);
+        std::reverse(new_idx.begin() + 5, new_idx.begin() + 9);
+
+        VectorArray expected{n};
+        hub::Chain::calc_chain(pos, expected, new_idx);
+        hub::Chain::update_chain(chain, pos, idx, new_idx);
+        for (size_t i = 0; i < n; ++i) {
+            REQUIRE(chain[i].x == Approx(expected[i].x).margin(1e-14));
+            REQUIRE(chain[i].y == Approx(expected[i].y).margin(1e-14));
+            REQUIRE(chain[i].z == Approx(expected[i].z).margin(1e-14));
+        }
+    }
+
+    SECTION("validity") {
+        VectorArray line;
+        for (size_t i = 0; i < 6; ++i) {
+            line.emplace_back(i, 0, 0);
+        }
+        IdxArray line_idx{0, 1, 2, 3, 4, 5};
+        VectorArray line_chain{6};
+        hub::Chain::calc_chain(line, line_chain, line_idx);
+        REQUIRE(hub::Chain::is_valid_chain(line_chain));
+
+        IdxArray new_idx;
+        REQUIRE_FALSE(hub::Chain::refresh_chain_index(line, line_chain, line_idx, new_idx));
+
+        IdxArray broken_idx{0, 1, 3, 2, 4, 5};
+        hub::Chain::calc_chain(line, line_chain, broken_idx);
+        REQUIRE_FALSE(hub::Chain::is_valid_chain(line_chain));
+        REQUIRE(hub::Chain::refresh_chain_index(line, line_chain, broken_idx, new_idx));
+        REQUIRE(new_idx == line_idx);
+    }
+}
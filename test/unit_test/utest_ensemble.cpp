@@ -0,0 +1,147 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "../../src/ensemble-simulator.hpp"
+#include "../../src/integrator/symplectic/symplectic-integrator.hpp"
+#include "../../src/interaction/interaction.hpp"
+#include "../../src/interaction/newtonian.hpp"
+#include "../../src/ode-iterator/ensemble-iterator.hpp"
+#include "../../src/particle-system/base-system.hpp"
+#include "../../src/particle-system/ensemble-system.hpp"
+#include "../../src/particles/point-particles.hpp"
+#include "../catch.hpp"
+#include "utest.hpp"
+
+TEST_CASE("Ensemble system") {
+    using namespace hub;
+    using namespace hub::system;
+
+    using Type = Types<utest_scalar>;
+    using Particles = particles::PointParticles<Type>;
+    using Particle = typename Particles::Particle;
+    using Force = force::Interactions<force::NewtonianGrav>;
+    using Ensemble = EnsembleSystem<Type, 3, 4>;
+
+    auto make_triple = [](size_t k) {
+        utest_scalar c = 0.5 * std::cos(0.7 * static_cast<utest_scalar>(k));
+        utest_scalar s = 0.5 * std::sin(0.7 * static_cast<utest_scalar>(k));
+        Particle p1{1, -c, -s, 0, s, -c, 0};
+        Particle p2{1, c, s, 0, -s, c, 0};
+        Particle p3{0.1 * static_cast<utest_scalar>(k + 1), 10, 1, 0, -0.3, 0.1, 0.05};
+        return std::vector<Particle>{p1, p2, p3};
+    };
+
+    SECTION("lanes evolve as independent systems") {
+        Ensemble ensemble;
+        std::vector<SimpleSystem<Particles, Force>> systems;
+        typename Ensemble::Scalar h;
+        for (size_t l = 0; l < Ensemble::lanes; ++l) {
+            ensemble.load(l, 0, make_triple(l));
+            systems.emplace_back(0, make_triple(l));
+            h[l] = 1e-3 * static_cast<utest_scalar>(l + 1);
+        }
+
+        integrator::Symplectic4th<Type> sym4;
+        for (size_t i = 0; i < 100; ++i) {
+            sym4.integrate(ensemble, h);
+            for (size_t l = 0; l < Ensemble::lanes; ++l) {
+                sym4.integrate(systems[l], h[l]);
+            }
+        }
+
+        std::vector<Particle> ptc = make_triple(0);
+        for (size_t l = 0; l < Ensemble::lanes; ++l) {
+            ensemble.store(l, ptc);
+            REQUIRE(ensemble.time(l) == Approx(systems[l].time()));
+            for (size_t i = 0; i < 3; ++i) {
+                REQUIRE(norm(ptc[i].pos - systems[l].pos(i)) == Approx(0).margin(1e-12));
+                REQUIRE(norm(ptc[i].vel - systems[l].vel(i)) == Approx(0).margin(1e-12));
+            }
+        }
+    }
+
+    SECTION("refilled lanes with per-lane step control") {
+        EnsembleSimulator<Ensemble, ode::EnsembleBulirschStoer<Ensemble>> sim;
+        sim.set_rtol(1e-12);
+
+        size_t const job_num = 11;
+        size_t next = 0;
+        std::vector<bool> done(job_num, false);
+        sim.run(
+            [&](auto &job) {
+                if (next == job_num) return false;
+                job.id = next;
+                job.time = 0;
+                job.end_time = 5 + static_cast<utest_scalar>(next);
+                job.particles = make_triple(next++);
+                return true;
+            },
+            [&](auto &job) {
+                REQUIRE_FALSE(done[job.id]);
+                done[job.id] = true;
+                REQUIRE(job.time == 5 + static_cast<utest_scalar>(job.id));
+
+                auto init = make_triple(job.id);
+                SimpleSystem<Particles, Force> reference(0, init);
+                for (size_t i = 0; i < 3; ++i) {
+                    job.particles[i].mass = init[i].mass;
+                }
+                SimpleSystem<Particles, Force> result(job.time, job.particles);
+                REQUIRE(calc::calc_total_energy(result) ==
+                        Approx(calc::calc_total_energy(reference)).epsilon(1e-10));
+            });
+
+        REQUIRE(std::all_of(done.begin(), done.end(), [](bool d) { return d; }));
+        REQUIRE(sim.lane_step_count() <= Ensemble::lanes * sim.iteration_count());
+    }
+
+    SECTION("jobs already at their end time") {
+        EnsembleSimulator<Ensemble, ode::EnsembleBulirschStoer<Ensemble>> sim;
+
+        size_t const job_num = 9;
+        size_t next = 0;
+        std::vector<bool> done(job_num, false);
+        sim.run(
+            [&](auto &job) {
+                if (next == job_num) return false;
+                job.id = next;
+                job.time = 2;
+                job.end_time = next % 3 == 0 ? 3 : 2;
+                job.particles = make_triple(next++);
+                return true;
+            },
+            [&](auto &job) {
+                REQUIRE_FALSE(done[job.id]);
+                done[job.id] = true;
+                REQUIRE(job.time == job.end_time);
+                if (job.id % 3 != 0) {
+                    auto init = make_triple(job.id);
+                    for (size_t i = 0; i < 3; ++i) {
+                        REQUIRE(norm(job.particles[i].pos - init[i].pos) == 0);
+                    }
+                }
+            });
+
+        REQUIRE(std::all_of(done.begin(), done.end(), [](bool d) { return d; }));
+    }
+}
@@ -0,0 +1,94 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "../../src/integrator/Hermite.hpp"
+#include "../../src/interaction/interaction.hpp"
+#include "../../src/interaction/newtonian.hpp"
+#include "../../src/ode-iterator/block-step.hpp"
+#include "../../src/ode-iterator/shared-step.hpp"
+#include "../../src/ode-iterator/step-controller/Aarseth-controller.hpp"
+#include "../../src/particle-system/base-system.hpp"
+#include "../../src/particles/point-particles.hpp"
+#include "../catch.hpp"
+#include "utest.hpp"
+
+TEST_CASE("Hermite integrators") {
+    using namespace hub;
+    using namespace hub::system;
+
+    using Type = Types<utest_scalar>;
+    using Particles = particles::PointParticles<Type>;
+    using Particle = typename Particles::Particle;
+    using Force = force::Interactions<force::NewtonianGrav>;
+    using System = SimpleSystem<Particles, Force>;
+
+    // e = 0.5 binary with unit semi-major axis, integrated over one period at a fixed step
+    std::vector<Particle> binary{Particle{0.5, -0.25, 0, 0, 0, -std::sqrt(3.0) / 2, 0},
+                                 Particle{0.5, 0.25, 0, 0, 0, std::sqrt(3.0) / 2, 0}};
+
+    auto energy_error = [&](auto integrator, size_t steps) {
+        System sys(0, binary);
+        auto E0 = calc::calc_total_energy(sys);
+        utest_scalar h = 2 * consts::pi / static_cast<utest_scalar>(steps);
+        for (size_t i = 0; i < steps; ++i) {
+            integrator.integrate(sys, h);
+        }
+        REQUIRE(sys.time() == Approx(2 * consts::pi));
+        return std::abs((calc::calc_total_energy(sys) - E0) / E0);
+    };
+
+    SECTION("convergence order") {
+        auto err4 = energy_error(integrator::Hermite4<Type>{}, 400);
+        REQUIRE(err4 < 1e-6);
+        REQUIRE(err4 / energy_error(integrator::Hermite4<Type>{}, 800) > 12);
+
+        auto err6 = energy_error(integrator::Hermite6<Type>{}, 400);
+        REQUIRE(err6 < 1e-8);
+        REQUIRE(err6 / energy_error(integrator::Hermite6<Type>{}, 800) > 40);
+    }
+
+    SECTION("adaptive steps") {
+        std::vector<Particle> triple{Particle{1, -0.5, 0, 0, 0, -0.5, 0}, Particle{1, 0.5, 0, 0, 0, 0.5, 0},
+                                     Particle{1e-3, 50, 0, 0, 0, 0.2, 0}};
+        System shared_sys(0, triple);
+        System block_sys(0, triple);
+        auto E0 = calc::calc_total_energy(shared_sys);
+
+        ode::SharedStepIterator<integrator::Hermite6<Type>, ode::AarsethController<Type>> shared;
+        ode::BlockStepIterator<integrator::Hermite4<Type>, ode::AarsethController<Type>> block;
+        shared.set_rtol(1e-12);
+        block.set_rtol(1e-12);
+        for (utest_scalar h = 1; shared_sys.time() < 20;) {
+            h = shared.iterate(shared_sys, std::min(h, 20 - shared_sys.time()));
+        }
+        for (utest_scalar h = 1; block_sys.time() < 20;) {
+            h = block.iterate(block_sys, std::min(h, 20 - block_sys.time()));
+        }
+
+        REQUIRE(shared_sys.time() == Approx(20));
+        REQUIRE(block_sys.time() == Approx(20));
+        REQUIRE(calc::calc_total_energy(shared_sys) == Approx(E0).epsilon(1e-9));
+        REQUIRE(calc::calc_total_energy(block_sys) == Approx(E0).epsilon(1e-8));
+        REQUIRE(block.eval_count() < 2.1 * block.block_count());
+    }
+}
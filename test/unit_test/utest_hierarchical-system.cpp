@@ -0,0 +1,82 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include <vector>
+
+#include "../../src/interaction/interaction.hpp"
+#include "../../src/interaction/newtonian.hpp"
+#include "../../src/particle-system/hierarchical-system.hpp"
+#include "../../src/particles/point-particles.hpp"
+#include "../catch.hpp"
+#include "utest.hpp"
+
+TEST_CASE("Hierarchical system") {
+    using namespace hub;
+    using namespace hub::system;
+
+    using Type = Types<utest_scalar>;
+    using Particles = particles::PointParticles<Type>;
+    using Particle = typename Particles::Particle;
+    using Force = force::Interactions<force::NewtonianGrav>;
+
+    // a tight binary with a distant third body
+    std::vector<Particle> ptcs{Particle{1, -0.05, 0, 0, 0, -sqrt(5.0), 0}, Particle{1, 0.05, 0, 0, 0, sqrt(5.0), 0},
+                               Particle{1, 20, 0, 0, 0, 0.3, 0}};
+
+    SECTION("partition into subsystems") {
+        HierarchicalSystem<Particles, Force> sys(0, ptcs);
+        REQUIRE(sys.subsystem_number() == 2);
+        REQUIRE(sys.subsystem_index()[0] == sys.subsystem_index()[1]);
+        REQUIRE(sys.subsystem_index()[0] != sys.subsystem_index()[2]);
+    }
+
+    SECTION("kick moves subsystems as a whole") {
+        HierarchicalSystem<Particles, Force> sys(0, ptcs);
+        auto dv0 = sys.vel(1) - sys.vel(0);
+        auto p0 = sys.vel(0) + sys.vel(1) + sys.vel(2);
+        sys.kick(0.1);
+        REQUIRE(norm(sys.vel(1) - sys.vel(0) - dv0) == Approx(0).margin(1e-15));
+        REQUIRE(norm(sys.vel(0) + sys.vel(1) + sys.vel(2) - p0) == Approx(0).margin(1e-14));
+    }
+
+    SECTION("subsystems are advanced to the tolerance") {
+        HierarchicalSystem<Particles, Force> once(0, ptcs);
+        HierarchicalSystem<Particles, Force> twice(0, ptcs);
+        once.drift(1);
+        twice.drift(0.5);
+        twice.drift(0.5);
+        REQUIRE(once.time() == Approx(1));
+        REQUIRE(twice.time() == Approx(1));
+        for (size_t i = 0; i < 3; ++i) {
+            REQUIRE(norm(once.pos(i) - twice.pos(i)) == Approx(0).margin(1e-9));
+        }
+    }
+
+    SECTION("subsystems land on the end of every drift") {
+        HierarchicalSystem<Particles, Force> sys(0, ptcs);
+        integrator::LeapFrogDKD<Type> leapfrog;
+        auto E0 = calc::calc_total_energy(sys);
+        for (size_t i = 0; i < 2000; ++i) {
+            sys.pre_iter_process();
+            leapfrog.integrate(sys, 0.01);
+        }
+        REQUIRE(sys.subsystem_number() == 2);
+        REQUIRE(calc::calc_total_energy(sys) == Approx(E0).epsilon(1e-6));
+    }
+}
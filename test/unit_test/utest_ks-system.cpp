@@ -0,0 +1,141 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include <vector>
+
+#include "../../src/interaction/interaction.hpp"
+#include "../../src/interaction/newtonian.hpp"
+#include "../../src/particle-system/ks-system.hpp"
+#include "../../src/particles/point-particles.hpp"
+#include "../catch.hpp"
+#include "utest.hpp"
+
+TEST_CASE("KS regularized system") {
+    using namespace hub;
+    using namespace hub::system;
+
+    using Type = Types<utest_scalar>;
+    using Particles = particles::PointParticles<Type>;
+    using Particle = typename Particles::Particle;
+    using Vector = Vec3<utest_scalar>;
+    using Force = force::Interactions<force::NewtonianGrav>;
+
+    SECTION("KS transformation") {
+        for (size_t i = 0; i < RAND_TEST_NUM; ++i) {
+            Vector pos{UTEST_RAND, UTEST_RAND, UTEST_RAND};
+            Vector vel{UTEST_RAND, UTEST_RAND, UTEST_RAND};
+            KS::Vector4<utest_scalar> u, up;
+            KS::from_cartesian(pos, vel, u, up);
+
+            REQUIRE(KS::norm2(u) == Approx(norm(pos)).epsilon(1e-12));
+            // bilinear relation
+            REQUIRE(u[3] * up[0] - u[2] * up[1] + u[1] * up[2] - u[0] * up[3] == Approx(0).margin(1e-12));
+
+            auto new_pos = KS::to_cartesian_pos<Vector>(u);
+            auto new_vel = KS::to_cartesian_vel<Vector>(u, up);
+            REQUIRE(norm(new_pos - pos) == Approx(0).margin(1e-12 * norm(pos)));
+            REQUIRE(norm(new_vel - vel) == Approx(0).margin(1e-12 * norm(vel)));
+
+            REQUIRE(KS::kepler_energy(u, up, 2.0) == Approx(0.5 * norm2(vel) - 2.0 / norm(pos)).epsilon(1e-10));
+        }
+    }
+
+    SECTION("pair selection and Cartesian sync") {
+        std::vector<Particle> ptcs{Particle{1, 0, 0, 0, 0, 0, 0}, Particle{1e-3, 10, 0, 0, 0, 0.3, 0},
+                                   Particle{0.5, 1e-2, 1e-3, 0, 0.1, 7, 0}};
+        KSRegularizedSystem<Particles, Force> sys(0, ptcs);
+        auto pair = sys.ks_pair();
+        REQUIRE(pair[0] == 0);
+        REQUIRE(pair[1] == 2);
+        for (size_t i = 0; i < ptcs.size(); ++i) {
+            REQUIRE(norm(sys.pos(i) - ptcs[i].pos) == Approx(0).margin(1e-14));
+            REQUIRE(norm(sys.vel(i) - ptcs[i].vel) == Approx(0).margin(1e-12));
+        }
+        REQUIRE(sys.step_scale() == Approx(1 / norm(ptcs[2].pos - ptcs[0].pos)));
+    }
+
+    SECTION("unperturbed pair keeps the Kepler energy") {
+        std::vector<Particle> ptcs{Particle{1, 0, 0, 0, 0, 0, 0}, Particle{1e-3, 1, 0, 0, 0, 0.01, 0}};
+        KSRegularizedSystem<Particles, Force> sys(0, ptcs);
+        auto h0 = sys.kepler_energy();
+        auto E0 = calc::calc_total_energy(sys);
+        for (size_t i = 0; i < 1000; ++i) {
+            sys.drift(0.005);
+            sys.kick(0.01);
+            sys.drift(0.005);
+        }
+        REQUIRE(sys.kepler_energy() == h0);
+        // the oscillator itself is only second order accurate in the fictitious time step
+        REQUIRE(calc::calc_total_energy(sys) == Approx(E0).epsilon(1e-3));
+    }
+
+    SECTION("slow-down of a weakly perturbed pair") {
+        utest_scalar R = 1000;
+        std::vector<Particle> ptcs{Particle{1, -0.5, 0, 0, 0, -0.85, 0}, Particle{1, 0.5, 0, 0, 0, 0.85, 0},
+                                   Particle{1, R, 0, 0, 0, 0, 0.05}};
+        KSRegularizedSystem<Particles, Force> plain(0, ptcs);
+        SlowDownKSSystem<Particles, Force> sys(0, ptcs);
+        REQUIRE(sys.slow_down() == 1);
+
+        auto h0 = sys.kepler_energy();
+        for (size_t i = 0; i < 20000; ++i) {
+            sys.pre_iter_process();
+            sys.drift(0.0025);
+            sys.kick(0.005);
+            sys.drift(0.0025);
+            sys.post_iter_process();
+            plain.post_iter_process();
+        }
+        // tidal perturbation ~ 2 m3 r / R^3 gives kappa ~ sqrt(1e-6 R^3 / r^3) ~ 10
+        REQUIRE(sys.slow_down() > 2);
+        REQUIRE(sys.slow_down() < 100);
+        REQUIRE(plain.slow_down() == 1);
+        REQUIRE(sys.kepler_energy() == Approx(h0).epsilon(1e-3));
+        REQUIRE(sys.step_scale() == Approx(1 / (sys.slow_down() * KS::norm2(sys.ks_pos()))));
+    }
+
+    SECTION("unperturbed pair is propagated analytically") {
+        std::vector<Particle> ptcs{Particle{1, 0, 0, 0, 0, 0, 0}, Particle{1e-3, 1, 0, 0, 0, 1, 0},
+                                   Particle{1e-3, 1e5, 0, 0, 0, 0, 0}};
+        KSRegularizedSystem<Particles, Force> sys(0, ptcs);
+        REQUIRE_FALSE(sys.is_unperturbed());
+
+        sys.set_unperturbed_tol(1e-10);
+        REQUIRE(sys.is_unperturbed());
+
+        utest_scalar mu = 1 + 1e-3;
+        utest_scalar a = -0.5 * mu / sys.kepler_energy();
+        utest_scalar period = 2 * consts::pi * sqrt(a * a * a / mu);
+        REQUIRE(sys.step_scale() == Approx(1 / a));
+
+        auto dr0 = sys.pos(1) - sys.pos(0);
+        auto dv0 = sys.vel(1) - sys.vel(0);
+        sys.drift(100.25 * period / a);
+        REQUIRE(sys.time() == Approx(100.25 * period));
+        sys.drift(-0.25 * period / a);
+        REQUIRE(norm(sys.pos(1) - sys.pos(0) - dr0) == Approx(0).margin(1e-10));
+        REQUIRE(norm(sys.vel(1) - sys.vel(0) - dv0) == Approx(0).margin(1e-10));
+
+        // a close perturber brings the pair back to the numerical drift
+        std::vector<Particle> close{ptcs[0], ptcs[1], Particle{1e-3, 3, 0, 0, 0, 0, 0}};
+        KSRegularizedSystem<Particles, Force> perturbed(0, close);
+        perturbed.set_unperturbed_tol(1e-10);
+        REQUIRE_FALSE(perturbed.is_unperturbed());
+    }
+}
@@ -0,0 +1,108 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include "../../src/orbits/batch-orbits.hpp"
+#include "../../src/orbits/orbits.hpp"
+#include "../catch.hpp"
+#include "utest.hpp"
+
+using namespace hub;
+
+TEST_CASE("Kepler equation") {
+    SECTION("elliptic") {
+        for (size_t i = 0; i < RAND_TEST_NUM; ++i) {
+            double e = random::Uniform(0, 1);
+            double M = random::Uniform(-20, 20);
+            double E = orbit::M_anomaly_to_E_anomaly(M, e);
+            REQUIRE(E - e * sin(E) == Approx(M).epsilon(1e-13).margin(1e-13));
+        }
+    }
+
+    SECTION("high eccentricity") {
+        for (size_t i = 0; i < RAND_TEST_NUM; ++i) {
+            double e = 1 - pow(10, random::Uniform(-12, -1));
+            double M = random::Uniform(-consts::pi, consts::pi);
+            double E = orbit::M_anomaly_to_E_anomaly(M, e);
+            REQUIRE(E - e * sin(E) == Approx(M).epsilon(1e-13).margin(1e-13));
+        }
+    }
+
+    SECTION("hyperbolic") {
+        for (size_t i = 0; i < RAND_TEST_NUM; ++i) {
+            double e = 1 + pow(10, random::Uniform(-6, 2));
+            double M = random::Uniform(-1, 1) * pow(10, random::Uniform(-3, 4));
+            double H = orbit::M_anomaly_to_E_anomaly(M, e);
+            REQUIRE(e * sinh(H) - H == Approx(M).epsilon(1e-12).margin(1e-12));
+        }
+    }
+
+    SECTION("parabolic") {
+        for (size_t i = 0; i < RAND_TEST_NUM; ++i) {
+            double M = random::Uniform(-100, 100);
+            double D = orbit::M_anomaly_to_E_anomaly(M, 1.0);
+            REQUIRE(D + D * D * D / 3 == Approx(M).epsilon(1e-13).margin(1e-13));
+        }
+    }
+
+    SECTION("batched") {
+        std::vector<double> M(RAND_TEST_NUM), e(RAND_TEST_NUM), nu(RAND_TEST_NUM);
+        for (size_t i = 0; i < RAND_TEST_NUM; ++i) {
+            M[i] = random::Uniform(-consts::pi, consts::pi);
+            e[i] = random::Uniform(0, 0.99);
+        }
+        orbit::M_anomaly_to_T_anomaly(M, e, nu);
+        for (size_t i = 0; i < RAND_TEST_NUM; ++i) {
+            REQUIRE(nu[i] == APPROX(orbit::M_anomaly_to_T_anomaly(M[i], e[i])));
+            REQUIRE(orbit::T_anomaly_to_M_anomaly(nu[i], e[i]) == Approx(M[i]).epsilon(1e-12).margin(1e-12));
+        }
+    }
+}
+
+TEST_CASE("Batched orbit conversion") {
+    constexpr size_t n = 2 * orbit::batch_multi_thread_threshold + 7;
+    orbit::OrbitArray<> orbits;
+    orbits.reserve(n);
+    for (size_t k = 0; k < n; ++k) {
+        orbits.emplace_back(orbit::Elliptic(random::Uniform(0.1, 10), random::Uniform(0.1, 10),
+                                            random::Uniform(0.1, 100), random::Uniform(0, 0.99), orbit::isotherm,
+                                            orbit::isotherm, orbit::isotherm, orbit::isotherm));
+    }
+
+    orbit::CoordArray<> coords;
+    orbit::orbit_to_coord(orbits, coords);
+    REQUIRE(coords.size() == n);
+
+    for (size_t k = 0; k < n; ++k) {
+        auto [pos, vel] = orbit::orbit_to_coord<Vec3<double>>(orbits[k]);
+        REQUIRE(coords.x[k] == Approx(pos.x).epsilon(1e-13).margin(1e-13));
+        REQUIRE(coords.y[k] == Approx(pos.y).epsilon(1e-13).margin(1e-13));
+        REQUIRE(coords.z[k] == Approx(pos.z).epsilon(1e-13).margin(1e-13));
+        REQUIRE(coords.vx[k] == Approx(vel.x).epsilon(1e-13).margin(1e-13));
+        REQUIRE(coords.vy[k] == Approx(vel.y).epsilon(1e-13).margin(1e-13));
+        REQUIRE(coords.vz[k] == Approx(vel.z).epsilon(1e-13).margin(1e-13));
+    }
+
+    orbit::OrbitArray<> back;
+    orbit::coord_to_orbit(orbits.m1, orbits.m2, coords, back);
+    for (size_t k = 0; k < n; ++k) {
+        REQUIRE(back.p[k] == Approx(orbits.p[k]).epsilon(1e-10));
+        REQUIRE(back.e[k] == Approx(orbits.e[k]).epsilon(1e-8).margin(1e-8));
+        REQUIRE(back.i[k] == Approx(orbits.i[k]).epsilon(1e-8).margin(1e-8));
+    }
+}
@@ -104,4 +104,27 @@ TEST_CASE("point particle") {
       REQUIRE(new_ptc.vel(i).z == init_con[i].vel.z);
     }
   }
+
+  SECTION("Assign from container") {
+    std::vector<Particle> init_con;
+    for (size_t i = 0; i < RAND_TEST_NUM; ++i) {
+      init_con.emplace_back(
+          Particle(UTEST_RAND, UTEST_RAND, UTEST_RAND, UTEST_RAND, UTEST_RAND, UTEST_RAND, UTEST_RAND));
+    }
+    Particles new_ptc{0, init_con};
+    size_t capacity = new_ptc.capacity();
+
+    std::vector<Particle> small_con(init_con.begin(), init_con.begin() + RAND_TEST_NUM / 2);
+    double t0 = UTEST_RAND;
+    new_ptc.assign(t0, small_con);
+    REQUIRE(new_ptc.time() == t0);
+    REQUIRE(new_ptc.number() == small_con.size());
+    REQUIRE(new_ptc.capacity() == capacity);
+    for (size_t i = 0; i < small_con.size(); ++i) {
+      REQUIRE(new_ptc.idn(i) == i);
+      REQUIRE(new_ptc.mass(i) == small_con[i].mass);
+      REQUIRE(new_ptc.pos(i).x == small_con[i].pos.x);
+      REQUIRE(new_ptc.vel(i).z == small_con[i].vel.z);
+    }
+  }
 }
@@ -0,0 +1,171 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include <algorithm>
+#include <vector>
+
+#include "../../src/rand-generator.hpp"
+#include "../catch.hpp"
+#include "utest.hpp"
+
+using namespace hub;
+
+TEST_CASE("Philox") {
+    SECTION("known answer") {
+        using Block = random::Philox::Block;
+        REQUIRE(random::Philox::bijection({0, 0, 0, 0}, {0, 0}) ==
+                Block{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+        REQUIRE(random::Philox::bijection({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}) ==
+                Block{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd});
+    }
+
+    SECTION("reproducible streams") {
+        random::Philox a{42, 7};
+        random::Philox b{42, 7};
+        random::Philox c{42, 8};
+        size_t same = 0;
+        for (size_t i = 0; i < RAND_TEST_NUM; ++i) {
+            auto x = a();
+            REQUIRE(x == b());
+            REQUIRE(x == random::Philox::draw(42, 7, i));
+            same += (x == c());
+        }
+        REQUIRE(same == 0);
+
+        a.seek(1234);
+        REQUIRE(a() == random::Philox::draw(42, 7, 1234));
+    }
+
+    SECTION("batched fill") {
+        for (size_t n : {0, 1, 2, 3, 1000, 1001}) {
+            random::Philox gen{3, 1, 1};
+            random::Philox ref{3, 1, 1};
+            std::vector<double> v(n);
+            gen.fill_uniform(v, -2, 5);
+            for (size_t i = 0; i < n; ++i) {
+                REQUIRE(v[i] == -2 + 7 * ref.uniform());
+            }
+            REQUIRE(gen.draw_index() == ref.draw_index());
+        }
+    }
+
+    SECTION("moments") {
+        random::Philox gen{2021};
+        std::vector<double> u(100 * RAND_TEST_NUM), g(100 * RAND_TEST_NUM);
+        gen.fill_uniform(u);
+        gen.fill_normal(g, 1, 2);
+        double mu = 0, mg = 0, vg = 0;
+        for (size_t i = 0; i < u.size(); ++i) {
+            REQUIRE((0 <= u[i] && u[i] < 1));
+            mu += u[i];
+            mg += g[i];
+            vg += (g[i] - 1) * (g[i] - 1);
+        }
+        mu /= u.size(), mg /= g.size(), vg /= g.size();
+        REQUIRE(mu == Approx(0.5).margin(5e-3));
+        REQUIRE(mg == Approx(1).margin(2e-2));
+        REQUIRE(vg == Approx(4).margin(4e-2));
+    }
+
+    SECTION("thread generator") {
+        random::seed_thread_generator(99, 5);
+        double x = random::Uniform(0, 1);
+        random::seed_thread_generator(99, 5);
+        REQUIRE(random::Uniform(0, 1) == x);
+    }
+}
+
+template <typename Cdf>
+double ks_statistic(std::vector<double> sample, Cdf &&cdf) {
+    std::sort(sample.begin(), sample.end());
+    double n = static_cast<double>(sample.size());
+    double d = 0;
+    for (size_t i = 0; i < sample.size(); ++i) {
+        double F = cdf(sample[i]);
+        d = std::max({d, F - i / n, (i + 1) / n - F});
+    }
+    return d;
+}
+
+TEST_CASE("Truncated samplers") {
+    constexpr size_t n = 2 * RAND_TEST_NUM;
+    // Kolmogorov-Smirnov critical value at 0.1% significance.
+    const double d_crit = 1.95 / sqrt(n);
+    random::seed_thread_generator(123456789, 29);
+
+    auto Q = [](double x) { return 0.5 * std::erfc(x / sqrt(2.0)); };
+    auto S = [&](double x) { return 2 * Q(x) + sqrt(2 / consts::pi) * x * exp(-0.5 * x * x); };
+
+    SECTION("normal") {
+        struct Window {
+            double low, high;
+        };
+        // {7.9, 8.5} and {-8.5, -7.9} straddle the switch between the erfc and continued fraction Mills ratios.
+        for (auto [a, b] : {Window{-1, 2}, Window{-3, -2.9}, Window{2.5, 1e300}, Window{8, 8.5}, Window{-9, -8},
+                            Window{7.9, 8.5}, Window{-8.5, -7.9}}) {
+            std::vector<double> v(n);
+            random::fill_truncated_normal(v, 1 + 2 * a, 1 + 2 * b, 1, 2);
+            for (auto x : v) {
+                REQUIRE((1 + 2 * a <= x && x <= 1 + 2 * b));
+            }
+            auto cdf = [&](double x) {
+                double y = (x - 1) / 2;
+                return a >= 0 ? (Q(a) - Q(y)) / (Q(a) - Q(b)) : (Q(-y) - Q(-a)) / (Q(-b) - Q(-a));
+            };
+            CHECK(ks_statistic(v, cdf) < d_crit);
+
+            for (auto &x : v) x = random::TruncatedNormal(1 + 2 * a, 1 + 2 * b, 1, 2);
+            CHECK(ks_statistic(v, cdf) < d_crit);
+        }
+    }
+
+    SECTION("normal far tail") {
+        std::vector<double> v(n);
+        random::fill_truncated_normal(v, 50, 51);
+        auto cdf = [](double x) { return -std::expm1(-(x * x - 2500) / 2) / -std::expm1(-(51 * 51 - 2500) / 2.0); };
+        for (auto x : v) {
+            REQUIRE((50 <= x && x <= 51));
+        }
+        // Q(x)/Q(50) = exp(-(x^2-50^2)/2) * 50/x to first order, the 1/x factor changes the CDF by < 1%.
+        CHECK(ks_statistic(v, cdf) < 0.02);
+    }
+
+    SECTION("maxwellian") {
+        struct Window {
+            double low, high;
+        };
+        // {1.5, 3} is the first window sampled in tail mode with the erfc Mills ratio.
+        for (auto [a, b] : {Window{0, 1e300}, Window{0, 0.1}, Window{1, 3}, Window{1.5, 3}, Window{5, 6},
+                            Window{10, 1e300}}) {
+            std::vector<double> v(n);
+            random::fill_truncated_maxwellian(v, 3 * a, 3 * b, 3);
+            for (auto x : v) {
+                REQUIRE((3 * a <= x && x <= 3 * b));
+            }
+            auto cdf = [&](double x) {
+                double y = x / 3;
+                return b < 1e300 ? (S(a) - S(y)) / (S(a) - S(b)) : 1 - S(y) / S(a);
+            };
+            CHECK(ks_statistic(v, cdf) < d_crit);
+
+            for (auto &x : v) x = random::TruncatedMaxwellian(3 * a, 3 * b, 3);
+            CHECK(ks_statistic(v, cdf) < d_crit);
+        }
+    }
+}
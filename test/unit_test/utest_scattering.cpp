@@ -0,0 +1,480 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "../../src/spaceHub.hpp"
+#include "../catch.hpp"
+#include "utest.hpp"
+
+using namespace hub;
+
+namespace {
+    using Solver = methods::BS<>;
+
+    using Particle = Solver::Particle;
+
+    using Campaign = scattering::Campaign<Solver, int>;
+
+    /** @brief Equal mass binary with a = 1 hit by a third body with v_inf = 0.5 and b < 3.*/
+    Campaign::IC sample_single_binary(size_t) {
+        Particle p1{1}, p2{1}, p3{1};
+        auto binary = orbit::Elliptic(p1.mass, p2.mass, 1.0, 0.0, orbit::isotherm, orbit::isotherm,
+                                      orbit::isotherm, orbit::isotherm);
+        orbit::move_particles(binary, p2);
+        orbit::move_to_COM_frame(p1, p2);
+        auto incident = scattering::incident_orbit(p1.mass + p2.mass, p3.mass, 0.5, 3.0, 10.0);
+        orbit::move_particles(incident, p3);
+        orbit::move_to_COM_frame(p1, p2, p3);
+        return {{p1, p2, p3}, 2 * orbit::time_to_periapsis(orbit::group(p1, p2), p3)};
+    }
+
+    /** @brief 1 if the original binary survived, 0 otherwise.*/
+    int binary_survived(Campaign::System const &ptc, Campaign::IC const &) {
+        auto [a, e] = orbit::calc_a_e(ptc.mass()[0] + ptc.mass()[1], ptc.pos()[0] - ptc.pos()[1],
+                                      ptc.vel()[0] - ptc.vel()[1]);
+        return a > 0 ? 1 : 0;
+    }
+
+    double predict_cost(Campaign::IC const &ic) {
+        std::vector<Particle> binary{ic.particles[0], ic.particles[1]};
+        return scattering::encounter_cost(binary, ic.particles[2], ic.end_time);
+    }
+}  // namespace
+
+TEST_CASE("Scattering campaign") {
+    constexpr size_t run_num = 64;
+
+    SECTION("results do not depend on the schedule") {
+        Campaign campaign(sample_single_binary, binary_survived);
+        campaign.set_seed(2024);
+        campaign.set_rtol(1e-12);
+
+        campaign.set_thread_num(1);
+        auto serial = campaign.run(run_num);
+
+        size_t last_done = 0;
+        bool monotonic = true;
+        campaign.set_thread_num(4);
+        campaign.set_progress(
+            [&](size_t done, size_t total) {
+                monotonic = monotonic && done >= last_done && total == run_num;
+                last_done = done;
+            },
+            0.001);
+        auto parallel = campaign.run(run_num);
+
+        REQUIRE(serial.runs == run_num);
+        REQUIRE(parallel.runs == run_num);
+        REQUIRE(serial.counts == parallel.counts);
+        REQUIRE(serial.count(0) + serial.count(1) == run_num);
+        REQUIRE(monotonic);
+        REQUIRE(last_done == run_num);
+    }
+
+    SECTION("extra stop condition") {
+        Campaign campaign(sample_single_binary, [](Campaign::System const &ptc, Campaign::IC const &ic) {
+            return ptc.time() < ic.end_time ? 1 : 0;
+        });
+        campaign.set_thread_num(2);
+        campaign.set_stop_condition([](Campaign::System &ptc, double) { return ptc.time() > 1.0; });
+        auto result = campaign.run(8);
+        REQUIRE(result.fraction(1) == 1.0);
+        REQUIRE(result.fraction_error(1) == 0.0);
+    }
+
+    SECTION("cost ordering and split out runs") {
+        Campaign campaign(sample_single_binary, binary_survived);
+        campaign.set_seed(7);
+        campaign.set_thread_num(2);
+        auto reference = campaign.run(run_num);
+        REQUIRE(campaign.overruns().empty());
+
+        campaign.set_cost_predictor(predict_cost);
+        auto ordered = campaign.run(run_num);
+        REQUIRE(ordered.counts == reference.counts);
+
+        campaign.set_thread_num(1);
+        campaign.set_budget(1.0);
+        auto budgeted = campaign.run(run_num);
+        auto split = campaign.overruns();
+        REQUIRE(!split.empty());
+        REQUIRE(budgeted.runs + split.size() == run_num);
+
+        // with one thread the second call replays the first one up to its first overrun, which is exempt this time
+        auto again = campaign.run(run_num);
+        auto rest = campaign.overruns();
+        for (auto id : split) {
+            REQUIRE(!std::binary_search(rest.begin(), rest.end(), id));
+        }
+        again.merge(campaign.run(rest));
+        REQUIRE(campaign.overruns().empty());
+        REQUIRE(again.counts == reference.counts);
+    }
+}
+
+TEST_CASE("Settled outcome") {
+    SECTION("receding single") {
+        auto system = [](double r, double v) {
+            Particle p1{1}, p2{1}, p3{1};
+            auto binary = orbit::Elliptic(p1.mass, p2.mass, 1.0, 0.5, 0.0, 0.0, 0.0, 0.0);
+            orbit::move_particles(binary, p2);
+            p3.pos = Particle::Vector{r, 0, 0};
+            p3.vel = Particle::Vector{v, 0, 0};
+            orbit::move_to_COM_frame(p1, p2, p3);
+            return Solver{0, p1, p2, p3};
+        };
+
+        scattering::SettleCheck check;
+        REQUIRE(check(system(100, 1).particles()));
+        REQUIRE(check.structure() == "(0,1)2");
+
+        REQUIRE_FALSE(check(system(100, -1).particles()));
+        REQUIRE(check.structure() == "(0,1)2");
+
+        REQUIRE_FALSE(check(system(8, 1).particles()));
+    }
+
+    SECTION("early termination keeps the outcome") {
+        size_t early_steps = 0;
+        size_t full_steps = 0;
+        size_t settled_num = 0;
+        for (size_t i = 0; i < 32; ++i) {
+            random::seed_thread_generator(11, i);
+            auto ic = sample_single_binary(i);
+
+            Solver full{0, ic.particles};
+            Solver::RunArgs full_args;
+            full_args.add_stop_condition(2 * ic.end_time);
+            full_args.add_stop_condition([&](auto &, auto) { return ++full_steps, false; });
+            full.run(full_args);
+            scattering::SettleCheck check;
+            check(full.particles());
+
+            Solver early{0, ic.particles};
+            Solver::RunArgs early_args;
+            scattering::OutcomeSettled settled;
+            early_args.add_stop_condition(2 * ic.end_time);
+            early_args.add_stop_condition([&](auto &ptc, auto h) { return ++early_steps, settled(ptc, h); });
+            early.run(early_args);
+
+            if (settled.is_settled()) {
+                settled_num++;
+                REQUIRE(settled.outcome() == check.structure());
+            }
+        }
+        REQUIRE(settled_num > 16);
+        REQUIRE(2 * early_steps < full_steps);
+    }
+}
+
+TEST_CASE("Hierarchical structure") {
+    auto binary = [](Particle &p1, Particle &p2, double a) {
+        auto orb = orbit::Elliptic(p1.mass, p2.mass, a, 0.3, 0.0, 0.0, 0.0, 1.0);
+        orbit::move_particles(orb, p2);
+        orbit::move_to_COM_frame(p1, p2);
+    };
+
+    scattering::Hierarchy<4> hierarchy;
+    constexpr auto pair = scattering::Hierarchy<4>::pair_token;
+    constexpr auto end = scattering::Hierarchy<4>::end_token;
+
+    SECTION("binary and single") {
+        Particle p1{1}, p2{1}, p3{1};
+        binary(p1, p2, 1);
+        p3.pos = Particle::Vector{100, 0, 0};
+        p3.vel = Particle::Vector{1, 0, 0};
+        std::vector<Particle> ptc{p1, p2, p3};
+
+        REQUIRE(hierarchy.classify(ptc) == 2);
+        REQUIRE(hierarchy.to_string() == "(0,1)2");
+        REQUIRE(hierarchy.code() == scattering::Hierarchy<4>::Code{pair, 0, 1, 2, end, end, end});
+        REQUIRE(scattering::get_hierarchical_struct(ptc) == "(0,1)2");
+
+        scattering::Hierarchy<4> from_system;
+        from_system.classify(Solver{0, ptc}.particles());
+        REQUIRE(from_system.same_structure(hierarchy));
+
+        std::swap(ptc[0], ptc[2]);
+        hierarchy.classify(ptc);
+        REQUIRE(hierarchy.to_string() == "0(1,2)");
+    }
+
+    SECTION("hierarchical triple") {
+        Particle p1{1}, p2{1}, p3{1};
+        binary(p2, p3, 1);
+        auto outer = orbit::Elliptic(p1.mass, p2.mass + p3.mass, 20.0, 0.1, 0.0, 0.0, 0.0, 2.0);
+        orbit::move_particles(outer, p2, p3);
+        std::vector<Particle> ptc{p1, p2, p3};
+
+        REQUIRE(hierarchy.classify(ptc) == 1);
+        REQUIRE(hierarchy.to_string() == "(0,(1,2))");
+        REQUIRE(hierarchy.node(hierarchy.top(0)).a == Approx(20.0));
+    }
+
+    SECTION("two binaries and unbound singles") {
+        Particle p1{1}, p2{1}, p3{1}, p4{1};
+        binary(p1, p3, 1);
+        binary(p2, p4, 2);
+        p2.pos += Particle::Vector{0, 100, 0};
+        p4.pos += Particle::Vector{0, 100, 0};
+        p2.vel += Particle::Vector{0, 1, 0};
+        p4.vel += Particle::Vector{0, 1, 0};
+        REQUIRE(hierarchy.classify(std::vector<Particle>{p1, p2, p3, p4}) == 2);
+        REQUIRE(hierarchy.to_string() == "(0,2)(1,3)");
+
+        for (auto *p : {&p1, &p2, &p3, &p4}) {
+            p->vel *= 10;
+        }
+        REQUIRE(hierarchy.classify(std::vector<Particle>{p1, p2, p3, p4}) == 4);
+        REQUIRE(hierarchy.to_string() == "0123");
+    }
+
+    SECTION("more particles than the capacity") {
+        // 100 receding binaries, the pair nodes go up to index 299
+        std::vector<Particle> ptc;
+        std::string expected;
+        for (size_t k = 0; k < 100; ++k) {
+            Particle p1{1}, p2{1};
+            binary(p1, p2, 1);
+            for (auto *p : {&p1, &p2}) {
+                p->pos += Particle::Vector{100.0 * k, 0, 0};
+                p->vel += Particle::Vector{1.0 * k, 0, 0};
+            }
+            ptc.insert(ptc.end(), {p1, p2});
+            expected += "(" + std::to_string(2 * k) + "," + std::to_string(2 * k + 1) + ")";
+        }
+        REQUIRE(hierarchy.classify(ptc) == 0);
+        REQUIRE(hierarchy.to_string().empty());
+        REQUIRE(hierarchy.code()[0] == end);
+        REQUIRE(scattering::get_hierarchical_struct(ptc) == expected);
+
+        ptc.resize(300);
+        REQUIRE(scattering::get_hierarchical_struct(ptc).empty());
+    }
+}
+
+TEST_CASE("Far field propagation") {
+    SECTION("two-body orbits") {
+        for (double e : {0.0, 0.5, 0.99, 1.5, 5.0}) {
+            Particle p1{1}, p2{0.5};
+            auto orb = orbit::KeplerOrbit<double>(p1.mass, p2.mass, 1.0, e, 0.3, 0.2, 0.1, -1.0);
+            orbit::move_particles(orb, p2);
+            orbit::move_to_COM_frame(p1, p2);
+
+            Solver solver{0, p1, p2};
+            Solver::RunArgs args;
+            args.add_stop_condition(7.3);
+            solver.run(args);
+
+            scattering::kepler_propagate(p1, p2, 7.3);
+            REQUIRE(norm(solver.particles().pos()[1] - p2.pos) < 1e-12 * norm(p2.pos));
+            REQUIRE(norm(solver.particles().vel()[1] - p2.vel) < 1e-12 * norm(p2.vel));
+        }
+    }
+
+    SECTION("approach of a binary") {
+        random::seed_thread_generator(5, 0);
+        Particle p1{1}, p2{1}, p3{1};
+        auto orb = orbit::Elliptic(p1.mass, p2.mass, 1.0, 0.3, orbit::isotherm, orbit::isotherm, orbit::isotherm,
+                                   orbit::isotherm);
+        orbit::move_particles(orb, p2);
+        orbit::move_to_COM_frame(p1, p2);
+        auto incident = scattering::incident_orbit(p1.mass + p2.mass, p3.mass, 0.5, 3.0, 100.0);
+        orbit::move_particles(incident, p3);
+        orbit::move_to_COM_frame(p1, p2, p3);
+
+        Solver solver{0, p1, p2, p3};
+        auto binary = orbit::group(p1, p2);
+        double r = scattering::interaction_radius(binary, p3, 1e-3);
+        double dt = scattering::approach(binary, p3, r);
+        REQUIRE(norm(orbit::COM_p(binary) - p3.pos) == Approx(r));
+        REQUIRE(scattering::time_to_radius(binary, p3, 2 * r) == 0);
+
+        Solver::RunArgs args;
+        args.add_stop_condition(dt);
+        solver.run(args);
+        auto const &ptc = solver.particles();
+        REQUIRE(norm(ptc.pos()[0] - binary[0].pos) < 1e-2);
+        REQUIRE(norm(ptc.pos()[1] - binary[1].pos) < 1e-2);
+        REQUIRE(norm(ptc.pos()[2] - p3.pos) < 1e-2);
+    }
+}
+
+TEST_CASE("Cross section estimator") {
+    using Estimator = scattering::CrossSectionEstimator<Solver, int>;
+    // Point masses that collide if the periapsis is below R, sigma = pi R^2 (1 + 2 G M / (R v^2)).
+    constexpr double R = 0.4;
+    constexpr double v_inf = 1.0;
+    double const sigma = consts::pi * R * R * (1 + 2 * consts::G * 2 / (R * v_inf * v_inf));
+
+    auto sampler = [](double b, size_t) {
+        Particle p1{1}, p2{1};
+        auto incident = scattering::incident_orbit_at(p1.mass, p2.mass, v_inf, b, 100.0);
+        orbit::move_particles(incident, p2);
+        orbit::move_to_COM_frame(p1, p2);
+        return Estimator::IC{{p1, p2}, 1e-6};
+    };
+    auto collided = [](Estimator::System const &, Estimator::IC const &ic) {
+        auto const &p = ic.particles;
+        auto [a, e] = orbit::calc_a_e(p[0].mass + p[1].mass, p[0].pos - p[1].pos, p[0].vel - p[1].vel);
+        return a * (1 - e) < R ? 1 : 0;
+    };
+
+    SECTION("stratified estimate") {
+        Estimator estimator(sampler, collided, 3.0);
+        estimator.add_target(1, 1e-3);
+        estimator.campaign().set_seed(11);
+        estimator.set_batch_runs(256);
+        auto result = estimator.run();
+
+        REQUIRE(result.error(1) <= 1e-3 * result.cross_section(1));
+        REQUIRE(std::abs(result.cross_section(1) - sigma) < 3 * result.error(1) + 1e-12);
+        REQUIRE(result.cross_section(0) + result.cross_section(1) == Approx(consts::pi * 9.0));
+        // uniform sampling over b < 3 needs (1 - p) / (p eps^2) = 4e6 runs for the same error
+        REQUIRE(result.runs < 50000);
+    }
+
+    SECTION("unseen target") {
+        Estimator estimator(sampler, collided, 3.0);
+        estimator.add_target(1, 1e-2);
+        estimator.add_target(2, 1e-2);
+        estimator.campaign().set_seed(11);
+        estimator.set_pilot_runs(4);
+        estimator.set_batch_runs(64);
+        estimator.set_max_runs(640);
+        auto result = estimator.run();
+
+        REQUIRE(result.runs == 640);
+        REQUIRE(result.cross_section(2) == 0);
+        REQUIRE(std::isfinite(result.error(2)));
+        REQUIRE(result.error(2) > 0);
+        // the annuli beyond the collision radius never see outcome 1 but still bound its error
+        REQUIRE(result.error(1) > 0);
+        size_t runs = 0;
+        for (auto n : estimator.strata_runs()) {
+            REQUIRE(n >= 4);
+            runs += n;
+        }
+        REQUIRE(runs == 640);
+    }
+}
+
+TEST_CASE("Result cache") {
+    static_assert(force::Interactions<force::NewtonianGrav>::scale_free);
+    static_assert(!force::Interactions<force::NewtonianGrav, force::PN1>::scale_free);
+
+    constexpr size_t run_num = 32;
+    std::string const path = "utest_result_cache.txt";
+    std::remove(path.c_str());
+
+    auto scaled = [](double M, double L) {
+        double T = std::sqrt(L * L * L / M);
+        return [=](size_t run) {
+            auto ic = sample_single_binary(run);
+            for (auto &p : ic.particles) {
+                p.mass *= M;
+                p.pos *= L;
+                p.vel *= L / T;
+            }
+            ic.end_time *= T;
+            return ic;
+        };
+    };
+
+    auto cache = std::make_shared<Campaign::Cache>(path);
+    Campaign reference(scaled(1, 1), binary_survived);
+    reference.set_seed(5);
+    reference.set_cache(cache);
+    auto first = reference.run(run_num);
+    REQUIRE(cache->misses() == run_num);
+    REQUIRE(cache->size() == run_num);
+
+    Campaign rescaled(scaled(20 * unit::Me, 30 * unit::AU), binary_survived);
+    rescaled.set_seed(5);
+    rescaled.set_cache(cache);
+    auto second = rescaled.run(run_num);
+    REQUIRE(cache->hits() == run_num);
+    REQUIRE(second.counts == first.counts);
+
+    Campaign::Cache reloaded(path);
+    REQUIRE(reloaded.size() == run_num);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Campaign journal") {
+    constexpr size_t run_num = 32;
+    std::string const path = "utest_journal.bin";
+    std::remove(path.c_str());
+
+    std::atomic<size_t> sampled{0};
+    auto counting_sampler = [&](size_t run) {
+        sampled++;
+        return sample_single_binary(run);
+    };
+
+    Campaign reference(sample_single_binary, binary_survived);
+    reference.set_seed(3);
+    auto expected = reference.run(run_num);
+
+    {
+        // a campaign killed after the first half of the runs
+        auto journal = std::make_shared<Campaign::RunJournal>(path, 4);
+        Campaign campaign(counting_sampler, binary_survived);
+        campaign.set_seed(3);
+        campaign.set_journal(journal);
+        std::vector<size_t> first_half(run_num / 2);
+        std::iota(first_half.begin(), first_half.end(), 0);
+        campaign.run(first_half);
+        REQUIRE(journal->size() == run_num / 2);
+    }
+    if (std::FILE *f = std::fopen(path.c_str(), "ab")) {
+        std::fputs("torn", f);
+        std::fclose(f);
+    }
+
+    auto journal = std::make_shared<Campaign::RunJournal>(path);
+    REQUIRE(journal->size() == run_num / 2);
+
+    Campaign resumed(counting_sampler, binary_survived);
+    resumed.set_seed(3);
+    resumed.set_journal(journal);
+    sampled = 0;
+    auto result = resumed.run(run_num);
+    REQUIRE(sampled == run_num / 2);
+    REQUIRE(result.runs == run_num);
+    REQUIRE(result.counts == expected.counts);
+    REQUIRE(journal->size() == run_num);
+
+    sampled = 0;
+    REQUIRE(resumed.run(run_num).counts == expected.counts);
+    REQUIRE(sampled == 0);
+
+    resumed.set_seed(4);
+    resumed.run(4);
+    REQUIRE(sampled == 4);
+    std::remove(path.c_str());
+}
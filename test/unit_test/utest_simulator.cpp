@@ -0,0 +1,85 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include <vector>
+
+#include "../../src/spaceHub.hpp"
+#include "../catch.hpp"
+#include "utest.hpp"
+
+using namespace hub;
+
+namespace {
+    template <typename Sim>
+    std::vector<typename Sim::Particle> hierarchical_triple(double e) {
+        typename Sim::Particle p1{1}, p2{0.5}, p3{0.3};
+        auto binary = orbit::Elliptic(p1.mass, p2.mass, 1.0, e, 0.3, 0.2, 0.1, 0.5);
+        orbit::move_particles(binary, p2);
+        orbit::move_to_COM_frame(p1, p2);
+        auto outer = orbit::Elliptic(p1.mass + p2.mass, p3.mass, 6.0, 0.2, 0.5, 0.1, 0.2, 1.0);
+        orbit::move_particles(outer, p3);
+        orbit::move_to_COM_frame(p1, p2, p3);
+        return {p1, p2, p3};
+    }
+
+    template <typename Sim>
+    void run_to(Sim &sim, double end) {
+        typename Sim::RunArgs args;
+        args.rtol = 1e-12;
+        args.add_stop_condition(end);
+        sim.run(args);
+    }
+
+    /** @brief A cold reset after another run has to give exactly the result of a new simulator.*/
+    template <typename Sim>
+    void check_reset() {
+        Sim fresh{0, hierarchical_triple<Sim>(0.3)};
+        run_to(fresh, 20.0);
+
+        Sim reused{0, hierarchical_triple<Sim>(0.9)};
+        run_to(reused, 30.0);
+        reused.reset(0, hierarchical_triple<Sim>(0.3));
+        run_to(reused, 20.0);
+
+        REQUIRE(reused.particles().time() == fresh.particles().time());
+        for (size_t i = 0; i < 3; ++i) {
+            REQUIRE(norm(reused.particles().pos()[i] - fresh.particles().pos()[i]) == 0);
+            REQUIRE(norm(reused.particles().vel()[i] - fresh.particles().vel()[i]) == 0);
+        }
+
+        // a warm start takes other steps, so it only has to get there
+        reused.reset(0, hierarchical_triple<Sim>(0.3), true);
+        run_to(reused, 20.0);
+        REQUIRE(reused.particles().time() == Approx(fresh.particles().time()).margin(0.1));
+    }
+}  // namespace
+
+TEST_CASE("Simulator reset") {
+    SECTION("in place") {
+        check_reset<methods::BS<>>();
+        check_reset<methods::AR_BS<>>();
+        check_reset<methods::AR_Chain<>>();
+        check_reset<methods::Radau<>>();
+    }
+
+    SECTION("rebuilt") {
+        check_reset<methods::Chain_BS<>>();
+        check_reset<methods::Sym6<>>();
+    }
+}
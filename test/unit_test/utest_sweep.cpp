@@ -0,0 +1,102 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <string>
+
+#include "../../src/tools/sweep.hpp"
+#include "../catch.hpp"
+#include "utest.hpp"
+
+using namespace hub;
+
+namespace {
+    struct TestSolver {};
+
+    void write_config(std::string const &path, std::string const &v_inf_axis) {
+        std::ofstream file(path);
+        file << "# a sweep over the velocity, the mass ratio and the eccentricity\n"
+             << "v_inf = " << v_inf_axis << '\n'
+             << "q = linspace(0.1, 1, 3)\n"
+             << "e = lhs(0, 1)\n"
+             << "a = 1\n"
+             << "sweep.samples = 4\n"
+             << "sweep.seed = 42\n";
+    }
+}  // namespace
+
+TEST_CASE("Parameter sweep") {
+    std::string const config = "utest_sweep.cfg";
+    std::string const store = "utest_sweep.store";
+    std::remove(store.c_str());
+
+    write_config(config, "[0.1, 0.3]");
+    auto points = tools::Sweep(config).points();
+    REQUIRE(points.size() == 2 * 3 * 4);
+
+    SECTION("expansion") {
+        std::set<std::string> unique;
+        std::set<int> strata;
+        for (auto const &p : points) {
+            unique.insert(p.str());
+            REQUIRE(p.get<double>("a") == 1.0);
+            if (p.get<double>("v_inf") == 0.1 && p.get<double>("q") == 0.1) {
+                strata.insert(static_cast<int>(p.get<double>("e") * 4));
+            }
+        }
+        REQUIRE(unique.size() == points.size());
+        REQUIRE(strata == std::set<int>{0, 1, 2, 3});
+        REQUIRE(tools::Sweep(config).points()[5].str() == points[5].str());
+    }
+
+    SECTION("memoized runs") {
+        using Runner = tools::SweepRunner<TestSolver, double>;
+        std::atomic<size_t> calls{0};
+        auto task = [&](tools::Parameters const &p) {
+            calls++;
+            return p.get<double>("v_inf") * p.get<double>("q") + p.get<double>("e");
+        };
+
+        Runner runner(store, "v1");
+        runner.set_thread_num(2);
+        auto first = runner.run(points, task);
+        REQUIRE(runner.computed() == points.size());
+        REQUIRE(runner.run(points, task) == first);
+        REQUIRE(runner.computed() == 0);
+
+        write_config(config, "[0.1, 0.3, 1.0]");
+        auto extended = tools::Sweep(config).points();
+        Runner reloaded(store, "v1");
+        auto second = reloaded.run(extended, task);
+        REQUIRE(reloaded.computed() == 3 * 4);
+        REQUIRE(calls == points.size() + 3 * 4);
+        for (size_t i = 0; i < second.size(); ++i) {
+            REQUIRE(second[i] == task(extended[i]));
+        }
+
+        Runner other_version(store, "v2");
+        other_version.run(points, task);
+        REQUIRE(other_version.computed() == points.size());
+    }
+    std::remove(store.c_str());
+    std::remove(config.c_str());
+}
@@ -0,0 +1,81 @@
+#include "../src/spaceHub.hpp"
+using namespace hub;
+using namespace unit;
+using namespace orbit;
+using Solver = methods::DefaultMethod<>;
+using Particle = Solver::Particle;
+using Scalar = Solver::Scalar;
+
+enum class Outcome { flyby, exchange, ionization };
+
+int main(int argc, char** argv) {
+    size_t n = 10000;
+    Scalar v_inf = 10_kms;
+    Scalar b_max = 10_AU;
+    Scalar r_start = 100_AU;
+
+    /*--------------------------------------------------New-----------------------------------------------------------*/
+    using Campaign = scattering::Campaign<Solver, Outcome>;
+
+    // the sampler creates the initial condition of one run. The thread random generator is seeded with (seed, run)
+    // before each call, so every run sees the same random numbers however the runs are scheduled.
+    auto sampler = [&](size_t run) -> Campaign::IC {
+        Particle p1{1_Ms}, p2{1_Ms}, p3{1_Ms};
+
+        auto binary_orb = Elliptic(p1.mass, p2.mass, 5_AU, 0.0, isotherm, isotherm, isotherm, isotherm);
+        move_particles(binary_orb, p2);
+        move_to_COM_frame(p1, p2);
+
+        auto orb = scattering::incident_orbit(M_tot(p1, p2), p3.mass, v_inf, b_max, r_start);
+        move_particles(orb, p3);
+        move_to_COM_frame(p1, p2, p3);
+
+        // long enough to resolve most resonances, the runs usually stop much earlier when their outcome is settled
+        Scalar t_end = 10 * time_to_periapsis(group(p1, p2), p3);
+
+        // skip the integration of the approach: move the clusters on Kepler orbits until their tidal factor is 1e-3
+        auto binary = group(p1, p2);
+        Scalar t_approach = scattering::approach(binary, p3, scattering::interaction_radius(binary, p3, 1e-3));
+
+        return {{binary[0], binary[1], p3}, t_end - t_approach};
+    };
+
+    // the classifier maps the final state of a run to its outcome
+    auto classifier = [](Campaign::System const& ptc, Campaign::IC const& ic) {
+        auto bound = [&](size_t i, size_t j) {
+            auto [a, e] = calc_a_e(ptc.mass()[i] + ptc.mass()[j], ptc.pos()[i] - ptc.pos()[j],
+                                   ptc.vel()[i] - ptc.vel()[j]);
+            return a > 0;
+        };
+        if (bound(0, 1)) return Outcome::flyby;
+        if (bound(0, 2) || bound(1, 2)) return Outcome::exchange;
+        return Outcome::ionization;
+    };
+
+    Campaign campaign(sampler, classifier);
+
+    campaign.set_seed(42);
+
+    // start the expensive runs first, so they do not become stragglers at the end of the campaign
+    campaign.set_cost_predictor([](Campaign::IC const& ic) {
+        std::vector<Particle> binary{ic.particles[0], ic.particles[1]};
+        return scattering::encounter_cost(binary, ic.particles[2], ic.end_time);
+    });
+
+    // stop a run as soon as its outcome can no longer change, instead of integrating to the end time
+    campaign.set_stop_condition(scattering::OutcomeSettled{});
+
+    // runs are scheduled one by one on all cores, and the progress is reported every second while they execute
+    campaign.set_progress([](size_t done, size_t total) { print(std::cout, done, '/', total, '\n'); });
+
+    auto result = campaign.run(n);
+    /*----------------------------------------------------------------------------------------------------------------*/
+
+    print(std::cout, "flyby      : ", result.fraction(Outcome::flyby), " +- ", result.fraction_error(Outcome::flyby), '\n');
+    print(std::cout, "exchange   : ", result.fraction(Outcome::exchange), " +- ",
+          result.fraction_error(Outcome::exchange), '\n');
+    print(std::cout, "ionization : ", result.fraction(Outcome::ionization), " +- ",
+          result.fraction_error(Outcome::ionization), '\n');
+
+    return 0;
+}